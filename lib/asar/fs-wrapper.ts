@@ -101,6 +101,16 @@ const enum AsarError {
   INVALID_ARCHIVE = 'INVALID_ARCHIVE'
 }
 
+// Results of asar.probeModulePath(), kept in sync with
+// shell/common/api/electron_api_asar.cc.
+const enum ModulePathResult {
+  FILE = 0,
+  DIRECTORY = 1,
+  NOT_FOUND = -34,
+  NOT_ASAR = -1,
+  INVALID_ARCHIVE = -2
+}
+
 type AsarErrorObject = Error & { code?: string, errno?: number };
 
 const createError = (errorType: AsarError, { asarPath, filePath }: { asarPath?: string, filePath?: string } = {}) => {
@@ -711,8 +721,59 @@ export const wrapFsWithAsar = (fs: Record<string, any>) => {
     return files;
   };
 
+  // require() probes a path, then the path with every registered extension,
+  // then the package.json of a directory. All of that is resolved natively in
+  // one call. The results are only kept until the require() calls of the
+  // current tick are done, so that they do not pile up.
+  const moduleStatCache = new Map<string, number>();
+  const prefetchedPackageJSON = new Map<string, string>();
+  let probeResults = new Int32Array(4);
+  let moduleCachesClearScheduled = false;
+
+  const scheduleModuleCachesClear = () => {
+    if (moduleCachesClearScheduled) return;
+    moduleCachesClearScheduled = true;
+    process.nextTick(() => {
+      moduleCachesClearScheduled = false;
+      moduleStatCache.clear();
+      prefetchedPackageJSON.clear();
+    });
+  };
+
+  const probeModulePath = (pathArgument: string) => {
+    const extensions = Object.keys(Module._extensions);
+    if (probeResults.length < extensions.length + 1) {
+      probeResults = new Int32Array(extensions.length + 1);
+    }
+
+    // Reads have to go through the JS path for them to be logged.
+    const readPackageJSON = !process.env.ELECTRON_LOG_ASAR_READS;
+    const packageJSON = asar.probeModulePath(path.normalize(pathArgument), extensions, probeResults, readPackageJSON);
+    const result = probeResults[0];
+    if (result === ModulePathResult.NOT_ASAR || result === ModulePathResult.INVALID_ARCHIVE) return result;
+
+    scheduleModuleCachesClear();
+    moduleStatCache.set(pathArgument, result);
+    for (let i = 0; i < extensions.length; i++) {
+      const extensionResult = probeResults[i + 1];
+      if (extensionResult !== ModulePathResult.NOT_ASAR && extensionResult !== ModulePathResult.INVALID_ARCHIVE) {
+        moduleStatCache.set(pathArgument + extensions[i], extensionResult);
+      }
+    }
+    if (packageJSON !== undefined) {
+      prefetchedPackageJSON.set(pathArgument + path.sep + 'package.json', packageJSON);
+    }
+    return result;
+  };
+
   const { internalModuleReadJSON } = internalBinding('fs');
   internalBinding('fs').internalModuleReadJSON = (pathArgument: string) => {
+    const prefetched = isAsarDisabled() ? undefined : prefetchedPackageJSON.get(pathArgument);
+    if (prefetched !== undefined) {
+      prefetchedPackageJSON.delete(pathArgument);
+      return [prefetched, prefetched.length > 0];
+    }
+
     const pathInfo = splitPath(pathArgument);
     if (!pathInfo.isAsar) return internalModuleReadJSON(pathArgument);
     const { asarPath, filePath } = pathInfo;
@@ -742,19 +803,17 @@ export const wrapFsWithAsar = (fs: Record<string, any>) => {
 
   const { internalModuleStat } = internalBinding('fs');
   internalBinding('fs').internalModuleStat = (pathArgument: string) => {
-    const pathInfo = splitPath(pathArgument);
-    if (!pathInfo.isAsar) return internalModuleStat(pathArgument);
-    const { asarPath, filePath } = pathInfo;
-
-    // -ENOENT
-    const archive = getOrCreateArchive(asarPath);
-    if (!archive) return -34;
+    if (isAsarDisabled() || typeof pathArgument !== 'string' || !asarRe.test(pathArgument)) {
+      return internalModuleStat(pathArgument);
+    }
 
-    // -ENOENT
-    const stats = archive.stat(filePath);
-    if (!stats) return -34;
+    const cached = moduleStatCache.get(pathArgument);
+    if (cached !== undefined) return cached;
 
-    return (stats.isDirectory) ? 1 : 0;
+    const result = probeModulePath(pathArgument);
+    if (result === ModulePathResult.NOT_ASAR) return internalModuleStat(pathArgument);
+    if (result === ModulePathResult.INVALID_ARCHIVE) return ModulePathResult.NOT_FOUND;
+    return result;
   };
 
   // Calling mkdir for directory inside asar archive should throw ENOTDIR
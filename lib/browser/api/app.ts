@@ -1,9 +1,11 @@
 import * as fs from 'fs';
+import * as vm from 'vm';
 
 import { Menu } from 'electron/main';
 
 const bindings = process._linkedBinding('electron_browser_app');
 const commandLine = process._linkedBinding('electron_common_command_line');
+const moduleCodeCache = process._linkedBinding('electron_browser_module_code_cache');
 const { app } = bindings;
 
 // Only one app object permitted.
@@ -104,6 +106,26 @@ if (process.platform === 'linux') {
   };
 }
 
+app.warmModuleCodeCache = async (paths: string[]) => {
+  if (!moduleCodeCache.isEnabled()) return;
+  const Module = require('module');
+  for (const modulePath of paths) {
+    // Compile the module like the CommonJS loader would, without running it.
+    const filename = Module._resolveFilename(modulePath, null, false);
+    let content = fs.readFileSync(filename, 'utf8');
+    if (content.charCodeAt(0) === 0xFEFF) content = content.slice(1);
+    if (moduleCodeCache.get(filename, content)) continue;
+    const fn = vm.compileFunction(content, ['exports', 'require', 'module', '__filename', '__dirname'], { filename });
+    moduleCodeCache.compiled(filename, content, fn);
+  }
+  await moduleCodeCache.flush();
+};
+
+app.pruneModuleCodeCache = async () => {
+  if (!moduleCodeCache.isEnabled()) return;
+  await moduleCodeCache.prune();
+};
+
 // Routes the events to webContents.
 const events = ['certificate-error', 'select-client-certificate'];
 for (const name of events) {
@@ -1,6 +1,22 @@
 import { IpcMainImpl } from '@electron/internal/browser/ipc-main-impl';
 
-const ipcMain = new IpcMainImpl();
+const { _setIPCChannelMode } = process._linkedBinding('electron_browser_web_contents');
+
+const channelModes = new Set(['default', 'batch', 'latest']);
+
+class IpcMain extends IpcMainImpl {
+  setChannelMode: Electron.IpcMain['setChannelMode'] = (channel, mode) => {
+    if (typeof channel !== 'string') {
+      throw new Error('Missing required channel argument');
+    }
+    if (!channelModes.has(mode)) {
+      throw new Error(`Invalid channel mode '${mode}'`);
+    }
+    _setIPCChannelMode(channel, mode);
+  }
+}
+
+const ipcMain = new IpcMain();
 
 // Do not throw exception when channel name is "error".
 ipcMain.on('error', () => {});
@@ -582,6 +582,13 @@ WebContents.prototype._init = function () {
     }
   });
 
+  this.on('-ipc-message-batch' as any, function (this: Electron.WebContents, event: Electron.IpcMainEvent, channel: string, batch: any[][]) {
+    addSenderFrameToEvent(event);
+    addReplyToEvent(event);
+    this.emit('ipc-message', event, channel, batch);
+    ipcMain.emit(channel, event, batch);
+  });
+
   this.on('-ipc-invoke' as any, function (event: Electron.IpcMainInvokeEvent, internal: boolean, channel: string, args: any[]) {
     addSenderFrameToEvent(event);
     event._reply = (result: any) => event.sendReply({ result });
@@ -1,6 +1,7 @@
 import { MessagePortMain } from '@electron/internal/browser/message-port-main';
+import { webContents } from 'electron/main';
 
-const { WebFrameMain, fromId } = process._linkedBinding('electron_browser_web_frame_main');
+const { WebFrameMain, fromId, connect, _broadcast } = process._linkedBinding('electron_browser_web_frame_main');
 
 WebFrameMain.prototype.send = function (channel, ...args) {
   if (typeof channel !== 'string') {
@@ -33,6 +34,21 @@ WebFrameMain.prototype.postMessage = function (...args) {
   this._postMessage(...args);
 };
 
+const broadcast = (targets: Electron.WebFrameMain[] | Electron.Session, channel: string, ...args: any[]) => {
+  if (typeof channel !== 'string') {
+    throw new Error('Missing required channel argument');
+  }
+
+  const frames = Array.isArray(targets)
+    ? targets
+    : webContents.getAllWebContents()
+      .filter(contents => !contents.isDestroyed() && contents.session === targets)
+      .map(contents => contents.mainFrame);
+  _broadcast(frames, false /* internal */, channel, args);
+};
+
 export default {
-  fromId
+  fromId,
+  broadcast,
+  connect
 };
@@ -73,6 +73,26 @@ if (process.platform === 'win32') {
 // Map process.exit to app.exit, which quits gracefully.
 process.exit = app.exit as () => never;
 
+// `electron --build-snapshot <entry>` writes the startup snapshot of the app
+// instead of running it.
+if (app.commandLine.hasSwitch('build-snapshot')) {
+  const startupSnapshot = process._linkedBinding('electron_browser_startup_snapshot');
+  const entry = app.commandLine.getSwitchValue('build-snapshot') || process.argv.slice(1).find(arg => !arg.startsWith('-'));
+  if (!entry) {
+    console.error('Usage: electron --build-snapshot <entry.js> [--snapshot-blob=<path>]');
+    process.exit(1);
+  }
+  try {
+    const filename = path.resolve(entry);
+    const snapshotPath = startupSnapshot.build(fs.readFileSync(filename, 'utf8'), filename);
+    console.log(`Wrote the startup snapshot to ${snapshotPath}`);
+    process.exit(0);
+  } catch (error) {
+    console.error(`Failed to build the startup snapshot: ${(error as Error).message}`);
+    process.exit(1);
+  }
+}
+
 // Load the RPC server.
 require('@electron/internal/browser/rpc-server');
 
@@ -183,6 +203,12 @@ const { setDefaultApplicationMenu } = require('@electron/internal/browser/defaul
 app.once('will-finish-launching', setDefaultApplicationMenu);
 
 if (packagePath) {
+  // Compile the app's modules with the code caches kept from earlier launches.
+  const moduleCodeCache = process._linkedBinding('electron_browser_module_code_cache');
+  if (moduleCodeCache.isEnabled()) {
+    Module._setCodeCacheHandler(moduleCodeCache);
+  }
+
   // Finally load app's main.js and transfer control to C++.
   process._firstFileName = Module._resolveFilename(path.join(packagePath, mainStartupScript), null, false);
   Module._load(path.join(packagePath, mainStartupScript), Module, true);
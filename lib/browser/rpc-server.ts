@@ -4,6 +4,8 @@ import { ipcMainInternal } from '@electron/internal/browser/ipc-main-internal';
 import * as ipcMainUtils from '@electron/internal/browser/ipc-main-internal-utils';
 import { IPC_MESSAGES } from '@electron/internal/common/ipc-messages';
 
+const { _setSandboxProcessInfo } = process._linkedBinding('electron_browser_web_contents');
+
 // Implements window.close()
 ipcMainInternal.on(IPC_MESSAGES.BROWSER_WINDOW_CLOSE, function (event) {
   const window = event.sender.getOwnerBrowserWindow();
@@ -52,18 +54,26 @@ const getPreloadScript = async function (preloadPath: string) {
   return { preloadPath, preloadSrc, preloadError };
 };
 
+// The properties of the main process that sandboxed preload scripts see on
+// their process object. The browser sends them along with the cached preload
+// scripts, adding the current environment.
+const sandboxProcessInfo = {
+  arch: process.arch,
+  platform: process.platform,
+  version: process.version,
+  versions: process.versions,
+  execPath: process.helperExecPath
+};
+_setSandboxProcessInfo(sandboxProcessInfo);
+
 ipcMainUtils.handleSync(IPC_MESSAGES.BROWSER_SANDBOX_LOAD, async function (event) {
   const preloadPaths = event.sender._getPreloadPaths();
 
   return {
     preloadScripts: await Promise.all(preloadPaths.map(path => getPreloadScript(path))),
     process: {
-      arch: process.arch,
-      platform: process.platform,
-      env: { ...process.env },
-      version: process.version,
-      versions: process.versions,
-      execPath: process.helperExecPath
+      ...sandboxProcessInfo,
+      env: { ...process.env }
     }
   };
 });
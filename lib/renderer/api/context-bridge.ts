@@ -8,6 +8,11 @@ const contextBridge: Electron.ContextBridge = {
   exposeInMainWorld: (key: string, api: any) => {
     checkContextIsolationEnabled();
     return binding.exposeAPIInMainWorld(key, api);
+  },
+  markForTransfer: (buffer: ArrayBuffer | ArrayBufferView) => {
+    checkContextIsolationEnabled();
+    binding.markForTransfer(buffer);
+    return buffer;
   }
 };
 
@@ -25,7 +25,9 @@ Object.setPrototypeOf(process, EventEmitter.prototype);
 const { ipcRendererInternal } = require('@electron/internal/renderer/ipc-renderer-internal') as typeof ipcRendererInternalModule;
 const ipcRendererUtils = require('@electron/internal/renderer/ipc-renderer-internal-utils') as typeof ipcRendererUtilsModule;
 
-const { preloadScripts, process: processProps } = ipcRendererUtils.invokeSync(IPC_MESSAGES.BROWSER_SANDBOX_LOAD);
+// The browser sends the preload scripts along with the navigation once it has
+// them cached, ask for them only when they did not arrive.
+const { preloadScripts, process: processProps } = binding.preloadInfo || ipcRendererUtils.invokeSync(IPC_MESSAGES.BROWSER_SANDBOX_LOAD);
 
 const electron = require('electron');
 
@@ -116,13 +118,13 @@ require('@electron/internal/renderer/common-init');
 // - `process`: The `preloadProcess` object
 // - `Buffer`: Shim of `Buffer` implementation
 // - `global`: The window object, which is aliased to `global` by webpack.
-function runPreloadScript (preloadSrc: string) {
+function runPreloadScript (preloadSrc: string, preloadPath: string) {
   const preloadWrapperSrc = `(function(require, process, Buffer, global, setImmediate, clearImmediate, exports) {
   ${preloadSrc}
   })`;
 
   // eval in window scope
-  const preloadFn = binding.createPreloadScript(preloadWrapperSrc);
+  const preloadFn = binding.createPreloadScript(preloadWrapperSrc, preloadPath);
   const { setImmediate, clearImmediate } = require('timers');
 
   preloadFn(preloadRequire, preloadProcess, Buffer, global, setImmediate, clearImmediate, {});
@@ -131,7 +133,7 @@ function runPreloadScript (preloadSrc: string) {
 for (const { preloadPath, preloadSrc, preloadError } of preloadScripts) {
   try {
     if (preloadSrc) {
-      runPreloadScript(preloadSrc);
+      runPreloadScript(preloadSrc, preloadPath);
     } else if (preloadError) {
       throw preloadError;
     }
@@ -0,0 +1,81 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "base/bind.h"
+#include "base/files/file_path.h"
+#include "shell/browser/module_code_cache.h"
+#include "shell/common/gin_converters/file_path_converter.h"
+#include "shell/common/gin_helper/dictionary.h"
+#include "shell/common/gin_helper/promise.h"
+#include "shell/common/node_includes.h"
+
+namespace {
+
+v8::Local<v8::Value> Get(v8::Isolate* isolate,
+                         const base::FilePath& path,
+                         v8::Local<v8::String> source) {
+  scoped_refptr<base::RefCountedBytes> data =
+      electron::ModuleCodeCache::GetInstance()->Get(isolate, path, source);
+  if (!data)
+    return v8::Undefined(isolate);
+
+  // The Buffer holds a reference to the cached data instead of copying it.
+  base::RefCountedBytes* bytes = data.release();
+  v8::Local<v8::Object> buffer;
+  if (!node::Buffer::New(
+           isolate, reinterpret_cast<char*>(bytes->data().data()),
+           bytes->size(),
+           [](char* data, void* hint) {
+             static_cast<base::RefCountedBytes*>(hint)->Release();
+           },
+           bytes)
+           .ToLocal(&buffer)) {
+    bytes->Release();
+    return v8::Undefined(isolate);
+  }
+  return buffer;
+}
+
+void Compiled(v8::Isolate* isolate,
+              const base::FilePath& path,
+              v8::Local<v8::String> source,
+              v8::Local<v8::Function> function) {
+  electron::ModuleCodeCache::GetInstance()->AddCompiledModule(isolate, path,
+                                                              source, function);
+}
+
+v8::Local<v8::Promise> Flush(v8::Isolate* isolate) {
+  gin_helper::Promise<void> promise(isolate);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+  electron::ModuleCodeCache::GetInstance()->Flush(
+      isolate, base::BindOnce(gin_helper::Promise<void>::ResolvePromise,
+                              std::move(promise)));
+  return handle;
+}
+
+v8::Local<v8::Promise> Prune(v8::Isolate* isolate) {
+  gin_helper::Promise<void> promise(isolate);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+  electron::ModuleCodeCache::GetInstance()->Prune(
+      isolate, base::BindOnce(gin_helper::Promise<void>::ResolvePromise,
+                              std::move(promise)));
+  return handle;
+}
+
+void Initialize(v8::Local<v8::Object> exports,
+                v8::Local<v8::Value> unused,
+                v8::Local<v8::Context> context,
+                void* priv) {
+  v8::Isolate* isolate = context->GetIsolate();
+  gin_helper::Dictionary dict(isolate, exports);
+  dict.SetMethod("isEnabled", &electron::ModuleCodeCache::IsEnabled);
+  dict.SetMethod("get", &Get);
+  dict.SetMethod("compiled", &Compiled);
+  dict.SetMethod("flush", &Flush);
+  dict.SetMethod("prune", &Prune);
+}
+
+}  // namespace
+
+NODE_LINKED_MODULE_CONTEXT_AWARE(electron_browser_module_code_cache, Initialize)
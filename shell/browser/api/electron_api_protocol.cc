@@ -4,6 +4,9 @@
 
 #include "shell/browser/api/electron_api_protocol.h"
 
+#include <cmath>
+#include <map>
+#include <utility>
 #include <vector>
 
 #include "base/command_line.h"
@@ -11,11 +14,16 @@
 #include "content/common/url_schemes.h"
 #include "content/public/browser/child_process_security_policy.h"
 #include "gin/object_template_builder.h"
+#include "net/base/mime_util.h"
 #include "shell/browser/browser.h"
 #include "shell/browser/electron_browser_context.h"
+#include "shell/browser/net/static_protocol_source.h"
 #include "shell/browser/protocol_registry.h"
 #include "shell/common/gin_converters/callback_converter.h"
+#include "shell/common/gin_converters/file_path_converter.h"
 #include "shell/common/gin_converters/net_converter.h"
+#include "shell/common/gin_converters/std_converter.h"
+#include "shell/common/gin_converters/value_converter.h"
 #include "shell/common/gin_helper/dictionary.h"
 #include "shell/common/gin_helper/object_template_builder.h"
 #include "shell/common/gin_helper/promise.h"
@@ -76,6 +84,61 @@ struct Converter<CustomScheme> {
   }
 };
 
+template <>
+struct Converter<electron::StaticProtocolSource::Headers> {
+  static bool FromV8(v8::Isolate* isolate,
+                     v8::Local<v8::Value> val,
+                     electron::StaticProtocolSource::Headers* out) {
+    base::DictionaryValue headers;
+    if (!ConvertFromV8(isolate, val, &headers))
+      return false;
+    for (const auto iter : headers.DictItems()) {
+      if (iter.second.is_string()) {
+        out->emplace_back(iter.first, iter.second.GetString());
+      } else if (iter.second.is_list()) {
+        for (const auto& item : iter.second.GetList()) {
+          if (!item.is_string())
+            return false;
+          out->emplace_back(iter.first, item.GetString());
+        }
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct Converter<electron::StaticProtocolSource::Response> {
+  static bool FromV8(v8::Isolate* isolate,
+                     v8::Local<v8::Value> val,
+                     electron::StaticProtocolSource::Response* out) {
+    gin_helper::Dictionary dict;
+    if (!ConvertFromV8(isolate, val, &dict))
+      return false;
+
+    v8::Local<v8::Value> data;
+    std::string str;
+    if (!dict.Get("data", &data)) {
+      return false;
+    } else if (node::Buffer::HasInstance(data)) {
+      out->data = base::MakeRefCounted<base::RefCountedBytes>(
+          reinterpret_cast<const unsigned char*>(node::Buffer::Data(data)),
+          node::Buffer::Length(data));
+    } else if (ConvertFromV8(isolate, data, &str)) {
+      out->data = base::RefCountedString::TakeString(&str);
+    } else {
+      return false;
+    }
+
+    dict.Get("statusCode", &out->status_code);
+    dict.Get("charset", &out->charset);
+    dict.Get("mimeType", &out->mime_type);
+    return dict.Get("headers", &out->headers) || !dict.Has("headers");
+  }
+};
+
 }  // namespace gin
 
 namespace electron {
@@ -197,6 +260,58 @@ ProtocolError Protocol::RegisterProtocol(ProtocolType type,
   return added ? ProtocolError::kOK : ProtocolError::kRegistered;
 }
 
+bool Protocol::RegisterStaticProtocol(const std::string& scheme,
+                                      const gin_helper::Dictionary& options,
+                                      gin::Arguments* args) {
+  std::map<std::string, StaticProtocolSource::Response> responses;
+  if (options.Has("responses") && !options.Get("responses", &responses)) {
+    args->ThrowTypeError("Invalid responses");
+    return false;
+  }
+  // Guess the MIME type from the path like files are, rather than sending
+  // everything as HTML.
+  for (auto& response : responses) {
+    if (response.second.mime_type.empty() &&
+        !net::GetMimeTypeFromFile(
+            base::FilePath::FromUTF8Unsafe(response.first),
+            &response.second.mime_type)) {
+      response.second.mime_type = "text/html";
+    }
+  }
+
+  base::FilePath directory;
+  if (options.Get("directory", &directory) && !directory.IsAbsolute()) {
+    args->ThrowTypeError("The directory must be an absolute path");
+    return false;
+  }
+
+  StaticProtocolSource::Headers headers;
+  if (options.Has("headers") && !options.Get("headers", &headers)) {
+    args->ThrowTypeError("Header values must be strings or arrays of strings");
+    return false;
+  }
+  double cache_size = StaticProtocolSource::kDefaultCacheSize;
+  if (options.Has("cacheSize") &&
+      (!options.Get("cacheSize", &cache_size) || !std::isfinite(cache_size) ||
+       cache_size < 0)) {
+    args->ThrowTypeError("cacheSize must be a non-negative number");
+    return false;
+  }
+
+  // The handler is optional, requests that can not be served statically fail
+  // without it. It answers like the handler of a buffer protocol.
+  ProtocolHandler handler;
+  if (args->PeekNext()->IsFunction())
+    args->GetNext(&handler);
+
+  return protocol_registry_->RegisterStaticProtocol(
+      ProtocolType::kBuffer, scheme,
+      base::MakeRefCounted<StaticProtocolSource>(
+          std::move(responses), std::move(directory), std::move(headers),
+          static_cast<size_t>(cache_size)),
+      handler);
+}
+
 bool Protocol::UnregisterProtocol(const std::string& scheme,
                                   gin::Arguments* args) {
   bool removed = protocol_registry_->UnregisterProtocol(scheme);
@@ -289,6 +404,7 @@ gin::ObjectTemplateBuilder Protocol::GetObjectTemplateBuilder(
                  &Protocol::RegisterProtocolFor<ProtocolType::kStream>)
       .SetMethod("registerProtocol",
                  &Protocol::RegisterProtocolFor<ProtocolType::kFree>)
+      .SetMethod("registerStaticProtocol", &Protocol::RegisterStaticProtocol)
       .SetMethod("unregisterProtocol", &Protocol::UnregisterProtocol)
       .SetMethod("isProtocolRegistered", &Protocol::IsProtocolRegistered)
       .SetMethod("isProtocolHandled", &Protocol::IsProtocolHandled)
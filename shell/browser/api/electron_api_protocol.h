@@ -60,6 +60,9 @@ class Protocol : public gin::Wrappable<Protocol> {
   ProtocolError RegisterProtocol(ProtocolType type,
                                  const std::string& scheme,
                                  const ProtocolHandler& handler);
+  bool RegisterStaticProtocol(const std::string& scheme,
+                              const gin_helper::Dictionary& options,
+                              gin::Arguments* args);
   bool UnregisterProtocol(const std::string& scheme, gin::Arguments* args);
   bool IsProtocolRegistered(const std::string& scheme);
 
@@ -0,0 +1,38 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "shell/browser/startup_snapshot.h"
+#include "shell/common/gin_converters/file_path_converter.h"
+#include "shell/common/gin_helper/dictionary.h"
+#include "shell/common/gin_helper/error_thrower.h"
+#include "shell/common/node_includes.h"
+
+namespace {
+
+// Returns the path the snapshot was written to.
+base::FilePath Build(v8::Isolate* isolate,
+                     const std::string& source,
+                     const std::string& filename) {
+  base::FilePath path = electron::StartupSnapshot::GetPath();
+  std::string error;
+  if (!electron::StartupSnapshot::Build(source, filename, path, &error))
+    gin_helper::ErrorThrower(isolate).ThrowError(error);
+  return path;
+}
+
+void Initialize(v8::Local<v8::Object> exports,
+                v8::Local<v8::Value> unused,
+                v8::Local<v8::Context> context,
+                void* priv) {
+  v8::Isolate* isolate = context->GetIsolate();
+  gin_helper::Dictionary dict(isolate, exports);
+  dict.SetMethod("build", &Build);
+}
+
+}  // namespace
+
+NODE_LINKED_MODULE_CONTEXT_AWARE(electron_browser_startup_snapshot, Initialize)
@@ -4,6 +4,8 @@
 
 #include "shell/browser/api/electron_api_web_contents.h"
 
+#include <algorithm>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <set>
@@ -12,6 +14,7 @@
 #include <utility>
 #include <vector>
 
+#include "base/containers/flat_map.h"
 #include "base/containers/id_map.h"
 #include "base/files/file_util.h"
 #include "base/ignore_result.h"
@@ -93,6 +96,7 @@
 #include "shell/browser/electron_navigation_throttle.h"
 #include "shell/browser/file_select_helper.h"
 #include "shell/browser/native_window.h"
+#include "shell/browser/preload_script_cache.h"
 #include "shell/browser/session_preferences.h"
 #include "shell/browser/ui/drag_util.h"
 #include "shell/browser/ui/file_dialog.h"
@@ -359,6 +363,59 @@ struct Converter<electron::api::WebContents::Type> {
   }
 };
 
+template <>
+struct Converter<electron::api::WebContents::IPCChannelMode> {
+  static bool FromV8(v8::Isolate* isolate,
+                     v8::Local<v8::Value> val,
+                     electron::api::WebContents::IPCChannelMode* out) {
+    using IPCChannelMode = electron::api::WebContents::IPCChannelMode;
+    std::string mode;
+    if (!ConvertFromV8(isolate, val, &mode))
+      return false;
+    if (mode == "default") {
+      *out = IPCChannelMode::kDefault;
+    } else if (mode == "batch") {
+      *out = IPCChannelMode::kBatch;
+    } else if (mode == "latest") {
+      *out = IPCChannelMode::kLatest;
+    } else {
+      return false;
+    }
+    return true;
+  }
+};
+
+#if BUILDFLAG(ENABLE_OSR)
+template <>
+struct Converter<electron::api::WebContents::PaintMode> {
+  static v8::Local<v8::Value> ToV8(
+      v8::Isolate* isolate,
+      electron::api::WebContents::PaintMode val) {
+    return StringToV8(isolate,
+                      val == electron::api::WebContents::PaintMode::kDamage
+                          ? "damage"
+                          : "image");
+  }
+
+  static bool FromV8(v8::Isolate* isolate,
+                     v8::Local<v8::Value> val,
+                     electron::api::WebContents::PaintMode* out) {
+    using PaintMode = electron::api::WebContents::PaintMode;
+    std::string mode;
+    if (!ConvertFromV8(isolate, val, &mode))
+      return false;
+    if (mode == "image") {
+      *out = PaintMode::kImage;
+    } else if (mode == "damage") {
+      *out = PaintMode::kDamage;
+    } else {
+      return false;
+    }
+    return true;
+  }
+};
+#endif
+
 template <>
 struct Converter<scoped_refptr<content::DevToolsAgentHost>> {
   static v8::Local<v8::Value> ToV8(
@@ -384,6 +441,34 @@ base::IDMap<WebContents*>& GetAllWebContents() {
   return *s_all_web_contents;
 }
 
+// Channels that are not in IPCChannelMode::kDefault.
+base::flat_map<std::string, WebContents::IPCChannelMode>& GetIPCChannelModes() {
+  static base::NoDestructor<
+      base::flat_map<std::string, WebContents::IPCChannelMode>>
+      s_ipc_channel_modes;
+  return *s_ipc_channel_modes;
+}
+
+base::Value& GetSandboxProcessInfo() {
+  static base::NoDestructor<base::Value> s_sandbox_process_info(
+      base::Value::Type::DICTIONARY);
+  return *s_sandbox_process_info;
+}
+
+// Reads the environment on every call, process.env of the main process
+// changes it.
+base::Value GetEnvironment() {
+  base::Value env(base::Value::Type::DICTIONARY);
+  uv_env_item_t* items;
+  int count;
+  if (uv_os_environ(&items, &count) != 0)
+    return env;
+  for (int i = 0; i < count; ++i)
+    env.SetStringKey(items[i].name, items[i].value);
+  uv_os_free_environ(items, count);
+  return env;
+}
+
 void OnThumbnailReady(
     std::unique_ptr<ThumbnailImage::Subscription> subscription,
     base::OnceCallback<void(const gfx::Image&)> callback,
@@ -1729,25 +1814,143 @@ bool WebContents::EmitNavigationEvent(
 void WebContents::Message(bool internal,
                           const std::string& channel,
                           blink::CloneableMessage arguments,
+                          std::vector<base::ReadOnlySharedMemoryRegion> buffers,
                           content::RenderFrameHost* render_frame_host) {
   TRACE_EVENT1("electron", "WebContents::Message", "channel", channel);
+  if (!internal) {
+    const auto& modes = GetIPCChannelModes();
+    auto it = modes.find(channel);
+    if (it != modes.end()) {
+      QueueIPCMessage(it->second, channel, std::move(arguments),
+                      std::move(buffers), render_frame_host);
+      return;
+    }
+  }
   // webContents.emit('-ipc-message', new Event(), internal, channel,
   // arguments);
+  v8::Isolate* isolate = JavascriptEnvironment::GetIsolate();
+  v8::HandleScope handle_scope(isolate);
   EmitWithSender("-ipc-message", render_frame_host,
                  electron::mojom::ElectronBrowser::InvokeCallback(), internal,
-                 channel, std::move(arguments));
+                 channel, DeserializeV8Value(isolate, arguments, buffers));
 }
 
 void WebContents::Invoke(
     bool internal,
     const std::string& channel,
     blink::CloneableMessage arguments,
+    std::vector<base::ReadOnlySharedMemoryRegion> buffers,
     electron::mojom::ElectronBrowser::InvokeCallback callback,
     content::RenderFrameHost* render_frame_host) {
   TRACE_EVENT1("electron", "WebContents::Invoke", "channel", channel);
   // webContents.emit('-ipc-invoke', new Event(), internal, channel, arguments);
+  v8::Isolate* isolate = JavascriptEnvironment::GetIsolate();
+  v8::HandleScope handle_scope(isolate);
   EmitWithSender("-ipc-invoke", render_frame_host, std::move(callback),
-                 internal, channel, std::move(arguments));
+                 internal, channel,
+                 DeserializeV8Value(isolate, arguments, buffers));
+}
+
+WebContents::PendingIPCMessages::PendingIPCMessages() = default;
+WebContents::PendingIPCMessages::PendingIPCMessages(PendingIPCMessages&&) =
+    default;
+WebContents::PendingIPCMessages& WebContents::PendingIPCMessages::operator=(
+    PendingIPCMessages&&) = default;
+WebContents::PendingIPCMessages::~PendingIPCMessages() = default;
+
+// static
+void WebContents::SetIPCChannelMode(const std::string& channel,
+                                    IPCChannelMode mode) {
+  if (mode == IPCChannelMode::kDefault)
+    GetIPCChannelModes().erase(channel);
+  else
+    GetIPCChannelModes()[channel] = mode;
+}
+
+// static
+void WebContents::SetSandboxProcessInfo(base::Value info) {
+  if (info.is_dict())
+    GetSandboxProcessInfo() = std::move(info);
+}
+
+void WebContents::QueueIPCMessage(
+    IPCChannelMode mode,
+    const std::string& channel,
+    blink::CloneableMessage arguments,
+    std::vector<base::ReadOnlySharedMemoryRegion> buffers,
+    content::RenderFrameHost* render_frame_host) {
+  if (pending_ipc_messages_.empty()) {
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::BindOnce(&WebContents::FlushPendingIPCMessages,
+                                  GetWeakPtr()));
+  }
+
+  const content::GlobalRenderFrameHostId sender =
+      render_frame_host->GetGlobalId();
+  auto it = std::find_if(pending_ipc_messages_.begin(),
+                         pending_ipc_messages_.end(),
+                         [&](const PendingIPCMessages& pending) {
+                           return pending.channel == channel &&
+                                  pending.sender == sender;
+                         });
+  if (it == pending_ipc_messages_.end()) {
+    PendingIPCMessages pending;
+    pending.channel = channel;
+    pending.sender = sender;
+    pending_ipc_messages_.push_back(std::move(pending));
+    it = std::prev(pending_ipc_messages_.end());
+  }
+
+  // The mode may have changed since the first message was queued, the latest
+  // one applies to the whole group.
+  it->mode = mode;
+  if (mode == IPCChannelMode::kLatest) {
+    it->arguments.clear();
+    it->buffers.clear();
+  }
+  it->arguments.push_back(std::move(arguments));
+  it->buffers.push_back(std::move(buffers));
+}
+
+void WebContents::FlushPendingIPCMessages() {
+  std::vector<PendingIPCMessages> pending_ipc_messages;
+  pending_ipc_messages.swap(pending_ipc_messages_);
+
+  v8::Isolate* isolate = JavascriptEnvironment::GetIsolate();
+  v8::HandleScope handle_scope(isolate);
+  auto weak_this = GetWeakPtr();
+  for (PendingIPCMessages& pending : pending_ipc_messages) {
+    // A listener may have destroyed this WebContents.
+    if (!weak_this)
+      return;
+    // Messages from a frame that has gone away have no one to reply to.
+    content::RenderFrameHost* render_frame_host =
+        content::RenderFrameHost::FromID(pending.sender);
+    if (!render_frame_host)
+      continue;
+
+    if (pending.mode == IPCChannelMode::kLatest) {
+      // webContents.emit('-ipc-message', new Event(), false, channel,
+      // arguments);
+      EmitWithSender("-ipc-message", render_frame_host,
+                     electron::mojom::ElectronBrowser::InvokeCallback(), false,
+                     pending.channel,
+                     DeserializeV8Value(isolate, pending.arguments.back(),
+                                        pending.buffers.back()));
+      continue;
+    }
+
+    std::vector<v8::Local<v8::Value>> batch;
+    batch.reserve(pending.arguments.size());
+    for (size_t i = 0; i < pending.arguments.size(); ++i) {
+      batch.push_back(DeserializeV8Value(isolate, pending.arguments[i],
+                                         pending.buffers[i]));
+    }
+    // webContents.emit('-ipc-message-batch', new Event(), channel, batch);
+    EmitWithSender("-ipc-message-batch", render_frame_host,
+                   electron::mojom::ElectronBrowser::InvokeCallback(),
+                   pending.channel, batch);
+  }
 }
 
 void WebContents::OnFirstNonEmptyLayout(
@@ -1826,6 +2029,11 @@ void WebContents::UpdateDraggableRegions(
 
 void WebContents::DidStartNavigation(
     content::NavigationHandle* navigation_handle) {
+  // Read the preload scripts while the navigation is in flight, so that they
+  // can be sent along when it is ready to commit.
+  if (ShouldSendPreloadScripts(navigation_handle)) {
+    GetBrowserContext()->preload_script_cache()->Load(GetPreloadPaths());
+  }
   EmitNavigationEvent("did-start-navigation", navigation_handle);
 }
 
@@ -1836,6 +2044,10 @@ void WebContents::DidRedirectNavigation(
 
 void WebContents::ReadyToCommitNavigation(
     content::NavigationHandle* navigation_handle) {
+  SendJs2cCodeCaches(navigation_handle->GetRenderFrameHost());
+  if (ShouldSendPreloadScripts(navigation_handle))
+    SendPreloadScripts(navigation_handle->GetRenderFrameHost());
+
   // Don't focus content in an inactive window.
   if (!owner_window())
     return;
@@ -3012,6 +3224,52 @@ void WebContents::BeginFrameSubscription(gin::Arguments* args) {
       std::make_unique<FrameSubscriber>(web_contents(), callback, only_dirty);
 }
 
+void WebContents::BeginEncodedFrameSubscription(
+    gin_helper::ErrorThrower thrower,
+    const gin_helper::Dictionary& options,
+    const FrameSubscriber::EncodedChunkCallback& callback,
+    absl::optional<FrameSubscriber::EncodingErrorCallback> error_callback) {
+  FrameEncoder::Options encoder_options;
+  std::string codec;
+  options.Get("codec", &codec);
+  if (codec == "vp8") {
+    encoder_options.codec = FrameEncoder::Codec::kVP8;
+  } else if (codec == "vp9") {
+    encoder_options.codec = FrameEncoder::Codec::kVP9;
+  } else if (codec == "h264") {
+    encoder_options.codec = FrameEncoder::Codec::kH264;
+  } else {
+    thrower.ThrowError("'codec' must be one of 'vp8', 'vp9' or 'h264'");
+    return;
+  }
+  if (!FrameEncoder::IsCodecSupported(encoder_options.codec)) {
+    thrower.ThrowError("Encoding " + codec + " is not supported");
+    return;
+  }
+
+  int bitrate = 0;
+  if (options.Get("bitrate", &bitrate)) {
+    if (bitrate <= 0) {
+      thrower.ThrowError("'bitrate' must be a positive integer");
+      return;
+    }
+    encoder_options.bitrate = bitrate;
+  }
+  int key_frame_interval = 0;
+  if (options.Get("keyFrameInterval", &key_frame_interval)) {
+    if (key_frame_interval <= 0) {
+      thrower.ThrowError("'keyFrameInterval' must be a positive integer");
+      return;
+    }
+    encoder_options.key_frame_interval = key_frame_interval;
+  }
+
+  frame_subscriber_ = std::make_unique<FrameSubscriber>(
+      web_contents(), encoder_options, callback,
+      error_callback ? std::move(*error_callback)
+                     : FrameSubscriber::EncodingErrorCallback());
+}
+
 void WebContents::EndFrameSubscription() {
   frame_subscriber_.reset();
 }
@@ -3234,7 +3492,70 @@ bool WebContents::IsOffScreen() const {
 
 #if BUILDFLAG(ENABLE_OSR)
 void WebContents::OnPaint(const gfx::Rect& dirty_rect, const SkBitmap& bitmap) {
-  Emit("paint", dirty_rect, gfx::Image::CreateFrom1xBitmap(bitmap));
+  const base::TimeTicks now = base::TimeTicks::Now();
+  frame_stats_.captured_frames++;
+
+  // Frames are paused as soon as the last credit is used, so only frames that
+  // were already on their way, or come from a view created since, get here
+  // without one.
+  if (!HasFrameCredit()) {
+    frame_stats_.dropped_frames++;
+    UpdateFramesPaused();
+    return;
+  }
+
+  if (frame_credits_ > 0)
+    frames_in_flight_++;
+  frame_stats_.delivered_frames++;
+  if (frames_resumed_time_) {
+    frame_stats_.resumes++;
+    frame_stats_.total_latency += now - *frames_resumed_time_;
+    frames_resumed_time_.reset();
+  }
+  UpdateFramesPaused();
+
+  base::WeakPtr<WebContents> weak_this = GetWeakPtr();
+  EmitPaint(dirty_rect, bitmap);
+  if (weak_this)
+    frame_stats_.total_consumer_time += base::TimeTicks::Now() - now;
+}
+
+void WebContents::EmitPaint(const gfx::Rect& dirty_rect,
+                            const SkBitmap& bitmap) {
+  if (paint_mode_ == PaintMode::kImage) {
+    Emit("paint", dirty_rect, gfx::Image::CreateFrom1xBitmap(bitmap));
+    return;
+  }
+
+  // Only the changed pixels are copied out, and nothing keeps a reference to
+  // |bitmap|, which lets the offscreen view update its backing in place.
+  v8::Isolate* isolate = JavascriptEnvironment::GetIsolate();
+  v8::HandleScope handle_scope(isolate);
+  const gfx::Rect rect = gfx::IntersectRects(
+      dirty_rect, gfx::Rect(bitmap.width(), bitmap.height()));
+  const SkImageInfo info = bitmap.info().makeWH(rect.width(), rect.height());
+  v8::Local<v8::Object> buffer;
+  if (!node::Buffer::New(isolate, info.computeMinByteSize()).ToLocal(&buffer))
+    return;
+  bitmap.readPixels(info, node::Buffer::Data(buffer), info.minRowBytes(),
+                    rect.x(), rect.y());
+  Emit("paint-damage", rect, buffer,
+       gfx::Size(bitmap.width(), bitmap.height()));
+}
+
+bool WebContents::HasFrameCredit() const {
+  return frame_credits_ == 0 || frames_in_flight_ < frame_credits_;
+}
+
+void WebContents::UpdateFramesPaused() {
+  auto* osr_rwhv = GetOffScreenRenderWidgetHostView();
+  if (!osr_rwhv)
+    return;
+  const bool paused = !HasFrameCredit();
+  if (frames_paused_ && !paused)
+    frames_resumed_time_ = base::TimeTicks::Now();
+  frames_paused_ = paused;
+  osr_rwhv->SetFramesPaused(paused);
 }
 
 void WebContents::StartPainting() {
@@ -3264,6 +3585,50 @@ int WebContents::GetFrameRate() const {
   auto* osr_wcv = GetOffScreenWebContentsView();
   return osr_wcv ? osr_wcv->GetFrameRate() : 0;
 }
+
+void WebContents::SetPaintMode(PaintMode mode) {
+  paint_mode_ = mode;
+}
+
+WebContents::PaintMode WebContents::GetPaintMode() const {
+  return paint_mode_;
+}
+
+void WebContents::SetFrameCredits(int credits) {
+  frame_credits_ = std::max(credits, 0);
+  if (frame_credits_ == 0)
+    frames_in_flight_ = 0;
+  UpdateFramesPaused();
+}
+
+int WebContents::GetFrameCredits() const {
+  return frame_credits_;
+}
+
+void WebContents::AcknowledgeFrame() {
+  if (frames_in_flight_ > 0)
+    frames_in_flight_--;
+  UpdateFramesPaused();
+}
+
+v8::Local<v8::Value> WebContents::GetFrameStats(v8::Isolate* isolate) const {
+  const double delivered =
+      std::max(static_cast<double>(frame_stats_.delivered_frames), 1.0);
+  const double resumes =
+      std::max(static_cast<double>(frame_stats_.resumes), 1.0);
+  gin_helper::Dictionary dict = gin::Dictionary::CreateEmpty(isolate);
+  dict.Set("capturedFrames",
+           static_cast<double>(frame_stats_.captured_frames));
+  dict.Set("deliveredFrames",
+           static_cast<double>(frame_stats_.delivered_frames));
+  dict.Set("droppedFrames", static_cast<double>(frame_stats_.dropped_frames));
+  dict.Set("framesInFlight", frames_in_flight_);
+  dict.Set("averageLatency",
+           frame_stats_.total_latency.InMillisecondsF() / resumes);
+  dict.Set("averageConsumerTime",
+           frame_stats_.total_consumer_time.InMillisecondsF() / delivered);
+  return dict.GetHandle();
+}
 #endif
 
 void WebContents::Invalidate() {
@@ -3325,6 +3690,74 @@ void WebContents::DoGetZoomLevel(
   std::move(callback).Run(GetZoomLevel());
 }
 
+void WebContents::SetPreloadCodeCache(
+    const base::FilePath& path,
+    mojo_base::BigBuffer data,
+    content::RenderFrameHost* render_frame_host) {
+  if (!render_frame_host)
+    return;
+  // Only the preload scripts of this WebContents can be cached for it, the
+  // cache ignores any other path.
+  GetBrowserContext()->preload_script_cache()->SetCodeCache(
+      path, GetPreloadPaths(),
+      render_frame_host->GetSiteInstance()->GetSiteURL(), data);
+}
+
+void WebContents::SetJs2cCodeCache(
+    const std::string& id,
+    mojo_base::BigBuffer data,
+    content::RenderFrameHost* render_frame_host) {
+  if (!render_frame_host)
+    return;
+  GetBrowserContext()->preload_script_cache()->SetJs2cCodeCache(
+      id, render_frame_host->GetSiteInstance()->GetSiteURL(), data);
+}
+
+bool WebContents::ShouldSendPreloadScripts(
+    content::NavigationHandle* navigation_handle) const {
+  // Only the sandboxed renderers load the preload scripts through the
+  // browser, see lib/sandboxed_renderer/init.ts.
+  auto* web_preferences = WebContentsPreferences::From(web_contents());
+  if (!web_preferences || !web_preferences->IsSandboxed())
+    return false;
+  return navigation_handle->IsInMainFrame() ||
+         web_preferences->AllowsNodeIntegrationInSubFrames();
+}
+
+void WebContents::SendPreloadScripts(
+    content::RenderFrameHost* render_frame_host) {
+  if (!render_frame_host->IsRenderFrameLive())
+    return;
+  auto scripts = GetBrowserContext()->preload_script_cache()->GetScripts(
+      GetPreloadPaths(), render_frame_host->GetSiteInstance()->GetSiteURL());
+  // The renderer asks for them itself when they are not all cached yet.
+  if (!scripts)
+    return;
+
+  base::Value process = GetSandboxProcessInfo().Clone();
+  process.SetKey("env", GetEnvironment());
+
+  mojo::AssociatedRemote<mojom::ElectronPreloadAgent> preload_agent;
+  render_frame_host->GetRemoteAssociatedInterfaces()->GetInterface(
+      &preload_agent);
+  preload_agent->SetPreloadScripts(std::move(*scripts), std::move(process));
+}
+
+void WebContents::SendJs2cCodeCaches(
+    content::RenderFrameHost* render_frame_host) {
+  if (!render_frame_host->IsRenderFrameLive())
+    return;
+  auto caches = GetBrowserContext()->preload_script_cache()->GetJs2cCodeCaches(
+      render_frame_host->GetSiteInstance()->GetSiteURL());
+  if (caches.empty())
+    return;
+
+  mojo::AssociatedRemote<mojom::ElectronCodeCacheAgent> code_cache_agent;
+  render_frame_host->GetRemoteAssociatedInterfaces()->GetInterface(
+      &code_cache_agent);
+  code_cache_agent->SetJs2cCodeCaches(std::move(caches));
+}
+
 std::vector<base::FilePath> WebContents::GetPreloadPaths() const {
   auto result = SessionPreferences::GetValidPreloads(GetBrowserContext());
 
@@ -4019,6 +4452,8 @@ v8::Local<v8::ObjectTemplate> WebContents::FillObjectTemplate(
       .SetMethod("isFocused", &WebContents::IsFocused)
       .SetMethod("sendInputEvent", &WebContents::SendInputEvent)
       .SetMethod("beginFrameSubscription", &WebContents::BeginFrameSubscription)
+      .SetMethod("beginEncodedFrameSubscription",
+                 &WebContents::BeginEncodedFrameSubscription)
       .SetMethod("endFrameSubscription", &WebContents::EndFrameSubscription)
       .SetMethod("startDrag", &WebContents::StartDrag)
       .SetMethod("attachToIframe", &WebContents::AttachToIframe)
@@ -4030,6 +4465,12 @@ v8::Local<v8::ObjectTemplate> WebContents::FillObjectTemplate(
       .SetMethod("isPainting", &WebContents::IsPainting)
       .SetMethod("setFrameRate", &WebContents::SetFrameRate)
       .SetMethod("getFrameRate", &WebContents::GetFrameRate)
+      .SetMethod("setPaintMode", &WebContents::SetPaintMode)
+      .SetMethod("getPaintMode", &WebContents::GetPaintMode)
+      .SetMethod("setFrameCredits", &WebContents::SetFrameCredits)
+      .SetMethod("getFrameCredits", &WebContents::GetFrameCredits)
+      .SetMethod("acknowledgeFrame", &WebContents::AcknowledgeFrame)
+      .SetMethod("getFrameStats", &WebContents::GetFrameStats)
 #endif
       .SetMethod("invalidate", &WebContents::Invalidate)
       .SetMethod("setZoomLevel", &WebContents::SetZoomLevel)
@@ -4233,6 +4674,9 @@ void Initialize(v8::Local<v8::Object> exports,
   dict.SetMethod("fromId", &WebContentsFromID);
   dict.SetMethod("fromDevToolsTargetId", &WebContentsFromDevToolsTargetID);
   dict.SetMethod("getAllWebContents", &GetAllWebContentsAsV8);
+  dict.SetMethod("_setIPCChannelMode", &WebContents::SetIPCChannelMode);
+  dict.SetMethod("_setSandboxProcessInfo",
+                 &WebContents::SetSandboxProcessInfo);
 }
 
 }  // namespace
@@ -11,15 +11,18 @@
 #include <utility>
 #include <vector>
 
+#include "base/memory/read_only_shared_memory_region.h"
 #include "base/memory/weak_ptr.h"
 #include "base/observer_list.h"
 #include "base/observer_list_types.h"
+#include "base/time/time.h"
 #include "chrome/browser/devtools/devtools_eye_dropper.h"
 #include "chrome/browser/devtools/devtools_file_system_indexer.h"
 #include "chrome/browser/ui/exclusive_access/exclusive_access_context.h"  // nogncheck
 #include "content/common/cursors/webcursor.h"
 #include "content/common/frame.mojom.h"
 #include "content/public/browser/devtools_agent_host.h"
+#include "content/public/browser/global_routing_id.h"
 #include "content/public/browser/keyboard_event_processing_result.h"
 #include "content/public/browser/permission_type.h"
 #include "content/public/browser/render_widget_host.h"
@@ -43,7 +46,9 @@
 #include "shell/common/gin_helper/constructible.h"
 #include "shell/common/gin_helper/error_thrower.h"
 #include "shell/common/gin_helper/pinnable.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 #include "ui/base/models/image_model.h"
+#include "ui/gfx/geometry/rect.h"
 #include "ui/gfx/image/image.h"
 
 #if BUILDFLAG(ENABLE_PRINTING)
@@ -121,6 +126,27 @@ class WebContents : public ExclusiveAccessContext,
     kOffScreen,       // Used for offscreen rendering
   };
 
+  // How the messages sent to the main process on a channel are emitted.
+  enum class IPCChannelMode {
+    kDefault,  // Every message is emitted on its own.
+    kBatch,    // Messages received together are emitted as one array.
+    kLatest,   // Only the last of the messages received together is emitted.
+  };
+
+  // How offscreen frames are emitted.
+  enum class PaintMode {
+    kImage,   // "paint" with a NativeImage of the whole frame.
+    kDamage,  // "paint-damage" with a Buffer of the changed pixels only.
+  };
+
+  // Sets the mode of |channel| for the messages of every WebContents.
+  static void SetIPCChannelMode(const std::string& channel,
+                                IPCChannelMode mode);
+
+  // Sets the properties of the main process that do not change, which
+  // sandboxed preload scripts see on their process object.
+  static void SetSandboxProcessInfo(base::Value info);
+
   // Create a new WebContents and return the V8 wrapper of it.
   static gin::Handle<WebContents> New(v8::Isolate* isolate,
                                       const gin_helper::Dictionary& options);
@@ -265,6 +291,11 @@ class WebContents : public ExclusiveAccessContext,
 
   // Subscribe to the frame updates.
   void BeginFrameSubscription(gin::Arguments* args);
+  void BeginEncodedFrameSubscription(
+      gin_helper::ErrorThrower thrower,
+      const gin_helper::Dictionary& options,
+      const FrameSubscriber::EncodedChunkCallback& callback,
+      absl::optional<FrameSubscriber::EncodingErrorCallback> error_callback);
   void EndFrameSubscription();
 
   // Dragging native items.
@@ -293,6 +324,12 @@ class WebContents : public ExclusiveAccessContext,
   bool IsPainting() const;
   void SetFrameRate(int frame_rate);
   int GetFrameRate() const;
+  void SetPaintMode(PaintMode mode);
+  PaintMode GetPaintMode() const;
+  void SetFrameCredits(int credits);
+  int GetFrameCredits() const;
+  void AcknowledgeFrame();
+  v8::Local<v8::Value> GetFrameStats(v8::Isolate* isolate) const;
 #endif
   void Invalidate();
   gfx::Size GetSizeForNewRenderView(content::WebContents*) override;
@@ -407,10 +444,12 @@ class WebContents : public ExclusiveAccessContext,
   void Message(bool internal,
                const std::string& channel,
                blink::CloneableMessage arguments,
+               std::vector<base::ReadOnlySharedMemoryRegion> buffers,
                content::RenderFrameHost* render_frame_host);
   void Invoke(bool internal,
               const std::string& channel,
               blink::CloneableMessage arguments,
+              std::vector<base::ReadOnlySharedMemoryRegion> buffers,
               electron::mojom::ElectronBrowser::InvokeCallback callback,
               content::RenderFrameHost* render_frame_host);
   void OnFirstNonEmptyLayout(content::RenderFrameHost* render_frame_host);
@@ -433,6 +472,12 @@ class WebContents : public ExclusiveAccessContext,
   void SetTemporaryZoomLevel(double level);
   void DoGetZoomLevel(
       electron::mojom::ElectronBrowser::DoGetZoomLevelCallback callback);
+  void SetPreloadCodeCache(const base::FilePath& path,
+                           mojo_base::BigBuffer data,
+                           content::RenderFrameHost* render_frame_host);
+  void SetJs2cCodeCache(const std::string& id,
+                        mojo_base::BigBuffer data,
+                        content::RenderFrameHost* render_frame_host);
   void SetImageAnimationPolicy(const std::string& new_policy);
   gfx::Size GetPreferredSize();
 
@@ -644,9 +689,35 @@ class WebContents : public ExclusiveAccessContext,
 
   void OnElectronBrowserConnectionError();
 
+  // Holds a message received on a channel in batch or latest mode until
+  // FlushPendingIPCMessages emits it together with the messages received on
+  // the same channel from the same frame before the flush task runs.
+  void QueueIPCMessage(IPCChannelMode mode,
+                       const std::string& channel,
+                       blink::CloneableMessage arguments,
+                       std::vector<base::ReadOnlySharedMemoryRegion> buffers,
+                       content::RenderFrameHost* render_frame_host);
+  void FlushPendingIPCMessages();
+
+  // Sandboxed frames get their preload scripts from the session's
+  // PreloadScriptCache before each navigation commits.
+  bool ShouldSendPreloadScripts(
+      content::NavigationHandle* navigation_handle) const;
+  void SendPreloadScripts(content::RenderFrameHost* render_frame_host);
+
+  // Every frame gets the code caches of the js2c bundles that renderers of
+  // its site created before each navigation commits.
+  void SendJs2cCodeCaches(content::RenderFrameHost* render_frame_host);
+
 #if BUILDFLAG(ENABLE_OSR)
   OffScreenWebContentsView* GetOffScreenWebContentsView() const;
   OffScreenRenderWidgetHostView* GetOffScreenRenderWidgetHostView() const;
+
+  void EmitPaint(const gfx::Rect& dirty_rect, const SkBitmap& bitmap);
+  bool HasFrameCredit() const;
+  // Pauses the frames of the offscreen view while no credits are left, so
+  // that no frame is captured only to be dropped.
+  void UpdateFramesPaused();
 #endif
 
   // Called when received a synchronous message from renderer to
@@ -788,6 +859,28 @@ class WebContents : public ExclusiveAccessContext,
 
   bool offscreen_ = false;
 
+#if BUILDFLAG(ENABLE_OSR)
+  PaintMode paint_mode_ = PaintMode::kImage;
+
+  // The number of paint events that can be emitted before AcknowledgeFrame is
+  // called, or 0 for no limit.
+  int frame_credits_ = 0;
+  int frames_in_flight_ = 0;
+
+  bool frames_paused_ = false;
+  // When frames were last resumed, until the next frame is painted.
+  absl::optional<base::TimeTicks> frames_resumed_time_;
+
+  struct FrameStats {
+    uint64_t captured_frames = 0;
+    uint64_t delivered_frames = 0;
+    uint64_t dropped_frames = 0;
+    uint64_t resumes = 0;
+    base::TimeDelta total_latency;
+    base::TimeDelta total_consumer_time;
+  } frame_stats_;
+#endif
+
   // Whether window is fullscreened by HTML5 api.
   bool html_fullscreen_ = false;
 
@@ -830,6 +923,23 @@ class WebContents : public ExclusiveAccessContext,
   // In-memory cache that holds objects that have been granted permissions.
   DevicePermissionMap granted_devices_;
 
+  struct PendingIPCMessages {
+    PendingIPCMessages();
+    PendingIPCMessages(PendingIPCMessages&&);
+    PendingIPCMessages& operator=(PendingIPCMessages&&);
+    ~PendingIPCMessages();
+
+    IPCChannelMode mode = IPCChannelMode::kBatch;
+    std::string channel;
+    content::GlobalRenderFrameHostId sender;
+    std::vector<blink::CloneableMessage> arguments;
+    std::vector<std::vector<base::ReadOnlySharedMemoryRegion>> buffers;
+  };
+
+  // Messages waiting for FlushPendingIPCMessages, by channel and sender in
+  // the order their first message was received.
+  std::vector<PendingIPCMessages> pending_ipc_messages_;
+
   base::WeakPtrFactory<WebContents> weak_factory_{this};
 };
 
@@ -4,12 +4,14 @@
 
 #include "shell/browser/api/electron_api_web_frame_main.h"
 
+#include <cstring>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "base/logging.h"
+#include "base/memory/read_only_shared_memory_region.h"
 #include "base/no_destructor.h"
 #include "content/browser/renderer_host/frame_tree_node.h"  // nogncheck
 #include "content/public/browser/render_frame_host.h"
@@ -29,6 +31,7 @@
 #include "shell/common/gin_helper/promise.h"
 #include "shell/common/node_includes.h"
 #include "shell/common/v8_value_serializer.h"
+#include "third_party/blink/public/common/messaging/message_port_descriptor.h"
 
 namespace gin {
 
@@ -56,6 +59,15 @@ namespace electron {
 
 namespace api {
 
+namespace {
+
+// Below this size, sending a copy of the arguments to every frame is cheaper
+// than mapping a shared region in each of them. This matches the size above
+// which mojo moves a message into shared memory by itself.
+constexpr size_t kMinSharedMessageSize = 64 * 1024;
+
+}  // namespace
+
 typedef std::unordered_map<int, WebFrameMain*> WebFrameMainIdMap;
 
 WebFrameMainIdMap& GetWebFrameMainMap() {
@@ -181,6 +193,76 @@ void WebFrameMain::Send(v8::Isolate* isolate,
                             0 /* sender_id */);
 }
 
+// static
+void WebFrameMain::Broadcast(v8::Isolate* isolate,
+                             const std::vector<WebFrameMain*>& frames,
+                             bool internal,
+                             const std::string& channel,
+                             v8::Local<v8::Value> args) {
+  blink::CloneableMessage message;
+  if (!gin::ConvertFromV8(isolate, args, &message)) {
+    isolate->ThrowException(v8::Exception::Error(
+        gin::StringToV8(isolate, "Failed to serialize arguments")));
+    return;
+  }
+
+  // Mojo already moves large messages into shared memory, but it would make
+  // one copy per frame. Copy the serialized arguments into a single region
+  // instead, and hand every frame a handle to it.
+  base::ReadOnlySharedMemoryRegion region;
+  if (frames.size() > 1 &&
+      message.encoded_message.size() >= kMinSharedMessageSize) {
+    base::MappedReadOnlyRegion shared =
+        base::ReadOnlySharedMemoryRegion::Create(
+            message.encoded_message.size());
+    if (shared.IsValid()) {
+      memcpy(shared.mapping.memory(), message.encoded_message.data(),
+             message.encoded_message.size());
+      region = std::move(shared.region);
+    }
+  }
+
+  for (WebFrameMain* frame : frames) {
+    // Frames that went away since they were collected are skipped instead of
+    // failing the whole broadcast.
+    if (!frame || frame->render_frame_disposed_)
+      continue;
+    if (region.IsValid()) {
+      frame->GetRendererApi()->SharedMessage(internal, channel,
+                                             region.Duplicate(),
+                                             0 /* sender_id */);
+    } else {
+      frame->GetRendererApi()->Message(internal, channel,
+                                       message.ShallowClone(),
+                                       0 /* sender_id */);
+    }
+  }
+}
+
+// static
+bool WebFrameMain::ConnectFrames(v8::Isolate* isolate,
+                                 WebFrameMain* frame1,
+                                 WebFrameMain* frame2,
+                                 const std::string& channel) {
+  if (!frame1 || !frame2 || frame1 == frame2 || !frame1->CheckRenderFrame() ||
+      !frame2->CheckRenderFrame())
+    return false;
+
+  // Same as creating a MessageChannelMain and transferring one port to each
+  // frame with postMessage.
+  using Ports = std::vector<gin::Handle<MessagePort>>;
+  auto port1 = MessagePort::Create(isolate);
+  auto port2 = MessagePort::Create(isolate);
+  blink::MessagePortDescriptorPair pipe;
+  port1->Entangle(pipe.TakePort0());
+  port2->Entangle(pipe.TakePort1());
+  frame1->PostMessage(isolate, channel, v8::Null(isolate),
+                      gin::ConvertToV8(isolate, Ports{port1}));
+  frame2->PostMessage(isolate, channel, v8::Null(isolate),
+                      gin::ConvertToV8(isolate, Ports{port2}));
+  return true;
+}
+
 const mojo::Remote<mojom::ElectronRenderer>& WebFrameMain::GetRendererApi() {
   if (!renderer_api_) {
     pending_receiver_ = renderer_api_.BindNewPipeAndPassReceiver();
@@ -383,6 +465,32 @@ namespace {
 
 using electron::api::WebFrameMain;
 
+void Broadcast(gin_helper::ErrorThrower thrower,
+               const std::vector<WebFrameMain*>& frames,
+               bool internal,
+               const std::string& channel,
+               v8::Local<v8::Value> args) {
+  if (!electron::Browser::Get()->is_ready()) {
+    thrower.ThrowError("WebFrameMain is available only after app ready");
+    return;
+  }
+
+  WebFrameMain::Broadcast(thrower.isolate(), frames, internal, channel, args);
+}
+
+bool ConnectFrames(gin_helper::ErrorThrower thrower,
+                   WebFrameMain* frame1,
+                   WebFrameMain* frame2,
+                   const std::string& channel) {
+  if (!electron::Browser::Get()->is_ready()) {
+    thrower.ThrowError("WebFrameMain is available only after app ready");
+    return false;
+  }
+
+  return WebFrameMain::ConnectFrames(thrower.isolate(), frame1, frame2,
+                                     channel);
+}
+
 v8::Local<v8::Value> FromID(gin_helper::ErrorThrower thrower,
                             int render_process_id,
                             int render_frame_id) {
@@ -405,6 +513,8 @@ void Initialize(v8::Local<v8::Object> exports,
   gin_helper::Dictionary dict(isolate, exports);
   dict.Set("WebFrameMain", WebFrameMain::GetConstructor(context));
   dict.SetMethod("fromId", &FromID);
+  dict.SetMethod("_broadcast", &Broadcast);
+  dict.SetMethod("connect", &ConnectFrames);
 }
 
 }  // namespace
@@ -57,6 +57,20 @@ class WebFrameMain : public gin::Wrappable<WebFrameMain>,
       v8::Local<v8::ObjectTemplate>);
   const char* GetTypeName() override;
 
+  // Serialize |args| once and send them to every frame in |frames|.
+  static void Broadcast(v8::Isolate* isolate,
+                        const std::vector<WebFrameMain*>& frames,
+                        bool internal,
+                        const std::string& channel,
+                        v8::Local<v8::Value> args);
+
+  // Hand each frame one end of a new message pipe, as a MessagePort received
+  // on |channel|, so that they can talk without going through this process.
+  static bool ConnectFrames(v8::Isolate* isolate,
+                            WebFrameMain* frame1,
+                            WebFrameMain* frame2,
+                            const std::string& channel);
+
   content::RenderFrameHost* render_frame_host() const { return render_frame_; }
 
   // disable copy
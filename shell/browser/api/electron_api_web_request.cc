@@ -7,6 +7,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/stl_util.h"
 #include "base/values.h"
@@ -15,6 +16,7 @@
 #include "gin/dictionary.h"
 #include "gin/object_template_builder.h"
 #include "net/http/http_content_disposition.h"
+#include "net/http/http_util.h"
 #include "shell/browser/api/electron_api_session.h"
 #include "shell/browser/api/electron_api_web_contents.h"
 #include "shell/browser/api/electron_api_web_frame_main.h"
@@ -77,6 +79,66 @@ struct Converter<extensions::WebRequestResourceType> {
     }
     return StringToV8(isolate, result);
   }
+
+  static bool FromV8(v8::Isolate* isolate,
+                     v8::Local<v8::Value> val,
+                     extensions::WebRequestResourceType* out) {
+    std::string type;
+    if (!ConvertFromV8(isolate, val, &type))
+      return false;
+    if (type == "mainFrame")
+      *out = extensions::WebRequestResourceType::MAIN_FRAME;
+    else if (type == "subFrame")
+      *out = extensions::WebRequestResourceType::SUB_FRAME;
+    else if (type == "stylesheet")
+      *out = extensions::WebRequestResourceType::STYLESHEET;
+    else if (type == "script")
+      *out = extensions::WebRequestResourceType::SCRIPT;
+    else if (type == "image")
+      *out = extensions::WebRequestResourceType::IMAGE;
+    else if (type == "font")
+      *out = extensions::WebRequestResourceType::FONT;
+    else if (type == "object")
+      *out = extensions::WebRequestResourceType::OBJECT;
+    else if (type == "xhr")
+      *out = extensions::WebRequestResourceType::XHR;
+    else if (type == "ping")
+      *out = extensions::WebRequestResourceType::PING;
+    else if (type == "cspReport")
+      *out = extensions::WebRequestResourceType::CSP_REPORT;
+    else if (type == "media")
+      *out = extensions::WebRequestResourceType::MEDIA;
+    else if (type == "webSocket")
+      *out = extensions::WebRequestResourceType::WEB_SOCKET;
+    else if (type == "other")
+      *out = extensions::WebRequestResourceType::OTHER;
+    else
+      return false;
+    return true;
+  }
+};
+
+template <>
+struct Converter<electron::WebRequestRules::Action> {
+  static bool FromV8(v8::Isolate* isolate,
+                     v8::Local<v8::Value> val,
+                     electron::WebRequestRules::Action* out) {
+    using Action = electron::WebRequestRules::Action;
+    std::string action;
+    if (!ConvertFromV8(isolate, val, &action))
+      return false;
+    if (action == "block")
+      *out = Action::kBlock;
+    else if (action == "redirect")
+      *out = Action::kRedirect;
+    else if (action == "upgradeScheme")
+      *out = Action::kUpgradeScheme;
+    else if (action == "modifyHeaders")
+      *out = Action::kModifyHeaders;
+    else
+      return false;
+    return true;
+  }
 };
 
 }  // namespace gin
@@ -89,23 +151,123 @@ namespace {
 
 const char kUserDataKey[] = "WebRequest";
 
+// The same limit as for the redirects of a URLRequest.
+constexpr int kMaxRuleRedirects = 20;
+
 // BrowserContext <=> WebRequest relationship.
 struct UserData : public base::SupportsUserData::Data {
   explicit UserData(WebRequest* data) : data(data) {}
   WebRequest* data;
 };
 
-// Test whether the URL of |request| matches |patterns|.
-bool MatchesFilterCondition(extensions::WebRequestInfo* info,
-                            const std::set<URLPattern>& patterns) {
-  if (patterns.empty())
-    return true;
+// Parse |filter_patterns| into |patterns|, or describe the first invalid one
+// in |error|.
+bool ParseURLPatterns(const std::set<std::string>& filter_patterns,
+                      std::set<URLPattern>* patterns,
+                      std::string* error) {
+  for (const std::string& filter_pattern : filter_patterns) {
+    URLPattern pattern(URLPattern::SCHEME_ALL);
+    const URLPattern::ParseResult result = pattern.Parse(filter_pattern);
+    if (result != URLPattern::ParseResult::kSuccess) {
+      *error = "Invalid url pattern " + filter_pattern + ": " +
+               URLPattern::GetParseResultString(result);
+      return false;
+    }
+    patterns->insert(pattern);
+  }
+  return true;
+}
+
+// Read the header names and values of a modifyHeaders rule.
+bool ReadRuleHeaders(const gin::Dictionary& dict,
+                     const char* set_key,
+                     const char* remove_key,
+                     WebRequestRules::Headers* set_headers,
+                     std::vector<std::string>* remove_headers,
+                     std::string* error) {
+  std::map<std::string, std::string> headers;
+  if (dict.Get(set_key, &headers)) {
+    for (auto& header : headers) {
+      if (!net::HttpUtil::IsValidHeaderName(header.first) ||
+          !net::HttpUtil::IsValidHeaderValue(header.second)) {
+        *error = "Invalid header " + header.first;
+        return false;
+      }
+      set_headers->emplace_back(header.first, std::move(header.second));
+    }
+  }
+  if (dict.Get(remove_key, remove_headers)) {
+    for (const auto& name : *remove_headers) {
+      if (!net::HttpUtil::IsValidHeaderName(name)) {
+        *error = "Invalid header " + name;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool ReadRule(v8::Isolate* isolate,
+              v8::Local<v8::Value> value,
+              WebRequestRules::Rule* rule,
+              std::string* error) {
+  gin::Dictionary dict(isolate);
+  if (!value->IsObject() || !gin::ConvertFromV8(isolate, value, &dict)) {
+    *error = "Each rule must be an object.";
+    return false;
+  }
 
-  for (const auto& pattern : patterns) {
-    if (pattern.MatchesURL(info->url))
-      return true;
+  std::set<std::string> urls;
+  std::set<std::string> initiators;
+  std::set<URLPattern> url_patterns;
+  std::set<URLPattern> initiator_patterns;
+  dict.Get("urls", &urls);
+  dict.Get("initiators", &initiators);
+  if (!ParseURLPatterns(urls, &url_patterns, error) ||
+      !ParseURLPatterns(initiators, &initiator_patterns, error))
+    return false;
+  rule->urls = URLPatternMatcher(url_patterns);
+  rule->initiators = URLPatternMatcher(initiator_patterns);
+
+  v8::Local<v8::Value> resource_types;
+  if (dict.Get("resourceTypes", &resource_types) &&
+      !resource_types->IsUndefined() &&
+      !gin::ConvertFromV8(isolate, resource_types, &rule->resource_types)) {
+    *error = "Invalid resourceTypes.";
+    return false;
+  }
+
+  if (!dict.Get("action", &rule->action)) {
+    *error = "Rule must have a valid 'action'.";
+    return false;
+  }
+
+  switch (rule->action) {
+    case WebRequestRules::Action::kRedirect:
+      if (!dict.Get("redirectURL", &rule->redirect_url) ||
+          !rule->redirect_url.is_valid()) {
+        *error = "A redirect rule must have a valid 'redirectURL'.";
+        return false;
+      }
+      break;
+    case WebRequestRules::Action::kModifyHeaders:
+      return ReadRuleHeaders(dict, "setRequestHeaders", "removeRequestHeaders",
+                             &rule->set_request_headers,
+                             &rule->remove_request_headers, error) &&
+             ReadRuleHeaders(dict, "setResponseHeaders",
+                             "removeResponseHeaders",
+                             &rule->set_response_headers,
+                             &rule->remove_response_headers, error);
+    default:
+      break;
   }
-  return false;
+  return true;
+}
+
+// Test whether the URL of |request| matches |patterns|.
+bool MatchesFilterCondition(extensions::WebRequestInfo* info,
+                            const URLPatternMatcher& patterns) {
+  return patterns.MatchesURL(info->url);
 }
 
 // Convert HttpResponseHeaders to V8.
@@ -114,14 +276,15 @@ bool MatchesFilterCondition(extensions::WebRequestInfo* info,
 // not use it because it lowercases the header keys, while the webRequest has
 // to pass the original keys.
 v8::Local<v8::Value> HttpResponseHeadersToV8(
+    v8::Isolate* isolate,
     net::HttpResponseHeaders* headers) {
-  base::DictionaryValue response_headers;
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Object> response_headers = v8::Object::New(isolate);
   if (headers) {
     size_t iter = 0;
     std::string key;
     std::string value;
     while (headers->EnumerateHeaderLines(&iter, &key, &value)) {
-      base::Value* values = response_headers.FindListKey(key);
       // Note that Web servers not developed with nodejs allow non-utf8
       // characters in content-disposition's filename field. Use Chromium's
       // HttpContentDisposition class to decode the correct encoding instead of
@@ -138,76 +301,202 @@ v8::Local<v8::Value> HttpResponseHeadersToV8(
         std::string filename = "\"" + header.filename() + "\"";
         value = decodedFilename + "; filename=" + filename;
       }
-      if (!values)
-        values = response_headers.SetKey(key, base::ListValue());
-      values->Append(value);
+      // The values are appended to the V8 arrays directly instead of going
+      // through a base::DictionaryValue first.
+      v8::Local<v8::String> name = gin::StringToV8(isolate, key);
+      v8::Local<v8::Value> values;
+      if (!response_headers->HasOwnProperty(context, name).FromMaybe(false) ||
+          !response_headers->Get(context, name).ToLocal(&values) ||
+          !values->IsArray()) {
+        values = v8::Array::New(isolate);
+        response_headers->CreateDataProperty(context, name, values).Check();
+      }
+      v8::Local<v8::Array> array = values.As<v8::Array>();
+      array
+          ->CreateDataProperty(context, array->Length(),
+                               gin::StringToV8(isolate, value))
+          .Check();
     }
   }
-  return gin::ConvertToV8(v8::Isolate::GetCurrent(), response_headers);
+  return response_headers;
 }
 
+// What the lazy properties of a details object are built from.
+//
+// Listeners usually only read a few cheap properties like "url", so the ones
+// that need a lookup or a conversion are only built when they are first read.
+// The source is the data of the lazy properties, which keeps it alive until
+// each of them has been read or the details object is collected. It holds
+// copies rather than the WebRequestInfo, which may be gone by then.
+class DetailsSource : public gin::Wrappable<DetailsSource> {
+ public:
+  static gin::WrapperInfo kWrapperInfo;
+
+  static gin::Handle<DetailsSource> Create(v8::Isolate* isolate) {
+    return gin::CreateHandle(isolate, new DetailsSource);
+  }
+
+  // gin::Wrappable
+  const char* GetTypeName() override { return "WebRequestDetailsSource"; }
+
+  enum class Property {
+    kFrame,
+    kWebContents,
+    kWebContentsId,
+    kReferrer,
+    kUploadData,
+    kRequestHeaders,
+    kResponseHeaders,
+  };
+
+  template <Property property>
+  static void Get(v8::Local<v8::Name> name,
+                  const v8::PropertyCallbackInfo<v8::Value>& info) {
+    v8::Isolate* isolate = info.GetIsolate();
+    DetailsSource* source = nullptr;
+    if (!gin::ConvertFromV8(isolate, info.Data(), &source))
+      return;
+    v8::Local<v8::Value> value = source->Build(isolate, property);
+    if (!value.IsEmpty())
+      info.GetReturnValue().Set(value);
+  }
+
+  int render_process_id = -1;
+  int frame_id = -1;
+  GURL referrer;
+  scoped_refptr<network::ResourceRequestBody> request_body;
+  net::HttpRequestHeaders request_headers;
+  scoped_refptr<net::HttpResponseHeaders> response_headers;
+
+ private:
+  DetailsSource() = default;
+
+  v8::Local<v8::Value> Build(v8::Isolate* isolate, Property property) {
+    switch (property) {
+      case Property::kFrame:
+        return gin::ConvertToV8(isolate, content::RenderFrameHost::FromID(
+                                             render_process_id, frame_id));
+      case Property::kWebContents:
+      case Property::kWebContentsId: {
+        auto* api_web_contents = GetWebContents();
+        if (!api_web_contents)
+          return v8::Undefined(isolate);
+        if (property == Property::kWebContentsId)
+          return gin::ConvertToV8(isolate, api_web_contents->ID());
+        return gin::ConvertToV8(isolate, api_web_contents);
+      }
+      case Property::kReferrer:
+        return gin::ConvertToV8(isolate, referrer);
+      case Property::kUploadData:
+        return gin::ConvertToV8(isolate, *request_body);
+      case Property::kRequestHeaders:
+        return gin::ConvertToV8(isolate, request_headers);
+      case Property::kResponseHeaders:
+        return HttpResponseHeadersToV8(isolate, response_headers.get());
+    }
+    return v8::Local<v8::Value>();
+  }
+
+  WebContents* GetWebContents() const {
+    auto* render_frame_host =
+        content::RenderFrameHost::FromID(render_process_id, frame_id);
+    if (!render_frame_host)
+      return nullptr;
+    return WebContents::From(
+        content::WebContents::FromRenderFrameHost(render_frame_host));
+  }
+};
+
+gin::WrapperInfo DetailsSource::kWrapperInfo = {gin::kEmbedderNativeGin};
+
+// A details object under construction.
+struct Details {
+  gin_helper::Dictionary dict;
+  gin::Handle<DetailsSource> source;
+
+  // Define |key| to be built by |source| when first read.
+  template <DetailsSource::Property property>
+  void SetLazy(base::StringPiece key) {
+    v8::Isolate* isolate = dict.isolate();
+    dict.GetHandle()
+        ->SetLazyDataProperty(isolate->GetCurrentContext(),
+                              gin::StringToV8(isolate, key),
+                              &DetailsSource::Get<property>, source.ToV8())
+        .Check();
+  }
+};
+
 // Overloaded by multiple types to fill the |details| object.
-void ToDictionary(gin_helper::Dictionary* details,
-                  extensions::WebRequestInfo* info) {
-  details->Set("id", info->id);
-  details->Set("url", info->url);
-  details->Set("method", info->method);
-  details->Set("timestamp", base::Time::Now().ToDoubleT() * 1000);
-  details->Set("resourceType", info->web_request_type);
+void ToDictionary(Details* details, extensions::WebRequestInfo* info) {
+  using Property = DetailsSource::Property;
+  details->dict.Set("id", info->id);
+  details->dict.Set("url", info->url);
+  details->dict.Set("method", info->method);
+  details->dict.Set("timestamp", base::Time::Now().ToDoubleT() * 1000);
+  details->dict.Set("resourceType", info->web_request_type);
   if (!info->response_ip.empty())
-    details->Set("ip", info->response_ip);
+    details->dict.Set("ip", info->response_ip);
   if (info->response_headers) {
-    details->Set("fromCache", info->response_from_cache);
-    details->Set("statusLine", info->response_headers->GetStatusLine());
-    details->Set("statusCode", info->response_headers->response_code());
-    details->Set("responseHeaders",
-                 HttpResponseHeadersToV8(info->response_headers.get()));
+    details->dict.Set("fromCache", info->response_from_cache);
+    details->dict.Set("statusLine", info->response_headers->GetStatusLine());
+    details->dict.Set("statusCode", info->response_headers->response_code());
+    details->source->response_headers = info->response_headers;
+    details->SetLazy<Property::kResponseHeaders>("responseHeaders");
   }
 
-  auto* render_frame_host =
-      content::RenderFrameHost::FromID(info->render_process_id, info->frame_id);
-  if (render_frame_host) {
-    details->SetGetter("frame", render_frame_host);
-    auto* web_contents =
-        content::WebContents::FromRenderFrameHost(render_frame_host);
-    auto* api_web_contents = WebContents::From(web_contents);
-    if (api_web_contents) {
-      details->Set("webContents", api_web_contents);
-      details->Set("webContentsId", api_web_contents->ID());
-    }
+  if (content::RenderFrameHost::FromID(info->render_process_id,
+                                       info->frame_id)) {
+    details->source->render_process_id = info->render_process_id;
+    details->source->frame_id = info->frame_id;
+    details->SetLazy<Property::kFrame>("frame");
+    details->SetLazy<Property::kWebContents>("webContents");
+    details->SetLazy<Property::kWebContentsId>("webContentsId");
   }
 }
 
-void ToDictionary(gin_helper::Dictionary* details,
-                  const network::ResourceRequest& request) {
-  details->Set("referrer", request.referrer);
-  if (request.request_body)
-    details->Set("uploadData", *request.request_body);
+void ToDictionary(Details* details, const network::ResourceRequest& request) {
+  details->source->referrer = request.referrer;
+  details->SetLazy<DetailsSource::Property::kReferrer>("referrer");
+  if (request.request_body) {
+    details->source->request_body = request.request_body;
+    details->SetLazy<DetailsSource::Property::kUploadData>("uploadData");
+  }
 }
 
-void ToDictionary(gin_helper::Dictionary* details,
-                  const net::HttpRequestHeaders& headers) {
-  details->Set("requestHeaders", headers);
+void ToDictionary(Details* details, const net::HttpRequestHeaders& headers) {
+  details->source->request_headers = headers;
+  details->SetLazy<DetailsSource::Property::kRequestHeaders>("requestHeaders");
 }
 
-void ToDictionary(gin_helper::Dictionary* details, const GURL& location) {
-  details->Set("redirectURL", location);
+// The response headers as modified by rules, if they were.
+void ToDictionary(Details* details,
+                  const scoped_refptr<net::HttpResponseHeaders>& headers) {
+  if (headers)
+    details->source->response_headers = headers;
 }
 
-void ToDictionary(gin_helper::Dictionary* details, int net_error) {
-  details->Set("error", net::ErrorToString(net_error));
+void ToDictionary(Details* details, const GURL& location) {
+  details->dict.Set("redirectURL", location);
 }
 
-// Helper function to fill |details| with arbitrary |args|.
-template <typename Arg>
-void FillDetails(gin_helper::Dictionary* details, Arg arg) {
-  ToDictionary(details, arg);
+void ToDictionary(Details* details, int net_error) {
+  details->dict.Set("error", net::ErrorToString(net_error));
 }
 
-template <typename Arg, typename... Args>
-void FillDetails(gin_helper::Dictionary* details, Arg arg, Args... args) {
-  ToDictionary(details, arg);
-  FillDetails(details, args...);
+// Helper function to fill |details| with arbitrary |args|.
+//
+// This is not allocation-free: every event creates a details object and a
+// DetailsSource, and copies the request headers into the source, since
+// listeners may keep the details past the event. What is saved for listeners
+// that never read them is building the lazy properties, and headers are
+// copied into plain V8 objects on first read rather than exposed as a view of
+// the native headers, so that listeners can modify them.
+template <typename... Args>
+v8::Local<v8::Value> FillDetails(v8::Isolate* isolate, const Args&... args) {
+  Details details{gin_helper::Dictionary(isolate, v8::Object::New(isolate)),
+                  DetailsSource::Create(isolate)};
+  (ToDictionary(&details, args), ...);
+  return details.dict.GetHandle();
 }
 
 // Fill the native types with the result from the response object.
@@ -248,17 +537,25 @@ void ReadFromResponse(v8::Isolate* isolate,
 gin::WrapperInfo WebRequest::kWrapperInfo = {gin::kEmbedderNativeGin};
 
 WebRequest::SimpleListenerInfo::SimpleListenerInfo(
-    std::set<URLPattern> patterns_,
+    URLPatternMatcher patterns_,
     SimpleListener listener_)
     : url_patterns(std::move(patterns_)), listener(listener_) {}
 WebRequest::SimpleListenerInfo::SimpleListenerInfo() = default;
+WebRequest::SimpleListenerInfo::SimpleListenerInfo(SimpleListenerInfo&&) =
+    default;
+WebRequest::SimpleListenerInfo& WebRequest::SimpleListenerInfo::operator=(
+    SimpleListenerInfo&&) = default;
 WebRequest::SimpleListenerInfo::~SimpleListenerInfo() = default;
 
 WebRequest::ResponseListenerInfo::ResponseListenerInfo(
-    std::set<URLPattern> patterns_,
+    URLPatternMatcher patterns_,
     ResponseListener listener_)
     : url_patterns(std::move(patterns_)), listener(listener_) {}
 WebRequest::ResponseListenerInfo::ResponseListenerInfo() = default;
+WebRequest::ResponseListenerInfo::ResponseListenerInfo(
+    ResponseListenerInfo&&) = default;
+WebRequest::ResponseListenerInfo& WebRequest::ResponseListenerInfo::operator=(
+    ResponseListenerInfo&&) = default;
 WebRequest::ResponseListenerInfo::~ResponseListenerInfo() = default;
 
 WebRequest::WebRequest(v8::Isolate* isolate,
@@ -274,6 +571,7 @@ WebRequest::~WebRequest() {
 gin::ObjectTemplateBuilder WebRequest::GetObjectTemplateBuilder(
     v8::Isolate* isolate) {
   return gin::Wrappable<WebRequest>::GetObjectTemplateBuilder(isolate)
+      .SetMethod("setRules", &WebRequest::SetRules)
       .SetMethod(
           "onBeforeRequest",
           &WebRequest::SetResponseListener<ResponseEvent::kOnBeforeRequest>)
@@ -301,26 +599,47 @@ const char* WebRequest::GetTypeName() {
 }
 
 bool WebRequest::HasListener() const {
-  return !(simple_listeners_.empty() && response_listeners_.empty());
+  return !(simple_listeners_.empty() && response_listeners_.empty() &&
+           rules_.empty());
 }
 
 int WebRequest::OnBeforeRequest(extensions::WebRequestInfo* info,
                                 const network::ResourceRequest& request,
                                 net::CompletionOnceCallback callback,
                                 GURL* new_url) {
+  // A rule that blocks or redirects the request settles it before any
+  // listener is asked.
+  GURL rule_url;
+  const int result = rules_.OnBeforeRequest(*info, &rule_url);
+  if (result != net::OK)
+    return result;
+  if (!rule_url.is_empty()) {
+    // Rules redirecting to each other would loop forever.
+    if (++rule_redirects_[info->id] > kMaxRuleRedirects)
+      return net::ERR_TOO_MANY_REDIRECTS;
+    *new_url = std::move(rule_url);
+    return net::OK;
+  }
   return HandleResponseEvent(ResponseEvent::kOnBeforeRequest, info,
-                             std::move(callback), new_url, request);
+                             std::move(callback), new_url, base::OnceClosure(),
+                             request);
 }
 
 int WebRequest::OnBeforeSendHeaders(extensions::WebRequestInfo* info,
                                     const network::ResourceRequest& request,
                                     BeforeSendHeadersCallback callback,
                                     net::HttpRequestHeaders* headers) {
+  // The listener sees the headers set by rules, and the rules are applied
+  // again to what it returns so that they take precedence over it.
+  ApplyRequestHeaderRules(info, headers);
   return HandleResponseEvent(
       ResponseEvent::kOnBeforeSendHeaders, info,
       base::BindOnce(std::move(callback), std::set<std::string>(),
                      std::set<std::string>()),
-      headers, request, *headers);
+      headers,
+      base::BindOnce(&WebRequest::ApplyRequestHeaderRules,
+                     base::Unretained(this), info, headers),
+      request, *headers);
 }
 
 int WebRequest::OnHeadersReceived(
@@ -333,9 +652,15 @@ int WebRequest::OnHeadersReceived(
   const std::string& status_line =
       original_response_headers ? original_response_headers->GetStatusLine()
                                 : std::string();
+  ApplyResponseHeaderRules(info, original_response_headers,
+                           override_response_headers);
   return HandleResponseEvent(
       ResponseEvent::kOnHeadersReceived, info, std::move(callback),
-      std::make_pair(override_response_headers, status_line), request);
+      std::make_pair(override_response_headers, status_line),
+      base::BindOnce(&WebRequest::ApplyResponseHeaderRules,
+                     base::Unretained(this), info, original_response_headers,
+                     override_response_headers),
+      request, *override_response_headers);
 }
 
 void WebRequest::OnSendHeaders(extensions::WebRequestInfo* info,
@@ -360,6 +685,7 @@ void WebRequest::OnErrorOccurred(extensions::WebRequestInfo* info,
                                  const network::ResourceRequest& request,
                                  int net_error) {
   callbacks_.erase(info->id);
+  rule_redirects_.erase(info->id);
 
   HandleSimpleEvent(SimpleEvent::kOnErrorOccurred, info, request, net_error);
 }
@@ -368,12 +694,48 @@ void WebRequest::OnCompleted(extensions::WebRequestInfo* info,
                              const network::ResourceRequest& request,
                              int net_error) {
   callbacks_.erase(info->id);
+  rule_redirects_.erase(info->id);
 
   HandleSimpleEvent(SimpleEvent::kOnCompleted, info, request, net_error);
 }
 
 void WebRequest::OnRequestWillBeDestroyed(extensions::WebRequestInfo* info) {
   callbacks_.erase(info->id);
+  rule_redirects_.erase(info->id);
+}
+
+void WebRequest::ApplyRequestHeaderRules(extensions::WebRequestInfo* info,
+                                         net::HttpRequestHeaders* headers) {
+  rules_.OnBeforeSendHeaders(*info, headers);
+}
+
+void WebRequest::ApplyResponseHeaderRules(
+    extensions::WebRequestInfo* info,
+    const net::HttpResponseHeaders* original_response_headers,
+    scoped_refptr<net::HttpResponseHeaders>* override_response_headers) {
+  rules_.OnHeadersReceived(*info, original_response_headers,
+                           override_response_headers);
+}
+
+void WebRequest::SetRules(gin::Arguments* args) {
+  v8::Local<v8::Value> arg;
+  std::vector<v8::Local<v8::Value>> values;
+  if (!args->GetNext(&arg) ||
+      !(arg->IsNullOrUndefined() ||
+        gin::ConvertFromV8(args->isolate(), arg, &values))) {
+    args->ThrowTypeError("Must pass null or an Array of rules");
+    return;
+  }
+
+  std::vector<WebRequestRules::Rule> rules(values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    std::string error;
+    if (!ReadRule(args->isolate(), values[i], &rules[i], &error)) {
+      args->ThrowTypeError(error);
+      return;
+    }
+  }
+  rules_.SetRules(std::move(rules));
 }
 
 template <WebRequest::SimpleEvent event>
@@ -409,17 +771,10 @@ void WebRequest::SetListener(Event event,
   }
 
   std::set<URLPattern> patterns;
-  for (const std::string& filter_pattern : filter_patterns) {
-    URLPattern pattern(URLPattern::SCHEME_ALL);
-    const URLPattern::ParseResult result = pattern.Parse(filter_pattern);
-    if (result == URLPattern::ParseResult::kSuccess) {
-      patterns.insert(pattern);
-    } else {
-      const char* error_type = URLPattern::GetParseResultString(result);
-      args->ThrowTypeError("Invalid url pattern " + filter_pattern + ": " +
-                           error_type);
-      return;
-    }
+  std::string error;
+  if (!ParseURLPatterns(filter_patterns, &patterns, &error)) {
+    args->ThrowTypeError(error);
+    return;
   }
 
   // Function or null.
@@ -430,16 +785,18 @@ void WebRequest::SetListener(Event event,
     return;
   }
 
+  // The patterns are compiled once here rather than being scanned for every
+  // request.
   if (listener.is_null())
     listeners->erase(event);
   else
-    (*listeners)[event] = {std::move(patterns), std::move(listener)};
+    (*listeners)[event] = {URLPatternMatcher(patterns), std::move(listener)};
 }
 
 template <typename... Args>
 void WebRequest::HandleSimpleEvent(SimpleEvent event,
                                    extensions::WebRequestInfo* request_info,
-                                   Args... args) {
+                                   const Args&... args) {
   const auto iter = simple_listeners_.find(event);
   if (iter == std::end(simple_listeners_))
     return;
@@ -450,9 +807,7 @@ void WebRequest::HandleSimpleEvent(SimpleEvent event,
 
   v8::Isolate* isolate = JavascriptEnvironment::GetIsolate();
   v8::HandleScope handle_scope(isolate);
-  gin_helper::Dictionary details(isolate, v8::Object::New(isolate));
-  FillDetails(&details, request_info, args...);
-  info.listener.Run(gin::ConvertToV8(isolate, details));
+  info.listener.Run(FillDetails(isolate, request_info, args...));
 }
 
 template <typename Out, typename... Args>
@@ -460,7 +815,8 @@ int WebRequest::HandleResponseEvent(ResponseEvent event,
                                     extensions::WebRequestInfo* request_info,
                                     net::CompletionOnceCallback callback,
                                     Out out,
-                                    Args... args) {
+                                    base::OnceClosure apply_rules,
+                                    const Args&... args) {
   const auto iter = response_listeners_.find(event);
   if (iter == std::end(response_listeners_))
     return net::OK;
@@ -473,19 +829,19 @@ int WebRequest::HandleResponseEvent(ResponseEvent event,
 
   v8::Isolate* isolate = JavascriptEnvironment::GetIsolate();
   v8::HandleScope handle_scope(isolate);
-  gin_helper::Dictionary details(isolate, v8::Object::New(isolate));
-  FillDetails(&details, request_info, args...);
+  v8::Local<v8::Value> details = FillDetails(isolate, request_info, args...);
 
   ResponseCallback response =
       base::BindOnce(&WebRequest::OnListenerResult<Out>, base::Unretained(this),
-                     request_info->id, out);
-  info.listener.Run(gin::ConvertToV8(isolate, details), std::move(response));
+                     request_info->id, out, std::move(apply_rules));
+  info.listener.Run(details, std::move(response));
   return net::ERR_IO_PENDING;
 }
 
 template <typename T>
 void WebRequest::OnListenerResult(uint64_t id,
                                   T out,
+                                  base::OnceClosure apply_rules,
                                   v8::Local<v8::Value> response) {
   const auto iter = callbacks_.find(id);
   if (iter == std::end(callbacks_))
@@ -503,6 +859,9 @@ void WebRequest::OnListenerResult(uint64_t id,
     else
       ReadFromResponse(isolate, &dict, out);
   }
+  // The request is still alive as long as its callback is.
+  if (result == net::OK && apply_rules)
+    std::move(apply_rules).Run();
 
   // The ProxyingURLLoaderFactory expects the callback to be executed
   // asynchronously, because it used to work on IO thread before NetworkService.
@@ -13,7 +13,9 @@
 #include "gin/arguments.h"
 #include "gin/handle.h"
 #include "gin/wrappable.h"
+#include "shell/browser/net/url_pattern_matcher.h"
 #include "shell/browser/net/web_request_api_interface.h"
+#include "shell/browser/net/web_request_rules.h"
 
 namespace content {
 class BrowserContext;
@@ -104,6 +106,8 @@ class WebRequest : public gin::Wrappable<WebRequest>, public WebRequestAPI {
   using ResponseListener =
       base::RepeatingCallback<void(v8::Local<v8::Value>, ResponseCallback)>;
 
+  void SetRules(gin::Arguments* args);
+
   template <SimpleEvent event>
   void SetSimpleListener(gin::Arguments* args);
   template <ResponseEvent event>
@@ -114,32 +118,49 @@ class WebRequest : public gin::Wrappable<WebRequest>, public WebRequestAPI {
   template <typename... Args>
   void HandleSimpleEvent(SimpleEvent event,
                          extensions::WebRequestInfo* info,
-                         Args... args);
+                         const Args&... args);
   template <typename Out, typename... Args>
   int HandleResponseEvent(ResponseEvent event,
                           extensions::WebRequestInfo* info,
                           net::CompletionOnceCallback callback,
                           Out out,
-                          Args... args);
+                          base::OnceClosure apply_rules,
+                          const Args&... args);
 
+  // |apply_rules| runs after the listener's changes are read, unless it
+  // cancelled the request.
   template <typename T>
-  void OnListenerResult(uint64_t id, T out, v8::Local<v8::Value> response);
+  void OnListenerResult(uint64_t id,
+                        T out,
+                        base::OnceClosure apply_rules,
+                        v8::Local<v8::Value> response);
+
+  void ApplyRequestHeaderRules(extensions::WebRequestInfo* info,
+                               net::HttpRequestHeaders* headers);
+  void ApplyResponseHeaderRules(
+      extensions::WebRequestInfo* info,
+      const net::HttpResponseHeaders* original_response_headers,
+      scoped_refptr<net::HttpResponseHeaders>* override_response_headers);
 
   struct SimpleListenerInfo {
-    std::set<URLPattern> url_patterns;
+    URLPatternMatcher url_patterns;
     SimpleListener listener;
 
-    SimpleListenerInfo(std::set<URLPattern>, SimpleListener);
+    SimpleListenerInfo(URLPatternMatcher, SimpleListener);
     SimpleListenerInfo();
+    SimpleListenerInfo(SimpleListenerInfo&&);
+    SimpleListenerInfo& operator=(SimpleListenerInfo&&);
     ~SimpleListenerInfo();
   };
 
   struct ResponseListenerInfo {
-    std::set<URLPattern> url_patterns;
+    URLPatternMatcher url_patterns;
     ResponseListener listener;
 
-    ResponseListenerInfo(std::set<URLPattern>, ResponseListener);
+    ResponseListenerInfo(URLPatternMatcher, ResponseListener);
     ResponseListenerInfo();
+    ResponseListenerInfo(ResponseListenerInfo&&);
+    ResponseListenerInfo& operator=(ResponseListenerInfo&&);
     ~ResponseListenerInfo();
   };
 
@@ -147,6 +168,11 @@ class WebRequest : public gin::Wrappable<WebRequest>, public WebRequestAPI {
   std::map<ResponseEvent, ResponseListenerInfo> response_listeners_;
   std::map<uint64_t, net::CompletionOnceCallback> callbacks_;
 
+  // Evaluated for every request without entering JS.
+  WebRequestRules rules_;
+  // How many times rules redirected each request, to break redirect cycles.
+  std::map<uint64_t, int> rule_redirects_;
+
   // Weak-ref, it manages us.
   content::BrowserContext* browser_context_;
 };
@@ -0,0 +1,199 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/api/frame_encoder.h"
+
+#include <string>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/bind_post_task.h"
+#include "base/memory/weak_ptr.h"
+#include "base/task/thread_pool.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "media/base/bitrate.h"
+#include "media/base/status.h"
+#include "media/base/video_codecs.h"
+#include "media/base/video_encoder.h"
+#include "media/base/video_frame.h"
+#include "media/media_buildflags.h"
+#include "ui/gfx/geometry/rect.h"
+
+#if BUILDFLAG(ENABLE_LIBVPX)
+#include "media/video/vpx_video_encoder.h"
+#endif
+
+#if BUILDFLAG(ENABLE_OPENH264)
+#include "media/video/openh264_video_encoder.h"
+#endif
+
+namespace electron {
+
+namespace api {
+
+// Owns the media::VideoEncoder, lives on the encoder sequence.
+class FrameEncoder::Core {
+ public:
+  Core(const Options& options,
+       const ChunkCallback& chunk_callback,
+       ErrorCallback error_callback)
+      : options_(options),
+        chunk_callback_(chunk_callback),
+        error_callback_(std::move(error_callback)) {}
+
+  // disable copy
+  Core(const Core&) = delete;
+  Core& operator=(const Core&) = delete;
+
+  void Encode(scoped_refptr<media::VideoFrame> frame,
+              const absl::optional<gfx::Rect>& damage) {
+    if (failed_)
+      return;
+
+    const gfx::Rect& visible_rect = frame->visible_rect();
+    bool key_frame = false;
+    if (!encoder_ || visible_rect.size() != frame_size_) {
+      Initialize(visible_rect.size());
+      key_frame = true;
+    } else if (damage && damage->IsEmpty()) {
+      return;
+    } else {
+      key_frame = frames_since_key_frame_ >= options_.key_frame_interval ||
+                  (damage && damage->Contains(visible_rect));
+    }
+    if (!encoder_)
+      return;
+
+    frames_since_key_frame_ = key_frame ? 0 : frames_since_key_frame_ + 1;
+    encoder_->Encode(std::move(frame), key_frame,
+                     base::BindOnce(&Core::OnStatus, weak_factory_.GetWeakPtr(),
+                                    std::string("Failed to encode frame")));
+  }
+
+ private:
+  void Initialize(const gfx::Size& frame_size) {
+    frame_size_ = frame_size;
+    encoder_.reset();
+
+    media::VideoCodecProfile profile = media::VIDEO_CODEC_PROFILE_UNKNOWN;
+    media::VideoEncoder::Options encoder_options;
+    encoder_options.frame_size = frame_size;
+    encoder_options.bitrate = media::Bitrate::ConstantBitrate(options_.bitrate);
+    encoder_options.keyframe_interval = options_.key_frame_interval;
+    encoder_options.latency_mode = media::VideoEncoder::LatencyMode::Realtime;
+    switch (options_.codec) {
+      case Codec::kVP8:
+      case Codec::kVP9:
+#if BUILDFLAG(ENABLE_LIBVPX)
+        profile = options_.codec == Codec::kVP8 ? media::VP8PROFILE_ANY
+                                                : media::VP9PROFILE_PROFILE0;
+        encoder_ = std::make_unique<media::VpxVideoEncoder>();
+#endif
+        break;
+      case Codec::kH264:
+#if BUILDFLAG(ENABLE_OPENH264)
+        profile = media::H264PROFILE_BASELINE;
+        encoder_options.avc.produce_annexb = true;
+        encoder_ = std::make_unique<media::OpenH264VideoEncoder>();
+#endif
+        break;
+    }
+    if (!encoder_) {
+      Fail("Encoder is not available");
+      return;
+    }
+
+    encoder_->Initialize(
+        profile, encoder_options,
+        base::BindRepeating(&Core::OnOutput, weak_factory_.GetWeakPtr()),
+        base::BindOnce(&Core::OnStatus, weak_factory_.GetWeakPtr(),
+                       std::string("Failed to initialize encoder")));
+  }
+
+  void OnStatus(const std::string& what, media::Status status) {
+    if (!status.is_ok())
+      Fail(what + ": " + status.message());
+  }
+
+  void Fail(const std::string& message) {
+    if (failed_)
+      return;
+    failed_ = true;
+    // Outputs and statuses of frames that are still pending are dropped. The
+    // encoder may be the one running this, so it is deleted later.
+    weak_factory_.InvalidateWeakPtrs();
+    if (encoder_) {
+      base::SequencedTaskRunnerHandle::Get()->DeleteSoon(FROM_HERE,
+                                                         std::move(encoder_));
+    }
+    std::move(error_callback_).Run(message);
+  }
+
+  void OnOutput(
+      media::VideoEncoderOutput output,
+      absl::optional<media::VideoEncoder::CodecDescription> description) {
+    Chunk chunk;
+    chunk.data = std::move(output.data);
+    chunk.size = output.size;
+    chunk.timestamp = output.timestamp;
+    chunk.key_frame = output.key_frame;
+    chunk_callback_.Run(std::move(chunk));
+  }
+
+  const Options options_;
+  ChunkCallback chunk_callback_;
+  ErrorCallback error_callback_;
+
+  std::unique_ptr<media::VideoEncoder> encoder_;
+  gfx::Size frame_size_;
+  int frames_since_key_frame_ = 0;
+  bool failed_ = false;
+
+  base::WeakPtrFactory<Core> weak_factory_{this};
+};
+
+FrameEncoder::Chunk::Chunk() = default;
+
+FrameEncoder::Chunk::Chunk(Chunk&&) = default;
+
+FrameEncoder::Chunk::~Chunk() = default;
+
+// static
+bool FrameEncoder::IsCodecSupported(Codec codec) {
+  switch (codec) {
+    case Codec::kVP8:
+    case Codec::kVP9:
+      return BUILDFLAG(ENABLE_LIBVPX);
+    case Codec::kH264:
+      return BUILDFLAG(ENABLE_OPENH264);
+  }
+  return false;
+}
+
+FrameEncoder::FrameEncoder(const Options& options,
+                           const ChunkCallback& chunk_callback,
+                           ErrorCallback error_callback)
+    : task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+          {base::TaskPriority::USER_VISIBLE,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})),
+      core_(new Core(options,
+                     base::BindPostTask(base::SequencedTaskRunnerHandle::Get(),
+                                        chunk_callback),
+                     base::BindPostTask(base::SequencedTaskRunnerHandle::Get(),
+                                        std::move(error_callback))),
+            base::OnTaskRunnerDeleter(task_runner_)) {}
+
+FrameEncoder::~FrameEncoder() = default;
+
+void FrameEncoder::Encode(scoped_refptr<media::VideoFrame> frame,
+                          const absl::optional<gfx::Rect>& damage) {
+  // |core_| is deleted on |task_runner_| after any task posted here.
+  task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&Core::Encode, base::Unretained(core_.get()),
+                                std::move(frame), damage));
+}
+
+}  // namespace api
+
+}  // namespace electron
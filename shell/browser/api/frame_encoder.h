@@ -0,0 +1,92 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ELECTRON_SHELL_BROWSER_API_FRAME_ENCODER_H_
+#define ELECTRON_SHELL_BROWSER_API_FRAME_ENCODER_H_
+
+#include <memory>
+#include <string>
+
+#include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/time/time.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+namespace gfx {
+class Rect;
+}  // namespace gfx
+
+namespace media {
+class VideoFrame;
+}  // namespace media
+
+namespace electron {
+
+namespace api {
+
+// Encodes captured frames with one of the software video encoders of media/
+// on the thread pool.
+class FrameEncoder {
+ public:
+  enum class Codec {
+    kVP8,
+    kVP9,
+    kH264,
+  };
+
+  struct Options {
+    Codec codec = Codec::kVP8;
+    // In bits per second.
+    uint32_t bitrate = 2500000;
+    // The most frames between two key frames.
+    int key_frame_interval = 300;
+  };
+
+  struct Chunk {
+    Chunk();
+    Chunk(Chunk&&);
+    ~Chunk();
+
+    std::unique_ptr<uint8_t[]> data;
+    size_t size = 0;
+    base::TimeDelta timestamp;
+    bool key_frame = false;
+  };
+
+  using ChunkCallback = base::RepeatingCallback<void(Chunk)>;
+  using ErrorCallback = base::OnceCallback<void(const std::string&)>;
+
+  static bool IsCodecSupported(Codec codec);
+
+  // The callbacks are run on the sequence the encoder is created on. After
+  // |error_callback| is run no more frames are encoded.
+  FrameEncoder(const Options& options,
+               const ChunkCallback& chunk_callback,
+               ErrorCallback error_callback);
+  ~FrameEncoder();
+
+  // disable copy
+  FrameEncoder(const FrameEncoder&) = delete;
+  FrameEncoder& operator=(const FrameEncoder&) = delete;
+
+  // Frames with an empty |damage| are skipped, and frames without one are
+  // encoded as if only part of them changed. A key frame is only produced for
+  // the first frame, when the size changes, when the whole frame is damaged,
+  // or after Options::key_frame_interval frames.
+  void Encode(scoped_refptr<media::VideoFrame> frame,
+              const absl::optional<gfx::Rect>& damage);
+
+ private:
+  class Core;
+
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  std::unique_ptr<Core, base::OnTaskRunnerDeleter> core_;
+};
+
+}  // namespace api
+
+}  // namespace electron
+
+#endif  // ELECTRON_SHELL_BROWSER_API_FRAME_ENCODER_H_
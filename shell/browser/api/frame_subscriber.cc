@@ -6,13 +6,18 @@
 
 #include <utility>
 
+#include "base/bind.h"
 #include "content/public/browser/render_view_host.h"
 #include "content/public/browser/render_widget_host.h"
 #include "content/public/browser/render_widget_host_view.h"
+#include "media/base/video_frame.h"
 #include "media/capture/mojom/video_capture_buffer.mojom.h"
 #include "media/capture/mojom/video_capture_types.mojom.h"
 #include "mojo/public/cpp/bindings/remote.h"
 #include "services/viz/privileged/mojom/compositing/frame_sink_video_capture.mojom-shared.h"
+#include "shell/browser/javascript_environment.h"
+#include "shell/common/gin_helper/dictionary.h"
+#include "shell/common/node_includes.h"
 #include "ui/gfx/geometry/size_conversions.h"
 #include "ui/gfx/image/image.h"
 #include "ui/gfx/skbitmap_operations.h"
@@ -34,6 +39,26 @@ FrameSubscriber::FrameSubscriber(content::WebContents* web_contents,
     AttachToHost(rvh->GetWidget());
 }
 
+FrameSubscriber::FrameSubscriber(content::WebContents* web_contents,
+                                 const FrameEncoder::Options& options,
+                                 const EncodedChunkCallback& callback,
+                                 EncodingErrorCallback error_callback)
+    : content::WebContentsObserver(web_contents),
+      encoded_chunk_callback_(callback),
+      encoding_error_callback_(std::move(error_callback)) {
+  // The encoder posts its results back to this sequence, where they may
+  // arrive after this subscriber is gone.
+  encoder_ = std::make_unique<FrameEncoder>(
+      options,
+      base::BindRepeating(&FrameSubscriber::OnEncodedChunk,
+                          weak_ptr_factory_.GetWeakPtr()),
+      base::BindOnce(&FrameSubscriber::OnEncodingError,
+                     weak_ptr_factory_.GetWeakPtr()));
+  content::RenderViewHost* rvh = web_contents->GetRenderViewHost();
+  if (rvh)
+    AttachToHost(rvh->GetWidget());
+}
+
 FrameSubscriber::~FrameSubscriber() = default;
 
 void FrameSubscriber::AttachToHost(content::RenderWidgetHost* host) {
@@ -50,7 +75,9 @@ void FrameSubscriber::AttachToHost(content::RenderWidgetHost* host) {
   video_capturer_->SetResolutionConstraints(size, size, true);
   video_capturer_->SetAutoThrottlingEnabled(false);
   video_capturer_->SetMinSizeChangePeriod(base::TimeDelta());
-  video_capturer_->SetFormat(media::PIXEL_FORMAT_ARGB);
+  // The encoders take I420, which the capturer can produce on the GPU.
+  video_capturer_->SetFormat(encoder_ ? media::PIXEL_FORMAT_I420
+                                      : media::PIXEL_FORMAT_ARGB);
   video_capturer_->SetMinCapturePeriod(base::Seconds(1) / kMaxFrameRate);
   video_capturer_->Start(this, viz::mojom::BufferFormatPreference::kDefault);
 }
@@ -114,6 +141,27 @@ void FrameSubscriber::OnFrameCaptured(
     return;
   }
 
+  if (encoder_) {
+    // Encode the shared memory in place, it is released when the encoder is
+    // done with the frame.
+    scoped_refptr<media::VideoFrame> frame =
+        media::VideoFrame::WrapExternalData(
+            info->pixel_format, info->coded_size, info->visible_rect,
+            info->visible_rect.size(),
+            static_cast<const uint8_t*>(mapping.memory()), mapping.size(),
+            info->timestamp);
+    if (!frame)
+      return;
+    frame->set_color_space(info->color_space);
+    frame->AddDestructionObserver(base::BindOnce(
+        [](base::ReadOnlySharedMemoryMapping mapping,
+           mojo::PendingRemote<viz::mojom::FrameSinkVideoConsumerFrameCallbacks>
+               releaser) {},
+        std::move(mapping), callbacks_remote.Unbind()));
+    encoder_->Encode(std::move(frame), info->metadata.capture_update_rect);
+    return;
+  }
+
   // The SkBitmap's pixels will be marked as immutable, but the installPixels()
   // API requires a non-const pointer. So, cast away the const.
   void* const pixels = const_cast<void*>(mapping.memory());
@@ -171,6 +219,36 @@ void FrameSubscriber::Done(const gfx::Rect& damage, const SkBitmap& frame) {
   callback_.Run(gfx::Image::CreateFrom1xBitmap(copy), damage);
 }
 
+void FrameSubscriber::OnEncodedChunk(FrameEncoder::Chunk chunk) {
+  v8::Isolate* isolate = JavascriptEnvironment::GetIsolate();
+  v8::HandleScope handle_scope(isolate);
+  // The Buffer takes over the encoder's output without copying it.
+  v8::Local<v8::Object> data;
+  if (!node::Buffer::New(
+           isolate, reinterpret_cast<char*>(chunk.data.release()), chunk.size,
+           [](char* data, void* hint) {
+             delete[] reinterpret_cast<uint8_t*>(data);
+           },
+           nullptr)
+           .ToLocal(&data))
+    return;
+
+  gin_helper::Dictionary dict = gin::Dictionary::CreateEmpty(isolate);
+  dict.Set("data", data);
+  dict.Set("timestamp", chunk.timestamp.InMillisecondsF());
+  dict.Set("keyFrame", chunk.key_frame);
+  encoded_chunk_callback_.Run(dict.GetHandle());
+}
+
+void FrameSubscriber::OnEncodingError(const std::string& message) {
+  v8::Isolate* isolate = JavascriptEnvironment::GetIsolate();
+  v8::HandleScope handle_scope(isolate);
+  if (encoding_error_callback_) {
+    std::move(encoding_error_callback_)
+        .Run(v8::Exception::Error(gin::StringToV8(isolate, message)));
+  }
+}
+
 gfx::Size FrameSubscriber::GetRenderViewSize() const {
   content::RenderWidgetHostView* view = host_->GetView();
   gfx::Size size = view->GetViewBounds().size();
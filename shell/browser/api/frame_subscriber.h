@@ -15,6 +15,7 @@
 #include "content/public/browser/web_contents_observer.h"
 #include "media/capture/mojom/video_capture_buffer.mojom-forward.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
+#include "shell/browser/api/frame_encoder.h"
 #include "v8/include/v8.h"
 
 namespace gfx {
@@ -34,9 +35,20 @@ class FrameSubscriber : public content::WebContentsObserver,
   using FrameCaptureCallback =
       base::RepeatingCallback<void(const gfx::Image&, const gfx::Rect&)>;
 
+  using EncodedChunkCallback =
+      base::RepeatingCallback<void(v8::Local<v8::Value>)>;
+  using EncodingErrorCallback =
+      base::OnceCallback<void(v8::Local<v8::Value>)>;
+
   FrameSubscriber(content::WebContents* web_contents,
                   const FrameCaptureCallback& callback,
                   bool only_dirty);
+  // Encodes the frames instead, and runs |callback| with each encoded chunk,
+  // or |error_callback| with an Error once encoding fails.
+  FrameSubscriber(content::WebContents* web_contents,
+                  const FrameEncoder::Options& options,
+                  const EncodedChunkCallback& callback,
+                  EncodingErrorCallback error_callback);
   ~FrameSubscriber() override;
 
   // disable copy
@@ -63,12 +75,18 @@ class FrameSubscriber : public content::WebContentsObserver,
   void OnLog(const std::string& message) override;
 
   void Done(const gfx::Rect& damage, const SkBitmap& frame);
+  void OnEncodedChunk(FrameEncoder::Chunk chunk);
+  void OnEncodingError(const std::string& message);
 
   // Get the pixel size of render view.
   gfx::Size GetRenderViewSize() const;
 
   FrameCaptureCallback callback_;
-  bool only_dirty_;
+  bool only_dirty_ = false;
+
+  std::unique_ptr<FrameEncoder> encoder_;
+  EncodedChunkCallback encoded_chunk_callback_;
+  EncodingErrorCallback encoding_error_callback_;
 
   content::RenderWidgetHost* host_;
   std::unique_ptr<viz::ClientFrameSinkVideoCapturer> video_capturer_;
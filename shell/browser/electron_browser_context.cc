@@ -44,6 +44,7 @@
 #include "shell/browser/electron_permission_manager.h"
 #include "shell/browser/net/resolve_proxy_helper.h"
 #include "shell/browser/pref_store_delegate.h"
+#include "shell/browser/preload_script_cache.h"
 #include "shell/browser/protocol_registry.h"
 #include "shell/browser/special_storage_policy.h"
 #include "shell/browser/ui/inspectable_web_contents.h"
@@ -106,6 +107,7 @@ ElectronBrowserContext::ElectronBrowserContext(const std::string& partition,
                                                base::DictionaryValue options)
     : storage_policy_(base::MakeRefCounted<SpecialStoragePolicy>()),
       protocol_registry_(base::WrapUnique(new ProtocolRegistry)),
+      preload_script_cache_(std::make_unique<PreloadScriptCache>()),
       in_memory_(in_memory),
       ssl_config_(network::mojom::SSLConfig::New()) {
   user_agent_ = ElectronBrowserClient::Get()->GetUserAgent();
@@ -44,6 +44,7 @@ class ElectronPermissionManager;
 class CookieChangeNotifier;
 class ResolveProxyHelper;
 class WebViewManager;
+class PreloadScriptCache;
 class ProtocolRegistry;
 
 class ElectronBrowserContext : public content::BrowserContext {
@@ -142,6 +143,10 @@ class ElectronBrowserContext : public content::BrowserContext {
     return protocol_registry_.get();
   }
 
+  PreloadScriptCache* preload_script_cache() const {
+    return preload_script_cache_.get();
+  }
+
   void SetSSLConfig(network::mojom::SSLConfigPtr config);
   network::mojom::SSLConfigPtr GetSSLConfig();
   void SetSSLConfigClient(mojo::Remote<network::mojom::SSLConfigClient> client);
@@ -169,6 +174,7 @@ class ElectronBrowserContext : public content::BrowserContext {
   scoped_refptr<storage::SpecialStoragePolicy> storage_policy_;
   std::unique_ptr<predictors::PreconnectManager> preconnect_manager_;
   std::unique_ptr<ProtocolRegistry> protocol_registry_;
+  std::unique_ptr<PreloadScriptCache> preload_script_cache_;
 
   std::string user_agent_;
   base::FilePath path_;
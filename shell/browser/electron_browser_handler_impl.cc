@@ -38,23 +38,28 @@ void ElectronBrowserHandlerImpl::OnConnectionError() {
   delete this;
 }
 
-void ElectronBrowserHandlerImpl::Message(bool internal,
-                                         const std::string& channel,
-                                         blink::CloneableMessage arguments) {
+void ElectronBrowserHandlerImpl::Message(
+    bool internal,
+    const std::string& channel,
+    blink::CloneableMessage arguments,
+    std::vector<base::ReadOnlySharedMemoryRegion> buffers) {
   api::WebContents* api_web_contents = api::WebContents::From(web_contents());
   if (api_web_contents) {
     api_web_contents->Message(internal, channel, std::move(arguments),
-                              GetRenderFrameHost());
+                              std::move(buffers), GetRenderFrameHost());
   }
 }
-void ElectronBrowserHandlerImpl::Invoke(bool internal,
-                                        const std::string& channel,
-                                        blink::CloneableMessage arguments,
-                                        InvokeCallback callback) {
+void ElectronBrowserHandlerImpl::Invoke(
+    bool internal,
+    const std::string& channel,
+    blink::CloneableMessage arguments,
+    std::vector<base::ReadOnlySharedMemoryRegion> buffers,
+    InvokeCallback callback) {
   api::WebContents* api_web_contents = api::WebContents::From(web_contents());
   if (api_web_contents) {
     api_web_contents->Invoke(internal, channel, std::move(arguments),
-                             std::move(callback), GetRenderFrameHost());
+                             std::move(buffers), std::move(callback),
+                             GetRenderFrameHost());
   }
 }
 
@@ -128,6 +133,25 @@ void ElectronBrowserHandlerImpl::DoGetZoomLevel(
   }
 }
 
+void ElectronBrowserHandlerImpl::SetPreloadCodeCache(
+    const base::FilePath& path,
+    mojo_base::BigBuffer data) {
+  api::WebContents* api_web_contents = api::WebContents::From(web_contents());
+  if (api_web_contents) {
+    api_web_contents->SetPreloadCodeCache(path, std::move(data),
+                                          GetRenderFrameHost());
+  }
+}
+
+void ElectronBrowserHandlerImpl::SetJs2cCodeCache(const std::string& id,
+                                                  mojo_base::BigBuffer data) {
+  api::WebContents* api_web_contents = api::WebContents::From(web_contents());
+  if (api_web_contents) {
+    api_web_contents->SetJs2cCodeCache(id, std::move(data),
+                                       GetRenderFrameHost());
+  }
+}
+
 content::RenderFrameHost* ElectronBrowserHandlerImpl::GetRenderFrameHost() {
   return content::RenderFrameHost::FromID(render_process_id_, render_frame_id_);
 }
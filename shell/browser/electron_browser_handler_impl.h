@@ -36,10 +36,12 @@ class ElectronBrowserHandlerImpl : public mojom::ElectronBrowser,
   // mojom::ElectronBrowser:
   void Message(bool internal,
                const std::string& channel,
-               blink::CloneableMessage arguments) override;
+               blink::CloneableMessage arguments,
+               std::vector<base::ReadOnlySharedMemoryRegion> buffers) override;
   void Invoke(bool internal,
               const std::string& channel,
               blink::CloneableMessage arguments,
+              std::vector<base::ReadOnlySharedMemoryRegion> buffers,
               InvokeCallback callback) override;
   void OnFirstNonEmptyLayout() override;
   void ReceivePostMessage(const std::string& channel,
@@ -57,6 +59,10 @@ class ElectronBrowserHandlerImpl : public mojom::ElectronBrowser,
       std::vector<mojom::DraggableRegionPtr> regions) override;
   void SetTemporaryZoomLevel(double level) override;
   void DoGetZoomLevel(DoGetZoomLevelCallback callback) override;
+  void SetPreloadCodeCache(const base::FilePath& path,
+                           mojo_base::BigBuffer data) override;
+  void SetJs2cCodeCache(const std::string& id,
+                        mojo_base::BigBuffer data) override;
 
   base::WeakPtr<ElectronBrowserHandlerImpl> GetWeakPtr() {
     return weak_factory_.GetWeakPtr();
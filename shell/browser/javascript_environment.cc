@@ -14,14 +14,17 @@
 #include "base/command_line.h"
 #include "base/feature_list.h"
 #include "base/task/current_thread.h"
-#include "base/task/thread_pool/initialization_util.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "base/trace_event/trace_event.h"
 #include "gin/array_buffer.h"
+#include "gin/public/v8_platform.h"
 #include "gin/v8_initializer.h"
 #include "shell/browser/microtasks_runner.h"
+#include "shell/browser/startup_snapshot.h"
+#include "shell/browser/thread_pool_platform.h"
 #include "shell/common/gin_helper/cleaned_up_at_exit.h"
 #include "shell/common/node_includes.h"
+#include "shell/common/options_switches.h"
 #include "third_party/blink/public/common/switches.h"
 
 namespace {
@@ -153,8 +156,9 @@ class ArrayBufferAllocator : public v8::ArrayBuffer::Allocator {
 
 base::NoDestructor<base::PartitionAllocator> ArrayBufferAllocator::allocator_{};
 
-JavascriptEnvironment::JavascriptEnvironment(uv_loop_t* event_loop)
-    : isolate_(Initialize(event_loop)),
+JavascriptEnvironment::JavascriptEnvironment(uv_loop_t* event_loop,
+                                             bool use_startup_snapshot)
+    : isolate_(Initialize(event_loop, use_startup_snapshot)),
       isolate_holder_(base::ThreadTaskRunnerHandle::Get(),
                       gin::IsolateHolder::kSingleThread,
                       gin::IsolateHolder::kAllowAtomicsWait,
@@ -162,7 +166,8 @@ JavascriptEnvironment::JavascriptEnvironment(uv_loop_t* event_loop)
                       gin::IsolateHolder::IsolateCreationMode::kNormal,
                       nullptr,
                       nullptr,
-                      isolate_),
+                      isolate_,
+                      startup_snapshot_ ? startup_snapshot_->data() : nullptr),
       locker_(isolate_) {
   isolate_->Enter();
   v8::HandleScope scope(isolate_);
@@ -328,7 +333,8 @@ class TracingControllerImpl : public node::tracing::TracingController {
   }
 };
 
-v8::Isolate* JavascriptEnvironment::Initialize(uv_loop_t* event_loop) {
+v8::Isolate* JavascriptEnvironment::Initialize(uv_loop_t* event_loop,
+                                               bool use_startup_snapshot) {
   auto* cmd = base::CommandLine::ForCurrentProcess();
 
   // --js-flags.
@@ -337,14 +343,14 @@ v8::Isolate* JavascriptEnvironment::Initialize(uv_loop_t* event_loop) {
   if (!js_flags.empty())
     v8::V8::SetFlagsFromString(js_flags.c_str(), js_flags.size());
 
-  // The V8Platform of gin relies on Chromium's task schedule, which has not
-  // been started at this point, so we have to rely on Node's V8Platform.
+  // Worker tasks go to Chromium's thread pool, which queues them until it is
+  // started. The foreground tasks run on the uv loops of Node.js.
   auto* tracing_agent = node::CreateAgent();
   auto* tracing_controller = new TracingControllerImpl();
   node::tracing::TraceEventHelper::SetAgent(tracing_agent);
-  platform_ = node::CreatePlatform(
-      base::RecommendedMaxNumberOfThreadsInThreadGroup(3, 8, 0.1, 0),
-      tracing_controller, gin::V8Platform::PageAllocator());
+  platform_ = CreateThreadPoolPlatform(tracing_controller,
+                                       gin::V8Platform::PageAllocator())
+                  .release();
 
   v8::V8::InitializePlatform(platform_);
   gin::IsolateHolder::Initialize(gin::IsolateHolder::kNonStrictMode,
@@ -352,6 +358,12 @@ v8::Isolate* JavascriptEnvironment::Initialize(uv_loop_t* event_loop) {
                                  nullptr /* external_reference_table */,
                                  js_flags, false /* create_v8_platform */);
 
+  // The default context of the snapshot becomes the context of the main
+  // process, node::NewContext keeps the globals the app set up in it. A new
+  // snapshot is always built from a clean heap.
+  if (use_startup_snapshot && !cmd->HasSwitch(switches::kBuildSnapshot))
+    startup_snapshot_ = StartupSnapshot::Load();
+
   v8::Isolate* isolate = v8::Isolate::Allocate();
   platform_->RegisterIsolate(isolate, event_loop);
   g_isolate = isolate;
@@ -19,10 +19,15 @@ class MultiIsolatePlatform;
 namespace electron {
 
 class MicrotasksRunner;
+class StartupSnapshot;
+
 // Manage the V8 isolate and context automatically.
 class JavascriptEnvironment {
  public:
-  explicit JavascriptEnvironment(uv_loop_t* event_loop);
+  // The isolate is created from the app's startup snapshot when there is one
+  // and |use_startup_snapshot| is true.
+  explicit JavascriptEnvironment(uv_loop_t* event_loop,
+                                 bool use_startup_snapshot = false);
   ~JavascriptEnvironment();
 
   // disable copy
@@ -41,10 +46,13 @@ class JavascriptEnvironment {
   static v8::Isolate* GetIsolate();
 
  private:
-  v8::Isolate* Initialize(uv_loop_t* event_loop);
+  v8::Isolate* Initialize(uv_loop_t* event_loop, bool use_startup_snapshot);
   // Leaked on exit.
   node::MultiIsolatePlatform* platform_;
 
+  // Has to outlive the isolate.
+  std::unique_ptr<StartupSnapshot> startup_snapshot_;
+
   v8::Isolate* isolate_;
   gin::IsolateHolder isolate_holder_;
   v8::Locker locker_;
@@ -0,0 +1,285 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/module_code_cache.h"
+
+#include <memory>
+#include <utility>
+
+#include "base/base_paths.h"
+#include "base/bind.h"
+#include "base/callback_helpers.h"
+#include "base/command_line.h"
+#include "base/containers/cxx20_erase.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/logging.h"
+#include "base/no_destructor.h"
+#include "base/path_service.h"
+#include "base/pickle.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/task/thread_pool.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/timer/elapsed_timer.h"
+#include "crypto/sha2.h"
+#include "electron/fuses.h"
+#include "gin/converter.h"
+#include "shell/common/application_info.h"
+#include "shell/common/asar/archive.h"
+#include "shell/common/asar/asar_util.h"
+#include "shell/common/options_switches.h"
+
+namespace electron {
+
+namespace {
+
+constexpr uint32_t kFormatVersion = 1;
+
+// Entries that were not used by this many launches in a row are dropped.
+constexpr uint32_t kMaxIdleLaunches = 5;
+
+// Code caches are created once no module was compiled for this long.
+constexpr base::TimeDelta kFlushDelay = base::Seconds(10);
+
+// Serializing code caches has to happen on the thread of the isolate, so it is
+// done in slices of this length to keep the thread responsive.
+constexpr base::TimeDelta kFlushSliceDuration = base::Milliseconds(5);
+
+base::FilePath GetCacheFilePath() {
+  // This is where DIR_USER_CACHE points to, which is not used as the app can
+  // still change its name after the first module was loaded.
+#if defined(OS_POSIX)
+  int parent_key = base::DIR_CACHE;
+#else
+  int parent_key = base::DIR_ROAMING_APP_DATA;
+#endif
+  base::FilePath path;
+  if (!base::PathService::Get(parent_key, &path))
+    return base::FilePath();
+  std::string name = GetPossiblyOverriddenApplicationName();
+  return path.Append(base::FilePath::FromUTF8Unsafe(name))
+      .Append(FILE_PATH_LITERAL("Module Code Cache"));
+}
+
+// Returns the id of the module at |path|, and whether its source has to be
+// checked against the hash of an entry with that id.
+//
+// Only the files of an asar archive with integrity hashes can be identified by
+// the archive's header, which then covers their contents. The header says
+// nothing about the contents of other files.
+std::string GetModuleId(const base::FilePath& path, bool* check_source) {
+  base::FilePath asar_path, relative_path;
+  if (asar::GetAsarArchivePath(path, &asar_path, &relative_path)) {
+    std::shared_ptr<asar::Archive> archive =
+        asar::GetOrCreateAsarArchive(asar_path);
+    asar::Archive::FileInfo info;
+    if (archive && archive->GetFileInfo(relative_path, &info) &&
+        !info.unpacked && info.integrity) {
+      *check_source = false;
+      const std::string& header_hash = archive->header_hash();
+      return base::StrCat(
+          {"asar:", base::HexEncode(header_hash.data(), header_hash.size()),
+           ":", base::NumberToString(info.offset)});
+    }
+  }
+  *check_source = true;
+  return "file:" + path.AsUTF8Unsafe();
+}
+
+std::string HashSource(v8::Isolate* isolate, v8::Local<v8::String> source) {
+  return crypto::SHA256HashString(gin::V8ToString(isolate, source));
+}
+
+}  // namespace
+
+ModuleCodeCache::Entry::Entry() = default;
+ModuleCodeCache::Entry::Entry(const Entry&) = default;
+ModuleCodeCache::Entry::~Entry() = default;
+
+ModuleCodeCache::CompiledModule::CompiledModule() = default;
+ModuleCodeCache::CompiledModule::CompiledModule(CompiledModule&&) = default;
+ModuleCodeCache::CompiledModule::~CompiledModule() = default;
+
+// static
+ModuleCodeCache* ModuleCodeCache::GetInstance() {
+  static base::NoDestructor<ModuleCodeCache> instance(GetCacheFilePath());
+  return instance.get();
+}
+
+// static
+bool ModuleCodeCache::IsEnabled() {
+  return !base::CommandLine::ForCurrentProcess()->HasSwitch(
+             switches::kDisableModuleCodeCache) &&
+         !fuses::IsEmbeddedAsarIntegrityValidationEnabled();
+}
+
+ModuleCodeCache::ModuleCodeCache(const base::FilePath& path)
+    : path_(path),
+      file_task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+          {base::MayBlock(), base::TaskPriority::BEST_EFFORT,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})) {
+  ReadCacheFile();
+}
+
+ModuleCodeCache::~ModuleCodeCache() = default;
+
+scoped_refptr<base::RefCountedBytes> ModuleCodeCache::Get(
+    v8::Isolate* isolate,
+    const base::FilePath& path,
+    v8::Local<v8::String> source) {
+  bool check_source;
+  auto it = entries_.find(GetModuleId(path, &check_source));
+  if (it == entries_.end())
+    return nullptr;
+  if (check_source && it->second.source_hash != HashSource(isolate, source))
+    return nullptr;
+  it->second.last_used = launch_;
+  return it->second.data;
+}
+
+void ModuleCodeCache::AddCompiledModule(v8::Isolate* isolate,
+                                        const base::FilePath& path,
+                                        v8::Local<v8::String> source,
+                                        v8::Local<v8::Function> function) {
+  bool check_source;
+  CompiledModule module;
+  module.id = GetModuleId(path, &check_source);
+  if (check_source)
+    module.source_hash = HashSource(isolate, source);
+  module.function.Reset(isolate, function);
+  compiled_modules_.push_back(std::move(module));
+
+  // Restarting the timer for every module delays the work until the burst of
+  // module loads during startup is over.
+  flush_timer_.Start(FROM_HERE, kFlushDelay,
+                     base::BindOnce(&ModuleCodeCache::Flush,
+                                    weak_factory_.GetWeakPtr(), isolate,
+                                    base::DoNothing()));
+}
+
+void ModuleCodeCache::Flush(v8::Isolate* isolate, base::OnceClosure callback) {
+  flush_timer_.Stop();
+
+  // CreateCodeCacheForFunction serializes the bytecode the module already
+  // has, without compiling it again, but that still takes a while for large
+  // apps. The rest of the modules is left to a later task once a slice is
+  // used up.
+  base::ElapsedTimer timer;
+  {
+    v8::HandleScope handle_scope(isolate);
+    while (!compiled_modules_.empty()) {
+      if (timer.Elapsed() >= kFlushSliceDuration) {
+        base::SequencedTaskRunnerHandle::Get()->PostTask(
+            FROM_HERE,
+            base::BindOnce(&ModuleCodeCache::Flush,
+                           weak_factory_.GetWeakPtr(), isolate,
+                           std::move(callback)));
+        return;
+      }
+      CompiledModule module = std::move(compiled_modules_.back());
+      compiled_modules_.pop_back();
+      std::unique_ptr<v8::ScriptCompiler::CachedData> cache(
+          v8::ScriptCompiler::CreateCodeCacheForFunction(
+              module.function.Get(isolate)));
+      if (!cache || cache->length <= 0)
+        continue;
+      Entry& entry = entries_[module.id];
+      entry.source_hash = std::move(module.source_hash);
+      entry.data = base::MakeRefCounted<base::RefCountedBytes>(
+          cache->data, static_cast<size_t>(cache->length));
+      entry.last_used = launch_;
+    }
+  }
+
+  base::EraseIf(entries_, [this](const auto& it) {
+    return launch_ - it.second.last_used >= kMaxIdleLaunches;
+  });
+
+  if (path_.empty()) {
+    std::move(callback).Run();
+    return;
+  }
+  // The entries share their data with the copy that is written.
+  file_task_runner_->PostTaskAndReply(
+      FROM_HERE,
+      base::BindOnce(&ModuleCodeCache::WriteCacheFile, path_,
+                     v8::ScriptCompiler::CachedDataVersionTag(), launch_,
+                     entries_),
+      std::move(callback));
+}
+
+void ModuleCodeCache::Prune(v8::Isolate* isolate, base::OnceClosure callback) {
+  base::EraseIf(entries_, [this](const auto& it) {
+    return it.second.last_used != launch_;
+  });
+  Flush(isolate, std::move(callback));
+}
+
+// static
+void ModuleCodeCache::WriteCacheFile(
+    const base::FilePath& path,
+    uint32_t version_tag,
+    uint32_t launch,
+    const std::map<std::string, Entry>& entries) {
+  base::Pickle pickle;
+  pickle.WriteUInt32(kFormatVersion);
+  pickle.WriteUInt32(version_tag);
+  pickle.WriteUInt32(launch);
+  pickle.WriteUInt32(entries.size());
+  for (const auto& it : entries) {
+    pickle.WriteString(it.first);
+    pickle.WriteString(it.second.source_hash);
+    pickle.WriteUInt32(it.second.last_used);
+    pickle.WriteData(reinterpret_cast<const char*>(it.second.data->front()),
+                     it.second.data->size());
+  }
+
+  if (!base::CreateDirectory(path.DirName()) ||
+      !base::ImportantFileWriter::WriteFileAtomically(
+          path, base::StringPiece(static_cast<const char*>(pickle.data()),
+                                  pickle.size()))) {
+    LOG(WARNING) << "Failed to write the module code cache to "
+                 << path.value();
+  }
+}
+
+void ModuleCodeCache::ReadCacheFile() {
+  // The modules of the app are loaded right after this, and need the cache.
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  std::string contents;
+  if (path_.empty() || !base::ReadFileToString(path_, &contents))
+    return;
+
+  // The whole cache is dropped when V8's version or flags changed, as V8
+  // would reject every entry anyway.
+  base::Pickle pickle(contents.data(), contents.size());
+  base::PickleIterator iter(pickle);
+  uint32_t version, version_tag, launch, count;
+  if (!iter.ReadUInt32(&version) || version != kFormatVersion ||
+      !iter.ReadUInt32(&version_tag) ||
+      version_tag != v8::ScriptCompiler::CachedDataVersionTag() ||
+      !iter.ReadUInt32(&launch) || !iter.ReadUInt32(&count))
+    return;
+
+  std::map<std::string, Entry> entries;
+  for (uint32_t i = 0; i < count; ++i) {
+    std::string id;
+    Entry entry;
+    const char* data;
+    int length;
+    if (!iter.ReadString(&id) || !iter.ReadString(&entry.source_hash) ||
+        !iter.ReadUInt32(&entry.last_used) || !iter.ReadData(&data, &length))
+      return;
+    entry.data = base::MakeRefCounted<base::RefCountedBytes>(
+        reinterpret_cast<const uint8_t*>(data), length);
+    entries[id] = std::move(entry);
+  }
+
+  launch_ = launch + 1;
+  entries_ = std::move(entries);
+}
+
+}  // namespace electron
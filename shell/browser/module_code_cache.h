@@ -0,0 +1,116 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ELECTRON_SHELL_BROWSER_MODULE_CODE_CACHE_H_
+#define ELECTRON_SHELL_BROWSER_MODULE_CODE_CACHE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/timer/timer.h"
+#include "v8/include/v8.h"
+
+namespace electron {
+
+// Keeps the V8 code caches of the CommonJS modules loaded by the main process
+// in a file, so that later launches do not parse and compile them again.
+//
+// A module in an asar archive that has integrity hashes is identified by the
+// hash of the archive's header and its offset in the archive, which needs no
+// access to its source. Other modules are identified by their path and
+// validated against a hash of their source.
+//
+// The code caches of the modules compiled without one are created once no
+// module has been compiled for a while, so that they include the functions
+// that ran during startup. They are created in short tasks and written on a
+// background thread.
+class ModuleCodeCache {
+ public:
+  // Returns the cache of the app, which reads its file on the first call.
+  static ModuleCodeCache* GetInstance();
+
+  // Whether the cache is used at all. It is not when disabled on the command
+  // line, nor when the integrity of the app's asar archive is validated, since
+  // code caches are not covered by that validation.
+  static bool IsEnabled();
+
+  explicit ModuleCodeCache(const base::FilePath& path);
+  ~ModuleCodeCache();
+
+  // disable copy
+  ModuleCodeCache(const ModuleCodeCache&) = delete;
+  ModuleCodeCache& operator=(const ModuleCodeCache&) = delete;
+
+  // Returns the code cache of the module at |path|, or nullptr.
+  scoped_refptr<base::RefCountedBytes> Get(v8::Isolate* isolate,
+                                           const base::FilePath& path,
+                                           v8::Local<v8::String> source);
+
+  // Remembers |function|, the module at |path| that was compiled without a
+  // usable code cache, and schedules the creation of its code cache.
+  void AddCompiledModule(v8::Isolate* isolate,
+                         const base::FilePath& path,
+                         v8::Local<v8::String> source,
+                         v8::Local<v8::Function> function);
+
+  // Creates the code caches of the modules compiled so far, spread over
+  // several tasks, and writes the cache file. |callback| runs once it is
+  // written.
+  void Flush(v8::Isolate* isolate, base::OnceClosure callback);
+
+  // Drops the code caches of the modules that were not loaded since launch
+  // and writes the cache file.
+  void Prune(v8::Isolate* isolate, base::OnceClosure callback);
+
+ private:
+  struct Entry {
+    Entry();
+    Entry(const Entry&);
+    ~Entry();
+
+    std::string source_hash;
+    scoped_refptr<base::RefCountedBytes> data;
+    // The launch the entry was last used in.
+    uint32_t last_used = 0;
+  };
+
+  struct CompiledModule {
+    CompiledModule();
+    CompiledModule(CompiledModule&&);
+    ~CompiledModule();
+
+    std::string id;
+    std::string source_hash;
+    v8::Global<v8::Function> function;
+  };
+
+  static void WriteCacheFile(const base::FilePath& path,
+                             uint32_t version_tag,
+                             uint32_t launch,
+                             const std::map<std::string, Entry>& entries);
+
+  void ReadCacheFile();
+
+  const base::FilePath path_;
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+
+  // Increases with every launch that reads the cache file.
+  uint32_t launch_ = 0;
+  std::map<std::string, Entry> entries_;
+  std::vector<CompiledModule> compiled_modules_;
+  base::OneShotTimer flush_timer_;
+
+  base::WeakPtrFactory<ModuleCodeCache> weak_factory_{this};
+};
+
+}  // namespace electron
+
+#endif  // ELECTRON_SHELL_BROWSER_MODULE_CODE_CACHE_H_
@@ -0,0 +1,121 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/module_code_cache.h"
+
+#include <string>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/run_loop.h"
+#include "gin/converter.h"
+#include "gin/test/v8_test.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace electron {
+
+class ModuleCodeCacheTest : public gin::V8Test {
+ protected:
+  void SetUp() override {
+    gin::V8Test::SetUp();
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    cache_path_ = temp_dir_.GetPath().AppendASCII("Module Code Cache");
+    module_path_ = temp_dir_.GetPath().AppendASCII("module.js");
+  }
+
+  v8::Isolate* isolate() { return instance_->isolate(); }
+
+  // Compiles |source| the way the module loader wraps a module.
+  v8::Local<v8::Function> Compile(v8::Local<v8::String> source) {
+    v8::Local<v8::Context> context = context_.Get(isolate());
+    v8::Local<v8::Script> script =
+        v8::Script::Compile(context, source).ToLocalChecked();
+    return script->Run(context).ToLocalChecked().As<v8::Function>();
+  }
+
+  void Flush(ModuleCodeCache* cache) {
+    base::RunLoop run_loop;
+    cache->Flush(isolate(), run_loop.QuitClosure());
+    run_loop.Run();
+  }
+
+  base::ScopedTempDir temp_dir_;
+  base::FilePath cache_path_;
+  base::FilePath module_path_;
+};
+
+TEST_F(ModuleCodeCacheTest, CachesCompiledModules) {
+  v8::HandleScope handle_scope(isolate());
+  v8::Context::Scope context_scope(context_.Get(isolate()));
+  v8::Local<v8::String> source =
+      gin::StringToV8(isolate(), "(function () { return 42; })");
+
+  ModuleCodeCache cache(cache_path_);
+  EXPECT_FALSE(cache.Get(isolate(), module_path_, source));
+  cache.AddCompiledModule(isolate(), module_path_, source, Compile(source));
+  Flush(&cache);
+
+  EXPECT_TRUE(cache.Get(isolate(), module_path_, source));
+  EXPECT_TRUE(base::PathExists(cache_path_));
+}
+
+TEST_F(ModuleCodeCacheTest, PersistsAcrossInstances) {
+  v8::HandleScope handle_scope(isolate());
+  v8::Context::Scope context_scope(context_.Get(isolate()));
+  v8::Local<v8::String> source =
+      gin::StringToV8(isolate(), "(function () { return 42; })");
+
+  {
+    ModuleCodeCache cache(cache_path_);
+    cache.AddCompiledModule(isolate(), module_path_, source, Compile(source));
+    Flush(&cache);
+  }
+
+  ModuleCodeCache cache(cache_path_);
+  scoped_refptr<base::RefCountedBytes> data =
+      cache.Get(isolate(), module_path_, source);
+  ASSERT_TRUE(data);
+  EXPECT_GT(data->size(), 0u);
+}
+
+TEST_F(ModuleCodeCacheTest, InvalidatesChangedSource) {
+  v8::HandleScope handle_scope(isolate());
+  v8::Context::Scope context_scope(context_.Get(isolate()));
+  v8::Local<v8::String> source =
+      gin::StringToV8(isolate(), "(function () { return 42; })");
+  v8::Local<v8::String> changed_source =
+      gin::StringToV8(isolate(), "(function () { return 43; })");
+
+  {
+    ModuleCodeCache cache(cache_path_);
+    cache.AddCompiledModule(isolate(), module_path_, source, Compile(source));
+    Flush(&cache);
+  }
+
+  ModuleCodeCache cache(cache_path_);
+  EXPECT_FALSE(cache.Get(isolate(), module_path_, changed_source));
+  const base::FilePath other_path = temp_dir_.GetPath().AppendASCII("other.js");
+  EXPECT_FALSE(cache.Get(isolate(), other_path, source));
+}
+
+TEST_F(ModuleCodeCacheTest, IgnoresCorruptFile) {
+  v8::HandleScope handle_scope(isolate());
+  v8::Context::Scope context_scope(context_.Get(isolate()));
+  v8::Local<v8::String> source =
+      gin::StringToV8(isolate(), "(function () { return 42; })");
+
+  {
+    ModuleCodeCache cache(cache_path_);
+    cache.AddCompiledModule(isolate(), module_path_, source, Compile(source));
+    Flush(&cache);
+  }
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(cache_path_, &contents));
+  ASSERT_TRUE(base::WriteFile(cache_path_, contents.substr(0, 20)));
+
+  ModuleCodeCache cache(cache_path_);
+  EXPECT_FALSE(cache.Get(isolate(), module_path_, source));
+}
+
+}  // namespace electron
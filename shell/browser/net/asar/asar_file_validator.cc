@@ -9,14 +9,67 @@
 #include <utility>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/logging.h"
+#include "base/memory/ptr_util.h"
 #include "base/notreached.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "base/task/thread_pool.h"
 #include "crypto/sha2.h"
 
 namespace asar {
 
+namespace {
+
+// Below this many blocks the thread hops cost more than they save.
+constexpr int kMinBlocksForParallelHashing = 2;
+
+// How many blocks are read ahead of the consumer. Each block is held in
+// memory until it is handed out.
+constexpr int kMaxBlocksInFlight = 4;
+
+// Copies the block at |offset| out of the mapping of |archive| and checks the
+// copy against |expected_hash|, so the bytes handed on are the ones that
+// matched, even if the archive is modified in the meantime.
+std::vector<char> ReadAndVerifyBlock(std::shared_ptr<Archive> archive,
+                                     uint64_t offset,
+                                     uint64_t size,
+                                     const std::string& expected_hash) {
+  const uint64_t generation = archive->RevalidateIntegrityCache();
+  const bool verified = archive->IsIntegrityVerified(offset, size);
+
+  base::span<const uint8_t> mapped_file = archive->GetMappedFile();
+  if (offset > mapped_file.size() || size > mapped_file.size() - offset) {
+    LOG(FATAL) << "Failed to read ASAR file block at offset " << offset;
+    return {};
+  }
+  const auto bytes = mapped_file.subspan(offset, size);
+  std::vector<char> block(bytes.begin(), bytes.end());
+
+  // A block verified earlier is only trusted if the archive did not change
+  // while it was copied.
+  if (verified && archive->RevalidateIntegrityCache() == generation)
+    return block;
+
+  // BoringSSL picks the SHA extensions or SIMD implementation of SHA-256 the
+  // CPU supports at runtime.
+  const auto actual =
+      crypto::SHA256Hash(base::as_bytes(base::make_span(block)));
+  const std::string actual_hex_hash =
+      base::ToLowerASCII(base::HexEncode(actual.data(), actual.size()));
+  if (expected_hash != actual_hex_hash) {
+    LOG(FATAL) << "Failed to validate block while hashing ASAR file at offset "
+               << offset;
+    return {};
+  }
+
+  archive->MarkIntegrityVerified(offset, size, generation);
+  return block;
+}
+
+}  // namespace
+
 AsarFileValidator::AsarFileValidator(IntegrityPayload integrity,
                                      base::File file)
     : file_(std::move(file)), integrity_(std::move(integrity)) {
@@ -24,13 +77,26 @@ AsarFileValidator::AsarFileValidator(IntegrityPayload integrity,
   max_block_ = integrity_.blocks.size() - 1;
 }
 
+AsarFileValidator::AsarFileValidator(IntegrityPayload integrity,
+                                     base::span<const uint8_t> mapped_file)
+    : mapped_file_(mapped_file), integrity_(std::move(integrity)) {
+  current_block_ = 0;
+  max_block_ = integrity_.blocks.size() - 1;
+}
+
 AsarFileValidator::~AsarFileValidator() = default;
 
 void AsarFileValidator::OnRead(base::span<char> buffer,
                                mojo::FileDataSource::ReadResult* result) {
-  DCHECK(!done_reading_);
+  HashData(buffer.data(), result->bytes_read);
+}
 
-  uint64_t buffer_size = result->bytes_read;
+void AsarFileValidator::OnSkippedData(base::span<const uint8_t> data) {
+  HashData(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+void AsarFileValidator::HashData(const char* data, uint64_t buffer_size) {
+  DCHECK(!done_reading_);
 
   // Compute how many bytes we should hash, and add them to the current hash.
   uint32_t block_size = integrity_.block_size;
@@ -42,17 +108,38 @@ void AsarFileValidator::OnRead(base::span<char> buffer,
       return;
     }
 
-    // Create a hash if we don't have one yet
-    if (!current_hash_) {
+    // Create a hash if we don't have one yet, unless this block has already
+    // been verified in which case its bytes are only counted. The archive is
+    // checked for modifications before every chunk that would be skipped.
+    bool block_started = false;
+    if (!current_hash_ && !skipping_block_) {
+      block_started = true;
       current_hash_byte_count_ = 0;
-      switch (integrity_.algorithm) {
-        case HashAlgorithm::SHA256:
-          current_hash_ =
-              crypto::SecureHash::Create(crypto::SecureHash::SHA256);
-          break;
-        case HashAlgorithm::NONE:
-          CHECK(false);
-          break;
+      if (IsParallelBlock()) {
+        skipping_block_ = true;
+      } else if (archive_) {
+        cache_generation_ = archive_->RevalidateIntegrityCache();
+        skipping_block_ = archive_->IsIntegrityVerified(CurrentBlockOffset(),
+                                                        CurrentBlockLength());
+      }
+    }
+    if (!current_hash_ && !skipping_block_)
+      CreateHash();
+
+    // A skipped block is only trusted while the archive is unchanged. Once it
+    // changed, the block is hashed after all, starting with the bytes that
+    // were skipped so far.
+    if (skipping_block_ && !block_started && archive_ && !IsParallelBlock()) {
+      uint64_t generation = archive_->RevalidateIntegrityCache();
+      if (generation != cache_generation_) {
+        skipping_block_ = false;
+        cache_generation_ = generation;
+        CreateHash();
+        if (!HashFromFile(read_start_ + total_hash_byte_count_ - extra_read_ -
+                              current_hash_byte_count_,
+                          current_hash_byte_count_)) {
+          return;
+        }
       }
     }
 
@@ -62,7 +149,8 @@ void AsarFileValidator::OnRead(base::span<char> buffer,
     int bytes_to_hash = std::min(block_size - current_hash_byte_count_,
                                  buffer_size - bytes_added);
     DCHECK_GT(bytes_to_hash, 0);
-    current_hash_->Update(buffer.data() + bytes_added, bytes_to_hash);
+    if (!skipping_block_)
+      current_hash_->Update(data + bytes_added, bytes_to_hash);
     bytes_added += bytes_to_hash;
     current_hash_byte_count_ += bytes_to_hash;
     total_hash_byte_count_ += bytes_to_hash;
@@ -75,6 +163,39 @@ void AsarFileValidator::OnRead(base::span<char> buffer,
   }
 }
 
+void AsarFileValidator::CreateHash() {
+  switch (integrity_.algorithm) {
+    case HashAlgorithm::SHA256:
+      current_hash_ = crypto::SecureHash::Create(crypto::SecureHash::SHA256);
+      break;
+    case HashAlgorithm::NONE:
+      CHECK(false);
+      break;
+  }
+}
+
+bool AsarFileValidator::HashFromFile(uint64_t offset, uint64_t size) {
+  if (size == 0)
+    return true;
+  if (!mapped_file_.empty()) {
+    // Hash the bytes in place rather than copying them out.
+    if (offset > mapped_file_.size() || size > mapped_file_.size() - offset) {
+      LOG(FATAL) << "Failed to read required portion of streamed ASAR archive";
+      return false;
+    }
+    current_hash_->Update(mapped_file_.data() + offset, size);
+    return true;
+  }
+
+  std::vector<uint8_t> abandoned_buffer(size);
+  if (!file_.ReadAndCheck(offset, abandoned_buffer)) {
+    LOG(FATAL) << "Failed to read required portion of streamed ASAR archive";
+    return false;
+  }
+  current_hash_->Update(abandoned_buffer.data(), size);
+  return true;
+}
+
 bool AsarFileValidator::FinishBlock() {
   if (current_hash_byte_count_ == 0) {
     if (!done_reading_ || current_block_ > max_block_) {
@@ -82,6 +203,16 @@ bool AsarFileValidator::FinishBlock() {
     }
   }
 
+  if (skipping_block_ || IsParallelBlock()) {
+    // The block was verified by an earlier read of the same archive, or is
+    // being hashed on the thread pool, so there is nothing to hash, not even
+    // the bytes the data producer never read.
+    skipping_block_ = false;
+    current_hash_byte_count_ = 0;
+    current_block_++;
+    return true;
+  }
+
   if (!current_hash_) {
     // This happens when we fail to read the resource. Compute empty content's
     // hash in this case.
@@ -89,6 +220,7 @@ bool AsarFileValidator::FinishBlock() {
   }
 
   uint8_t actual[crypto::kSHA256Length];
+  uint64_t hashed_byte_count = current_hash_byte_count_;
 
   // If the file reader is done we need to make sure we've either read up to the
   // end of the file (the check below) or up to the end of a block_size byte
@@ -102,13 +234,9 @@ bool AsarFileValidator::FinishBlock() {
         integrity_.block_size - current_hash_byte_count_,
         read_max_ - read_start_ - total_hash_byte_count_ + extra_read_);
     uint64_t offset = read_start_ + total_hash_byte_count_ - extra_read_;
-    std::vector<uint8_t> abandoned_buffer(bytes_needed);
-    if (!file_.ReadAndCheck(offset, abandoned_buffer)) {
-      LOG(FATAL) << "Failed to read required portion of streamed ASAR archive";
+    if (!HashFromFile(offset, bytes_needed))
       return false;
-    }
-
-    current_hash_->Update(&abandoned_buffer.front(), bytes_needed);
+    hashed_byte_count += bytes_needed;
   }
 
   current_hash_->Finish(actual, sizeof(actual));
@@ -123,6 +251,13 @@ bool AsarFileValidator::FinishBlock() {
     return false;
   }
 
+  // Only the bytes that were hashed are recorded, which are fewer than a
+  // block at the end of the file.
+  if (archive_) {
+    archive_->MarkIntegrityVerified(CurrentBlockOffset(), hashed_byte_count,
+                                    cache_generation_);
+  }
+
   current_block_++;
 
   return true;
@@ -149,4 +284,117 @@ void AsarFileValidator::SetCurrentBlock(int current_block) {
   current_block_ = current_block;
 }
 
+void AsarFileValidator::SetFirstParallelBlock(int first_parallel_block) {
+  first_parallel_block_ = first_parallel_block;
+}
+
+void AsarFileValidator::SetVerificationCache(Archive* archive,
+                                             uint64_t file_offset,
+                                             uint64_t file_size) {
+  archive_ = archive;
+  file_offset_ = file_offset;
+  file_size_ = file_size;
+}
+
+uint64_t AsarFileValidator::CurrentBlockOffset() const {
+  return file_offset_ +
+         static_cast<uint64_t>(current_block_) * integrity_.block_size;
+}
+
+bool AsarFileValidator::IsParallelBlock() const {
+  return current_block_ >= first_parallel_block_;
+}
+
+uint64_t AsarFileValidator::CurrentBlockLength() const {
+  const uint64_t block_start =
+      static_cast<uint64_t>(current_block_) * integrity_.block_size;
+  if (block_start >= file_size_)
+    return 0;
+  return std::min<uint64_t>(integrity_.block_size, file_size_ - block_start);
+}
+
+// static
+std::unique_ptr<ParallelBlockReader> ParallelBlockReader::Create(
+    std::shared_ptr<Archive> archive,
+    const IntegrityPayload& integrity,
+    uint64_t file_offset,
+    uint64_t file_size,
+    int first_block,
+    int last_block) {
+  const int block_count = integrity.blocks.size();
+  if (integrity.algorithm != HashAlgorithm::SHA256 ||
+      integrity.block_size == 0 || first_block < 0 ||
+      last_block >= block_count ||
+      static_cast<uint64_t>(last_block) * integrity.block_size >= file_size ||
+      last_block - first_block + 1 < kMinBlocksForParallelHashing ||
+      archive->GetMappedFile().empty())
+    return nullptr;
+
+  return base::WrapUnique(new ParallelBlockReader(std::move(archive), integrity,
+                                                  file_offset, file_size,
+                                                  first_block, last_block));
+}
+
+ParallelBlockReader::ParallelBlockReader(std::shared_ptr<Archive> archive,
+                                         const IntegrityPayload& integrity,
+                                         uint64_t file_offset,
+                                         uint64_t file_size,
+                                         int first_block,
+                                         int last_block)
+    : archive_(std::move(archive)),
+      integrity_(integrity),
+      file_offset_(file_offset),
+      file_size_(file_size),
+      next_block_(first_block),
+      next_block_to_read_(first_block),
+      last_block_(last_block) {
+  ReadAhead();
+}
+
+ParallelBlockReader::~ParallelBlockReader() = default;
+
+void ParallelBlockReader::ReadNextBlock(BlockCallback callback) {
+  DCHECK(HasNextBlock());
+  DCHECK(!callback_);
+  callback_ = std::move(callback);
+  MaybeRunCallback();
+}
+
+void ParallelBlockReader::ReadAhead() {
+  while (next_block_to_read_ <= last_block_ &&
+         next_block_to_read_ - next_block_ < kMaxBlocksInFlight) {
+    const int block = next_block_to_read_++;
+    const uint64_t block_offset =
+        static_cast<uint64_t>(block) * integrity_.block_size;
+    base::ThreadPool::PostTaskAndReplyWithResult(
+        FROM_HERE,
+        {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+         base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+        base::BindOnce(&ReadAndVerifyBlock, archive_,
+                       file_offset_ + block_offset,
+                       std::min<uint64_t>(integrity_.block_size,
+                                          file_size_ - block_offset),
+                       integrity_.blocks[block]),
+        base::BindOnce(&ParallelBlockReader::OnBlockRead,
+                       weak_factory_.GetWeakPtr(), block));
+  }
+}
+
+void ParallelBlockReader::OnBlockRead(int block, std::vector<char> data) {
+  read_blocks_[block] = std::move(data);
+  MaybeRunCallback();
+}
+
+void ParallelBlockReader::MaybeRunCallback() {
+  auto it = read_blocks_.find(next_block_);
+  if (!callback_ || it == read_blocks_.end())
+    return;
+
+  std::vector<char> data = std::move(it->second);
+  read_blocks_.erase(it);
+  next_block_++;
+  ReadAhead();
+  std::move(callback_).Run(std::move(data));
+}
+
 }  // namespace asar
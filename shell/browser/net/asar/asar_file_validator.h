@@ -6,8 +6,14 @@
 #define ELECTRON_SHELL_BROWSER_NET_ASAR_ASAR_FILE_VALIDATOR_H_
 
 #include <algorithm>
+#include <limits>
+#include <map>
 #include <memory>
+#include <vector>
 
+#include "base/callback.h"
+#include "base/containers/span.h"
+#include "base/memory/weak_ptr.h"
 #include "crypto/secure_hash.h"
 #include "mojo/public/cpp/system/file_data_source.h"
 #include "mojo/public/cpp/system/filtered_data_source.h"
@@ -19,6 +25,10 @@ namespace asar {
 class AsarFileValidator : public mojo::FilteredDataSource::Filter {
  public:
   AsarFileValidator(IntegrityPayload integrity, base::File file);
+  // Reads the bytes the data producer skips straight out of |mapped_file|,
+  // the memory mapping of the whole archive, instead of through a file.
+  AsarFileValidator(IntegrityPayload integrity,
+                    base::span<const uint8_t> mapped_file);
   ~AsarFileValidator() override;
 
   // disable copy
@@ -30,14 +40,41 @@ class AsarFileValidator : public mojo::FilteredDataSource::Filter {
 
   void OnDone() override;
 
+  // Hashes |data| as if it had been read by the data producer, for bytes that
+  // are needed for validation but never sent to the consumer.
+  void OnSkippedData(base::span<const uint8_t> data);
+
   void SetRange(uint64_t read_start, uint64_t extra_read, uint64_t read_max);
   void SetCurrentBlock(int current_block);
 
+  // Leaves the blocks from |first_parallel_block| on to a
+  // |ParallelBlockReader|, only counting their bytes. The caller has to write
+  // those blocks from what the reader hands out.
+  void SetFirstParallelBlock(int first_parallel_block);
+
+  // Skips hashing blocks that |archive| already verified and records the
+  // blocks verified here. |file_offset| and |file_size| locate the validated
+  // file in the archive. |archive| must outlive this validator.
+  void SetVerificationCache(Archive* archive,
+                            uint64_t file_offset,
+                            uint64_t file_size);
+
  protected:
   bool FinishBlock();
 
  private:
+  void HashData(const char* data, uint64_t buffer_size);
+  void CreateHash();
+  // Adds the |size| bytes at |offset| of the file to the current hash without
+  // the data producer knowing. Returns false if they can't be read.
+  bool HashFromFile(uint64_t offset, uint64_t size);
+  bool IsParallelBlock() const;
+  uint64_t CurrentBlockOffset() const;
+  // The number of bytes of the file in the current block.
+  uint64_t CurrentBlockLength() const;
+
   base::File file_;
+  base::span<const uint8_t> mapped_file_;
   IntegrityPayload integrity_;
 
   // The offset in the file_ that the underlying file reader is starting at
@@ -53,9 +90,76 @@ class AsarFileValidator : public mojo::FilteredDataSource::Filter {
   bool done_reading_ = false;
   int current_block_;
   int max_block_;
+  int first_parallel_block_ = std::numeric_limits<int>::max();
   uint64_t current_hash_byte_count_ = 0;
   uint64_t total_hash_byte_count_ = 0;
   std::unique_ptr<crypto::SecureHash> current_hash_;
+
+  Archive* archive_ = nullptr;
+  uint64_t file_offset_ = 0;
+  uint64_t file_size_ = 0;
+  uint64_t cache_generation_ = 0;
+  // Whether the bytes of the current block are being skipped because the
+  // block was already verified.
+  bool skipping_block_ = false;
+};
+
+// Reads the integrity blocks |first_block| to |last_block| of the |file_size|
+// bytes at |file_offset| in |archive| on the thread pool, a few blocks ahead
+// of the consumer. Each block is copied out of the archive's mapping and the
+// copy is hashed, so a block is only handed out after the very bytes handed
+// out matched. A block that does not match its hash is fatal. Verified blocks
+// are recorded in the archive's verification cache.
+class ParallelBlockReader {
+ public:
+  using BlockCallback = base::OnceCallback<void(std::vector<char> block)>;
+
+  // Returns null if the archive is not mapped or the range has too few blocks
+  // for this to pay off.
+  static std::unique_ptr<ParallelBlockReader> Create(
+      std::shared_ptr<Archive> archive,
+      const IntegrityPayload& integrity,
+      uint64_t file_offset,
+      uint64_t file_size,
+      int first_block,
+      int last_block);
+  ~ParallelBlockReader();
+
+  // disable copy
+  ParallelBlockReader(const ParallelBlockReader&) = delete;
+  ParallelBlockReader& operator=(const ParallelBlockReader&) = delete;
+
+  bool HasNextBlock() const { return next_block_ <= last_block_; }
+
+  // Runs |callback| on the calling sequence with the next block once it has
+  // been verified. Only one read may be pending at a time.
+  void ReadNextBlock(BlockCallback callback);
+
+ private:
+  ParallelBlockReader(std::shared_ptr<Archive> archive,
+                      const IntegrityPayload& integrity,
+                      uint64_t file_offset,
+                      uint64_t file_size,
+                      int first_block,
+                      int last_block);
+
+  void ReadAhead();
+  void OnBlockRead(int block, std::vector<char> data);
+  void MaybeRunCallback();
+
+  std::shared_ptr<Archive> archive_;
+  IntegrityPayload integrity_;
+  uint64_t file_offset_;
+  uint64_t file_size_;
+  // The next block to hand out, and the next one to post a read for.
+  int next_block_;
+  int next_block_to_read_;
+  int last_block_;
+  // Blocks that were read and verified but not handed out yet.
+  std::map<int, std::vector<char>> read_blocks_;
+  BlockCallback callback_;
+
+  base::WeakPtrFactory<ParallelBlockReader> weak_factory_{this};
 };
 
 }  // namespace asar
@@ -0,0 +1,128 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/asar/asar_file_validator.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/rand_util.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/test/bind.h"
+#include "base/test/task_environment.h"
+#include "base/timer/elapsed_timer.h"
+#include "crypto/sha2.h"
+#include "shell/common/asar/archive.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace asar {
+
+namespace {
+
+constexpr uint32_t kBlockSize = 4 * 1024 * 1024;
+constexpr size_t kFileSize = 64 * 1024 * 1024;
+// Matches the size of the data pipe AsarURLLoader streams through.
+constexpr size_t kChunkSize = 64 * 1024;
+
+class AsarFileValidatorPerfTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.GetPath().AppendASCII("perf.asar");
+    data_ = base::RandBytesAsString(kFileSize);
+    ASSERT_TRUE(base::WriteFile(path_, data_));
+
+    integrity_.algorithm = HashAlgorithm::SHA256;
+    integrity_.block_size = kBlockSize;
+    for (size_t offset = 0; offset < data_.size(); offset += kBlockSize) {
+      const std::string hash =
+          crypto::SHA256HashString(data_.substr(offset, kBlockSize));
+      integrity_.blocks.push_back(
+          base::ToLowerASCII(base::HexEncode(hash.data(), hash.size())));
+    }
+  }
+
+  // Feeds the whole file through |validator| the way the data producer does.
+  void Stream(AsarFileValidator* validator) {
+    const auto bytes = base::as_bytes(base::make_span(data_));
+    validator->SetRange(0, 0, bytes.size());
+    for (size_t offset = 0; offset < bytes.size(); offset += kChunkSize) {
+      validator->OnSkippedData(bytes.subspan(
+          offset, std::min(kChunkSize, bytes.size() - offset)));
+    }
+    validator->OnDone();
+  }
+
+  void Report(const std::string& story, base::TimeDelta elapsed) {
+    perf_test::PerfResultReporter reporter("AsarFileValidator", story);
+    reporter.RegisterImportantMetric("_time", "ms");
+    reporter.RegisterImportantMetric("_throughput", "bytesPerSecond");
+    reporter.AddResult("_time", elapsed.InMillisecondsF());
+    reporter.AddResult("_throughput", data_.size() / elapsed.InSecondsF());
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+  base::FilePath path_;
+  std::string data_;
+  IntegrityPayload integrity_;
+};
+
+}  // namespace
+
+TEST_F(AsarFileValidatorPerfTest, Sequential) {
+  base::ElapsedTimer timer;
+  AsarFileValidator validator(integrity_, base::File());
+  Stream(&validator);
+  Report("sequential", timer.Elapsed());
+}
+
+TEST_F(AsarFileValidatorPerfTest, Parallel) {
+  auto archive = std::make_shared<Archive>(path_);
+  ASSERT_FALSE(archive->GetMappedFile().empty());
+
+  base::ElapsedTimer timer;
+  auto reader = ParallelBlockReader::Create(archive, integrity_, 0,
+                                            data_.size(), 0,
+                                            integrity_.blocks.size() - 1);
+  ASSERT_TRUE(reader);
+  size_t bytes_read = 0;
+  while (reader->HasNextBlock()) {
+    base::RunLoop run_loop;
+    reader->ReadNextBlock(
+        base::BindLambdaForTesting([&](std::vector<char> block) {
+          bytes_read += block.size();
+          run_loop.Quit();
+        }));
+    run_loop.Run();
+  }
+  Report("parallel", timer.Elapsed());
+
+  EXPECT_EQ(data_.size(), bytes_read);
+  EXPECT_TRUE(archive->IsIntegrityVerified(0, kBlockSize));
+}
+
+TEST_F(AsarFileValidatorPerfTest, Cached) {
+  auto archive = std::make_shared<Archive>(path_);
+  ASSERT_FALSE(archive->GetMappedFile().empty());
+
+  AsarFileValidator first_validator(integrity_, archive->GetMappedFile());
+  first_validator.SetVerificationCache(archive.get(), 0, data_.size());
+  Stream(&first_validator);
+
+  base::ElapsedTimer timer;
+  AsarFileValidator validator(integrity_, archive->GetMappedFile());
+  validator.SetVerificationCache(archive.get(), 0, data_.size());
+  Stream(&validator);
+  Report("cached", timer.Elapsed());
+}
+
+}  // namespace asar
@@ -0,0 +1,201 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/asar/asar_file_validator.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/test/bind.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "crypto/sha2.h"
+#include "shell/common/asar/archive.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asar {
+
+namespace {
+
+constexpr uint32_t kBlockSize = 1024;
+
+IntegrityPayload MakeIntegrity(const std::string& contents) {
+  IntegrityPayload integrity;
+  integrity.algorithm = HashAlgorithm::SHA256;
+  integrity.block_size = kBlockSize;
+  size_t offset = 0;
+  do {
+    const std::string hash =
+        crypto::SHA256HashString(contents.substr(offset, kBlockSize));
+    integrity.blocks.push_back(
+        base::ToLowerASCII(base::HexEncode(hash.data(), hash.size())));
+    offset += kBlockSize;
+  } while (offset < contents.size());
+  return integrity;
+}
+
+// Validates the |size| bytes at |offset| of |archive| the way AsarURLLoader
+// streams a file.
+void Stream(Archive* archive,
+            const IntegrityPayload& integrity,
+            uint64_t offset,
+            uint64_t size) {
+  AsarFileValidator validator(integrity, archive->GetMappedFile());
+  validator.SetVerificationCache(archive, offset, size);
+  validator.SetRange(offset, 0, offset + size);
+  if (size > 0)
+    validator.OnSkippedData(archive->GetMappedFile().subspan(offset, size));
+  validator.OnDone();
+}
+
+std::string ReadNextBlock(ParallelBlockReader* reader) {
+  std::string data;
+  base::RunLoop run_loop;
+  reader->ReadNextBlock(
+      base::BindLambdaForTesting([&](std::vector<char> block) {
+        data.assign(block.begin(), block.end());
+        run_loop.Quit();
+      }));
+  run_loop.Run();
+  return data;
+}
+
+}  // namespace
+
+TEST(AsarFileValidatorTest, EmptyFileDoesNotVerifyNextFile) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath path = temp_dir.GetPath().AppendASCII("test.asar");
+
+  // asar gives an empty file the offset of the file after it.
+  const std::string contents(kBlockSize, 'a');
+  const IntegrityPayload empty_integrity = MakeIntegrity("");
+  const IntegrityPayload file_integrity = MakeIntegrity(contents);
+  std::string tampered = contents;
+  tampered[0] = 'b';
+  ASSERT_TRUE(base::WriteFile(path, tampered));
+
+  Archive archive(path);
+  ASSERT_FALSE(archive.GetMappedFile().empty());
+
+  Stream(&archive, empty_integrity, 0, 0);
+  EXPECT_FALSE(archive.IsIntegrityVerified(0, 0));
+  EXPECT_FALSE(archive.IsIntegrityVerified(0, kBlockSize));
+
+  EXPECT_DEATH_IF_SUPPORTED(
+      Stream(&archive, file_integrity, 0, contents.size()), "");
+}
+
+TEST(AsarFileValidatorTest, RecordsHashedBytesOfLastBlock) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath path = temp_dir.GetPath().AppendASCII("test.asar");
+
+  const std::string contents(kBlockSize + 10, 'a');
+  ASSERT_TRUE(base::WriteFile(path, contents));
+
+  Archive archive(path);
+  ASSERT_FALSE(archive.GetMappedFile().empty());
+
+  Stream(&archive, MakeIntegrity(contents), 0, contents.size());
+  EXPECT_TRUE(archive.IsIntegrityVerified(0, kBlockSize));
+  EXPECT_TRUE(archive.IsIntegrityVerified(kBlockSize, 10));
+  EXPECT_FALSE(archive.IsIntegrityVerified(kBlockSize, kBlockSize));
+}
+
+TEST(AsarFileValidatorTest, HashesSkippedBlockOnceArchiveChanges) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath path = temp_dir.GetPath().AppendASCII("test.asar");
+
+  const std::string contents(kBlockSize, 'a');
+  const IntegrityPayload integrity = MakeIntegrity(contents);
+  ASSERT_TRUE(base::WriteFile(path, contents));
+
+  Archive archive(path);
+  ASSERT_FALSE(archive.GetMappedFile().empty());
+
+  Stream(&archive, integrity, 0, contents.size());
+  ASSERT_TRUE(archive.IsIntegrityVerified(0, kBlockSize));
+
+  // The first chunk is skipped, then the archive changes before the second.
+  EXPECT_DEATH_IF_SUPPORTED(
+      {
+        const auto mapped_file = archive.GetMappedFile();
+        AsarFileValidator validator(integrity, mapped_file);
+        validator.SetVerificationCache(&archive, 0, contents.size());
+        validator.SetRange(0, 0, contents.size());
+        validator.OnSkippedData(mapped_file.first(kBlockSize / 2));
+
+        std::string tampered = contents;
+        tampered[0] = 'b';
+        base::WriteFile(path, tampered);
+        const base::Time changed = base::Time::Now() + base::Hours(1);
+        base::TouchFile(path, changed, changed);
+
+        validator.OnSkippedData(mapped_file.subspan(kBlockSize / 2));
+        validator.OnDone();
+      },
+      "");
+}
+
+TEST(AsarFileValidatorTest, ParallelBlockReaderHandsOutVerifiedBlocks) {
+  base::test::TaskEnvironment task_environment;
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath path = temp_dir.GetPath().AppendASCII("test.asar");
+
+  std::string contents(kBlockSize, 'a');
+  contents += std::string(kBlockSize, 'b');
+  contents += std::string(10, 'c');
+  ASSERT_TRUE(base::WriteFile(path, contents));
+
+  auto archive = std::make_shared<Archive>(path);
+  ASSERT_FALSE(archive->GetMappedFile().empty());
+
+  // Starts after the first block, which the validator streams.
+  auto reader = ParallelBlockReader::Create(archive, MakeIntegrity(contents), 0,
+                                            contents.size(), 1, 2);
+  ASSERT_TRUE(reader);
+  EXPECT_EQ(contents.substr(kBlockSize, kBlockSize),
+            ReadNextBlock(reader.get()));
+  EXPECT_EQ(contents.substr(2 * kBlockSize), ReadNextBlock(reader.get()));
+  EXPECT_FALSE(reader->HasNextBlock());
+  EXPECT_TRUE(archive->IsIntegrityVerified(kBlockSize, kBlockSize));
+  EXPECT_FALSE(archive->IsIntegrityVerified(0, kBlockSize));
+}
+
+TEST(AsarFileValidatorTest, ParallelBlockReaderNeverHandsOutTamperedBlock) {
+  base::test::TaskEnvironment task_environment;
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath path = temp_dir.GetPath().AppendASCII("test.asar");
+
+  const std::string contents(3 * kBlockSize, 'a');
+  std::string tampered = contents;
+  tampered.back() = 'b';
+  ASSERT_TRUE(base::WriteFile(path, tampered));
+
+  auto archive = std::make_shared<Archive>(path);
+  ASSERT_FALSE(archive->GetMappedFile().empty());
+
+  // The reader starts reading ahead right away, so it only exists in the
+  // child process.
+  EXPECT_DEATH_IF_SUPPORTED(
+      {
+        auto reader = ParallelBlockReader::Create(
+            archive, MakeIntegrity(contents), 0, contents.size(), 1, 2);
+        ReadNextBlock(reader.get());
+        ReadNextBlock(reader.get());
+      },
+      "");
+}
+
+}  // namespace asar
@@ -5,11 +5,15 @@
 #include "shell/browser/net/asar/asar_url_loader.h"
 
 #include <algorithm>
+#include <cinttypes>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/bind.h"
+#include "base/containers/span.h"
 #include "base/strings/stringprintf.h"
 #include "base/task/post_task.h"
 #include "base/task/thread_pool.h"
@@ -19,10 +23,12 @@
 #include "mojo/public/cpp/bindings/remote.h"
 #include "mojo/public/cpp/system/data_pipe_producer.h"
 #include "mojo/public/cpp/system/file_data_source.h"
+#include "mojo/public/cpp/system/string_data_source.h"
 #include "net/base/filename_util.h"
 #include "net/base/mime_sniffer.h"
 #include "net/base/mime_util.h"
 #include "net/http/http_byte_range.h"
+#include "net/http/http_status_code.h"
 #include "net/http/http_util.h"
 #include "services/network/public/mojom/url_response_head.mojom.h"
 #include "shell/browser/net/asar/asar_file_validator.h"
@@ -57,6 +63,47 @@ static_assert(kDefaultFileUrlPipeSize >= net::kMaxBytesToSniff,
               "Default file data pipe size must be at least as large as a MIME-"
               "type sniffing buffer.");
 
+// Serves a slice of an asar archive straight out of its memory mapping, so the
+// bytes are copied exactly once: from the mapped pages into the data pipe.
+// Offsets follow the same conventions as |mojo::FileDataSource|.
+class MappedDataSource : public mojo::DataPipeProducer::DataSource {
+ public:
+  explicit MappedDataSource(base::span<const uint8_t> mapped_file)
+      : mapped_file_(mapped_file), end_(mapped_file.size()) {}
+  ~MappedDataSource() override = default;
+
+  // disable copy
+  MappedDataSource(const MappedDataSource&) = delete;
+  MappedDataSource& operator=(const MappedDataSource&) = delete;
+
+  void SetRange(uint64_t start, uint64_t end) {
+    start_ = std::min<uint64_t>(start, mapped_file_.size());
+    end_ = std::min<uint64_t>(std::max(start_, end), mapped_file_.size());
+  }
+
+  // mojo::DataPipeProducer::DataSource:
+  uint64_t GetLength() const override { return end_ - start_; }
+
+  ReadResult Read(uint64_t offset, base::span<char> buffer) override {
+    ReadResult result;
+    if (offset > GetLength()) {
+      result.result = MOJO_RESULT_OUT_OF_RANGE;
+      return result;
+    }
+
+    const size_t read_size =
+        std::min<uint64_t>(buffer.size(), GetLength() - offset);
+    memcpy(buffer.data(), mapped_file_.data() + start_ + offset, read_size);
+    result.bytes_read = read_size;
+    return result;
+  }
+
+ private:
+  const base::span<const uint8_t> mapped_file_;
+  uint64_t start_ = 0;
+  uint64_t end_;
+};
+
 // Modified from the |FileURLLoader| in |file_url_loader_factory.cc|, to serve
 // asar files instead of normal files.
 class AsarURLLoader : public network::mojom::URLLoader {
@@ -151,28 +198,76 @@ class AsarURLLoader : public network::mojom::URLLoader {
       return;
     }
 
-    // Note that while the |Archive| already opens a |base::File|, we still need
-    // to create a new |base::File| here, as it might be accessed by multiple
-    // requests at the same time.
-    base::File file(info.unpacked ? real_path : archive->path(),
-                    base::File::FLAG_OPEN | base::File::FLAG_READ);
-    auto file_data_source =
-        std::make_unique<mojo::FileDataSource>(file.Duplicate());
+    // Packed files are served out of the archive's memory mapping, which is
+    // shared by every request. Unpacked files, or archives that could not be
+    // mapped, are read through a new |base::File| since the one owned by the
+    // |Archive| might be accessed by multiple requests at the same time.
+    base::span<const uint8_t> mapped_file;
+    if (!info.unpacked)
+      mapped_file = archive->GetMappedFile();
+
+    std::unique_ptr<mojo::DataPipeProducer::DataSource> data_source;
+    mojo::FileDataSource* file_data_source_raw = nullptr;
+    MappedDataSource* mapped_data_source_raw = nullptr;
+    base::File file;
+    if (!mapped_file.empty()) {
+      auto mapped_data_source = std::make_unique<MappedDataSource>(mapped_file);
+      mapped_data_source_raw = mapped_data_source.get();
+      data_source = std::move(mapped_data_source);
+    } else {
+      file = base::File(info.unpacked ? real_path : archive->path(),
+                        base::File::FLAG_OPEN | base::File::FLAG_READ);
+      auto file_data_source =
+          std::make_unique<mojo::FileDataSource>(file.Duplicate());
+      file_data_source_raw = file_data_source.get();
+      data_source = std::move(file_data_source);
+    }
+    // The mapping must outlive the data sources reading from it.
+    archive_ = archive;
+
     std::unique_ptr<mojo::DataPipeProducer::DataSource> readable_data_source;
-    mojo::FileDataSource* file_data_source_raw = file_data_source.get();
     AsarFileValidator* file_validator_raw = nullptr;
     uint32_t block_size = 0;
+    absl::optional<IntegrityPayload> parallel_integrity;
     if (info.integrity.has_value()) {
       block_size = info.integrity.value().block_size;
-      auto asar_validator = std::make_unique<AsarFileValidator>(
-          std::move(info.integrity.value()), std::move(file));
+      if (!mapped_file.empty())
+        parallel_integrity = info.integrity;
+      std::unique_ptr<AsarFileValidator> asar_validator;
+      if (!mapped_file.empty()) {
+        asar_validator = std::make_unique<AsarFileValidator>(
+            std::move(info.integrity.value()), mapped_file);
+      } else {
+        asar_validator = std::make_unique<AsarFileValidator>(
+            std::move(info.integrity.value()), std::move(file));
+      }
+      asar_validator->SetVerificationCache(archive.get(), info.offset,
+                                           info.size);
       file_validator_raw = asar_validator.get();
       readable_data_source.reset(new mojo::FilteredDataSource(
-          std::move(file_data_source), std::move(asar_validator)));
+          std::move(data_source), std::move(asar_validator)));
     } else {
-      readable_data_source = std::move(file_data_source);
+      readable_data_source = std::move(data_source);
     }
 
+    // Bytes that are needed to validate a block but are never sent to the
+    // consumer. When the archive is mapped they are hashed in place, otherwise
+    // they are read through the validating data source and thrown away.
+    auto hash_skipped_bytes = [&](uint64_t offset,
+                                  uint64_t size) -> MojoResult {
+      if (!mapped_file.empty()) {
+        if (offset > mapped_file.size())
+          return MOJO_RESULT_OUT_OF_RANGE;
+        file_validator_raw->OnSkippedData(mapped_file.subspan(
+            offset, std::min<uint64_t>(size, mapped_file.size() - offset)));
+        return MOJO_RESULT_OK;
+      }
+      std::vector<char> abandoned_buffer(size);
+      return readable_data_source->Read(offset,
+                                        base::span<char>(abandoned_buffer))
+          .result;
+    };
+
     std::vector<char> initial_read_buffer(
         std::min(static_cast<uint32_t>(net::kMaxBytesToSniff), info.size));
     auto read_result = readable_data_source.get()->Read(
@@ -218,6 +313,21 @@ class AsarURLLoader : public network::mojom::URLLoader {
 
     head->content_length = base::saturated_cast<int64_t>(total_bytes_to_send);
 
+    // Answer a satisfiable range with a partial response so that media
+    // elements can seek within files served from here.
+    if (head->headers && head->headers->response_code() == net::HTTP_OK) {
+      if (byte_range.IsValid()) {
+        head->headers->ReplaceStatusLine("HTTP/1.1 206 Partial Content");
+        head->headers->AddHeader(
+            "Content-Range",
+            base::StringPrintf("bytes %" PRId64 "-%" PRId64 "/%" PRId64,
+                               byte_range.first_byte_position(),
+                               byte_range.last_byte_position(),
+                               static_cast<int64_t>(info.size)));
+      }
+      head->headers->AddHeader("Accept-Ranges", "bytes");
+    }
+
     if (first_byte_to_send < read_result.bytes_read) {
       // Write any data we read for MIME sniffing, constraining by range where
       // applicable. This will always fit in the pipe (see assertion near
@@ -246,13 +356,10 @@ class AsarURLLoader : public network::mojom::URLLoader {
       // will be needed by the producer
       uint64_t bytes_to_drop = block_size - net::kMaxBytesToSniff;
       total_bytes_dropped_from_head += bytes_to_drop;
-      std::vector<char> abandoned_buffer(bytes_to_drop);
-      auto abandon_read_result =
-          readable_data_source.get()->Read(info.offset + net::kMaxBytesToSniff,
-                                           base::span<char>(abandoned_buffer));
-      if (abandon_read_result.result != MOJO_RESULT_OK) {
-        OnClientComplete(
-            ConvertMojoResultToNetError(abandon_read_result.result));
+      MojoResult abandon_read_result = hash_skipped_bytes(
+          info.offset + net::kMaxBytesToSniff, bytes_to_drop);
+      if (abandon_read_result != MOJO_RESULT_OK) {
+        OnClientComplete(ConvertMojoResultToNetError(abandon_read_result));
         return;
       }
     }
@@ -302,18 +409,35 @@ class AsarURLLoader : public network::mojom::URLLoader {
       if (file_validator_raw)
         file_validator_raw->SetCurrentBlock(start_block);
 
+      // Large files get the blocks after the one being read first read and
+      // hashed on the thread pool instead of by the validator. The data
+      // producer then only sends the first block, and every later block is
+      // written from the buffer that was verified.
+      if (parallel_integrity.has_value()) {
+        parallel_reader_ = ParallelBlockReader::Create(
+            archive, parallel_integrity.value(), info.offset, info.size,
+            start_block + 1,
+            (first_byte_to_send + total_bytes_to_send - 1) / block_size);
+      }
+      if (parallel_reader_) {
+        file_validator_raw->SetFirstParallelBlock(start_block + 1);
+        parallel_range_end_ = first_byte_to_send + total_bytes_to_send;
+        total_bytes_to_send =
+            (start_block + 1) * static_cast<uint64_t>(block_size) -
+            first_byte_to_send;
+        parallel_bytes_written_ = first_byte_to_send + total_bytes_to_send;
+      }
+
       if (bytes_to_drop > 0) {
         uint64_t dropped_bytes_offset =
             info.offset + (start_block * block_size);
         if (start_block == 0)
           dropped_bytes_offset += net::kMaxBytesToSniff;
         total_bytes_dropped_from_head += bytes_to_drop;
-        std::vector<char> abandoned_buffer(bytes_to_drop);
-        auto abandon_read_result = readable_data_source.get()->Read(
-            dropped_bytes_offset, base::span<char>(abandoned_buffer));
-        if (abandon_read_result.result != MOJO_RESULT_OK) {
-          OnClientComplete(
-              ConvertMojoResultToNetError(abandon_read_result.result));
+        MojoResult abandon_read_result =
+            hash_skipped_bytes(dropped_bytes_offset, bytes_to_drop);
+        if (abandon_read_result != MOJO_RESULT_OK) {
+          OnClientComplete(ConvertMojoResultToNetError(abandon_read_result));
           return;
         }
       }
@@ -324,9 +448,15 @@ class AsarURLLoader : public network::mojom::URLLoader {
     // (i.e., no range request) this Seek is effectively a no-op.
     //
     // Note that in Electron we also need to add file offset.
-    file_data_source_raw->SetRange(
-        first_byte_to_send + info.offset,
-        first_byte_to_send + info.offset + total_bytes_to_send);
+    if (mapped_data_source_raw) {
+      mapped_data_source_raw->SetRange(
+          first_byte_to_send + info.offset,
+          first_byte_to_send + info.offset + total_bytes_to_send);
+    } else {
+      file_data_source_raw->SetRange(
+          first_byte_to_send + info.offset,
+          first_byte_to_send + info.offset + total_bytes_to_send);
+    }
     if (file_validator_raw)
       file_validator_raw->SetRange(info.offset + first_byte_to_send,
                                    total_bytes_dropped_from_head,
@@ -356,9 +486,19 @@ class AsarURLLoader : public network::mojom::URLLoader {
   }
 
   void OnFileWritten(MojoResult result) {
+    // Blocks read by |parallel_reader_| follow one at a time.
+    if (result == MOJO_RESULT_OK && parallel_reader_ &&
+        parallel_reader_->HasNextBlock()) {
+      parallel_reader_->ReadNextBlock(base::BindOnce(
+          &AsarURLLoader::OnParallelBlockRead, base::Unretained(this)));
+      return;
+    }
+
     // All the data has been written now. Close the data pipe. The consumer will
     // be notified that there will be no more data to read from now.
     data_producer_.reset();
+    parallel_reader_.reset();
+    parallel_block_.clear();
 
     if (result == MOJO_RESULT_OK) {
       network::URLLoaderCompletionStatus status(net::OK);
@@ -373,6 +513,27 @@ class AsarURLLoader : public network::mojom::URLLoader {
     MaybeDeleteSelf();
   }
 
+  void OnParallelBlockRead(std::vector<char> block) {
+    // The last block is cut off where the requested range ends.
+    const uint64_t size = std::min<uint64_t>(
+        block.size(), parallel_range_end_ - parallel_bytes_written_);
+    block.resize(size);
+    parallel_bytes_written_ += size;
+
+    // The verified buffer itself is written, so it has to stay alive until
+    // the write completes.
+    parallel_block_ = std::move(block);
+    data_producer_->Write(
+        std::make_unique<mojo::StringDataSource>(
+            base::make_span(parallel_block_),
+            mojo::StringDataSource::AsyncWritingMode::
+                STRING_STAYS_VALID_UNTIL_COMPLETION),
+        base::BindOnce(&AsarURLLoader::OnFileWritten, base::Unretained(this)));
+  }
+
+  // Keeps the archive, and therefore its memory mapping, alive while data is
+  // being produced out of it.
+  std::shared_ptr<Archive> archive_;
   std::unique_ptr<mojo::DataPipeProducer> data_producer_;
   mojo::Receiver<network::mojom::URLLoader> receiver_{this};
   mojo::Remote<network::mojom::URLLoaderClient> client_;
@@ -383,6 +544,14 @@ class AsarURLLoader : public network::mojom::URLLoader {
   // It is used to set some of the URLLoaderCompletionStatus data passed back
   // to the URLLoaderClients (eg SimpleURLLoader).
   size_t total_bytes_written_ = 0;
+
+  // Reads and verifies the blocks after the first one of large files. The
+  // block being written, and how much of the file has been written after the
+  // data producer got through the first block.
+  std::unique_ptr<ParallelBlockReader> parallel_reader_;
+  std::vector<char> parallel_block_;
+  uint64_t parallel_bytes_written_ = 0;
+  uint64_t parallel_range_end_ = 0;
 };
 
 }  // namespace
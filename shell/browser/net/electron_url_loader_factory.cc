@@ -4,10 +4,13 @@
 
 #include "shell/browser/net/electron_url_loader_factory.h"
 
+#include <cinttypes>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "base/format_macros.h"
 #include "base/guid.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
@@ -16,8 +19,10 @@
 #include "mojo/public/cpp/system/data_pipe_producer.h"
 #include "mojo/public/cpp/system/string_data_source.h"
 #include "net/base/filename_util.h"
+#include "net/http/http_byte_range.h"
 #include "net/http/http_request_headers.h"
 #include "net/http/http_status_code.h"
+#include "net/http/http_util.h"
 #include "net/url_request/redirect_util.h"
 #include "services/network/public/cpp/url_loader_completion_status.h"
 #include "services/network/public/mojom/url_loader_factory.mojom.h"
@@ -150,10 +155,17 @@ network::mojom::URLResponseHeadPtr ToResponseHead(
   return head;
 }
 
-// Helper to write string to pipe.
+// Helper to write string or buffer to pipe.
 struct WriteData {
   mojo::Remote<network::mojom::URLLoaderClient> client;
+  // Owns the bytes of string responses.
   std::string data;
+  // Pins the bytes of buffer responses.
+  std::shared_ptr<v8::BackingStore> backing_store;
+  // Keeps the bytes of native responses alive.
+  scoped_refptr<base::RefCountedMemory> memory;
+  // The part of |data|, |backing_store| or |memory| being sent.
+  base::StringPiece body;
   std::unique_ptr<mojo::DataPipeProducer> producer;
 };
 
@@ -161,13 +173,94 @@ void OnWrite(std::unique_ptr<WriteData> write_data, MojoResult result) {
   network::URLLoaderCompletionStatus status(net::ERR_FAILED);
   if (result == MOJO_RESULT_OK) {
     status = network::URLLoaderCompletionStatus(net::OK);
-    status.encoded_data_length = write_data->data.size();
-    status.encoded_body_length = write_data->data.size();
-    status.decoded_body_length = write_data->data.size();
+    status.encoded_data_length = write_data->body.size();
+    status.encoded_body_length = write_data->body.size();
+    status.decoded_body_length = write_data->body.size();
   }
   write_data->client->OnComplete(status);
 }
 
+// Narrows |body| down to the single range asked for by the "Range" header of
+// |request|, if any, and turns |head| into the matching 206 response. Returns
+// false if the range cannot be satisfied. Responses with a status other than
+// 200 and requests for multiple ranges are sent whole.
+bool ApplyByteRange(const network::ResourceRequest& request,
+                    network::mojom::URLResponseHead* head,
+                    base::StringPiece* body) {
+  if (head->headers->response_code() != net::HTTP_OK)
+    return true;
+
+  if (!head->headers->HasHeader("Accept-Ranges"))
+    head->headers->AddHeader("Accept-Ranges", "bytes");
+
+  std::string range_header;
+  if (!request.headers.GetHeader(net::HttpRequestHeaders::kRange,
+                                 &range_header))
+    return true;
+
+  std::vector<net::HttpByteRange> ranges;
+  if (!net::HttpUtil::ParseRangeHeader(range_header, &ranges) ||
+      ranges.size() != 1)
+    return true;
+
+  net::HttpByteRange byte_range = ranges[0];
+  if (!byte_range.ComputeBounds(body->size()))
+    return false;
+
+  const int64_t first = byte_range.first_byte_position();
+  const int64_t last = byte_range.last_byte_position();
+  head->headers->ReplaceStatusLine("HTTP/1.1 206 Partial Content");
+  head->headers->RemoveHeader("Content-Length");
+  head->headers->AddHeader(
+      "Content-Range",
+      base::StringPrintf("bytes %" PRId64 "-%" PRId64 "/%" PRIuS, first, last,
+                         body->size()));
+  head->content_length = last - first + 1;
+  *body = body->substr(first, last - first + 1);
+  return true;
+}
+
+void SendBody(const network::ResourceRequest& request,
+              mojo::PendingRemote<network::mojom::URLLoaderClient> client,
+              network::mojom::URLResponseHeadPtr head,
+              std::unique_ptr<WriteData> write_data) {
+  mojo::Remote<network::mojom::URLLoaderClient> client_remote(
+      std::move(client));
+
+  if (!ApplyByteRange(request, head.get(), &write_data->body)) {
+    client_remote->OnComplete(network::URLLoaderCompletionStatus(
+        net::ERR_REQUEST_RANGE_NOT_SATISFIABLE));
+    return;
+  }
+
+  // Add header to ignore CORS.
+  head->headers->AddHeader("Access-Control-Allow-Origin", "*");
+  client_remote->OnReceiveResponse(std::move(head));
+
+  // Code below follows the pattern of data_url_loader_factory.cc.
+  mojo::ScopedDataPipeProducerHandle producer;
+  mojo::ScopedDataPipeConsumerHandle consumer;
+  if (mojo::CreateDataPipe(nullptr, producer, consumer) != MOJO_RESULT_OK) {
+    client_remote->OnComplete(
+        network::URLLoaderCompletionStatus(net::ERR_INSUFFICIENT_RESOURCES));
+    return;
+  }
+
+  client_remote->OnStartLoadingResponseBody(std::move(consumer));
+
+  write_data->client = std::move(client_remote);
+  write_data->producer =
+      std::make_unique<mojo::DataPipeProducer>(std::move(producer));
+  auto* producer_ptr = write_data->producer.get();
+
+  base::StringPiece body = write_data->body;
+  producer_ptr->Write(
+      std::make_unique<mojo::StringDataSource>(
+          body, mojo::StringDataSource::AsyncWritingMode::
+                    STRING_STAYS_VALID_UNTIL_COMPLETION),
+      base::BindOnce(OnWrite, std::move(write_data)));
+}
+
 }  // namespace
 
 ElectronURLLoaderFactory::RedirectedRequest::RedirectedRequest(
@@ -251,11 +344,20 @@ void ElectronURLLoaderFactory::RedirectedRequest::DeleteThis() {
 mojo::PendingRemote<network::mojom::URLLoaderFactory>
 ElectronURLLoaderFactory::Create(ProtocolType type,
                                  const ProtocolHandler& handler) {
+  return Create(type, handler, nullptr);
+}
+
+// static
+mojo::PendingRemote<network::mojom::URLLoaderFactory>
+ElectronURLLoaderFactory::Create(
+    ProtocolType type,
+    const ProtocolHandler& handler,
+    scoped_refptr<StaticProtocolSource> static_source) {
   mojo::PendingRemote<network::mojom::URLLoaderFactory> pending_remote;
 
   // The ElectronURLLoaderFactory will delete itself when there are no more
   // receivers - see the SelfDeletingURLLoaderFactory::OnDisconnect method.
-  new ElectronURLLoaderFactory(type, handler,
+  new ElectronURLLoaderFactory(type, handler, std::move(static_source),
                                pending_remote.InitWithNewPipeAndPassReceiver());
 
   return pending_remote;
@@ -264,10 +366,12 @@ ElectronURLLoaderFactory::Create(ProtocolType type,
 ElectronURLLoaderFactory::ElectronURLLoaderFactory(
     ProtocolType type,
     const ProtocolHandler& handler,
+    scoped_refptr<StaticProtocolSource> static_source,
     mojo::PendingReceiver<network::mojom::URLLoaderFactory> factory_receiver)
     : network::SelfDeletingURLLoaderFactory(std::move(factory_receiver)),
       type_(type),
-      handler_(handler) {}
+      handler_(handler),
+      static_source_(std::move(static_source)) {}
 
 ElectronURLLoaderFactory::~ElectronURLLoaderFactory() = default;
 
@@ -280,6 +384,37 @@ void ElectronURLLoaderFactory::CreateLoaderAndStart(
     const net::MutableNetworkTrafficAnnotationTag& traffic_annotation) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
 
+  // Static responses never reach JS, the handler only sees the requests the
+  // source could not serve.
+  if (static_source_) {
+    static_source_->Serve(
+        request, std::move(loader), std::move(client),
+        base::BindOnce(&ElectronURLLoaderFactory::RunHandler,
+                       weak_factory_.GetWeakPtr(), request_id, options,
+                       request, traffic_annotation));
+    return;
+  }
+
+  RunHandler(request_id, options, request, traffic_annotation,
+             std::move(loader), std::move(client));
+}
+
+void ElectronURLLoaderFactory::RunHandler(
+    int32_t request_id,
+    uint32_t options,
+    const network::ResourceRequest& request,
+    const net::MutableNetworkTrafficAnnotationTag& traffic_annotation,
+    mojo::PendingReceiver<network::mojom::URLLoader> loader,
+    mojo::PendingRemote<network::mojom::URLLoaderClient> client) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  // Static protocols may be registered without a handler.
+  if (handler_.is_null()) {
+    OnComplete(std::move(client), request_id,
+               network::URLLoaderCompletionStatus(net::ERR_FILE_NOT_FOUND));
+    return;
+  }
+
   // |StartLoading| is used for both intercepted and registered protocols,
   // and on redirects it needs a factory to use to create a loader for the
   // new request. So in this case, this factory is the target factory.
@@ -391,10 +526,10 @@ void ElectronURLLoaderFactory::StartLoading(
 
   switch (type) {
     case ProtocolType::kBuffer:
-      StartLoadingBuffer(std::move(client), std::move(head), dict);
+      StartLoadingBuffer(request, std::move(client), std::move(head), dict);
       break;
     case ProtocolType::kString:
-      StartLoadingString(std::move(client), std::move(head), dict,
+      StartLoadingString(request, std::move(client), std::move(head), dict,
                          args->isolate(), response);
       break;
     case ProtocolType::kFile:
@@ -425,6 +560,7 @@ void ElectronURLLoaderFactory::StartLoading(
 
 // static
 void ElectronURLLoaderFactory::StartLoadingBuffer(
+    const network::ResourceRequest& request,
     mojo::PendingRemote<network::mojom::URLLoaderClient> client,
     network::mojom::URLResponseHeadPtr head,
     const gin_helper::Dictionary& dict) {
@@ -438,13 +574,20 @@ void ElectronURLLoaderFactory::StartLoadingBuffer(
     return;
   }
 
-  SendContents(
-      std::move(client), std::move(head),
-      std::string(node::Buffer::Data(buffer), node::Buffer::Length(buffer)));
+  // Stream straight out of the Buffer's memory instead of copying it.
+  auto view = buffer.As<v8::ArrayBufferView>();
+  std::shared_ptr<v8::BackingStore> backing_store =
+      view->Buffer()->GetBackingStore();
+  base::StringPiece data(
+      static_cast<const char*>(backing_store->Data()) + view->ByteOffset(),
+      view->ByteLength());
+  SendBuffer(request, std::move(client), std::move(head),
+             std::move(backing_store), data);
 }
 
 // static
 void ElectronURLLoaderFactory::StartLoadingString(
+    const network::ResourceRequest& request,
     mojo::PendingRemote<network::mojom::URLLoaderClient> client,
     network::mojom::URLResponseHeadPtr head,
     const gin_helper::Dictionary& dict,
@@ -463,7 +606,8 @@ void ElectronURLLoaderFactory::StartLoadingString(
     return;
   }
 
-  SendContents(std::move(client), std::move(head), std::move(contents));
+  SendContents(request, std::move(client), std::move(head),
+               std::move(contents));
 }
 
 // static
@@ -596,40 +740,39 @@ void ElectronURLLoaderFactory::StartLoadingStream(
 
 // static
 void ElectronURLLoaderFactory::SendContents(
+    const network::ResourceRequest& request,
     mojo::PendingRemote<network::mojom::URLLoaderClient> client,
     network::mojom::URLResponseHeadPtr head,
     std::string data) {
-  mojo::Remote<network::mojom::URLLoaderClient> client_remote(
-      std::move(client));
-
-  // Add header to ignore CORS.
-  head->headers->AddHeader("Access-Control-Allow-Origin", "*");
-  client_remote->OnReceiveResponse(std::move(head));
-
-  // Code below follows the pattern of data_url_loader_factory.cc.
-  mojo::ScopedDataPipeProducerHandle producer;
-  mojo::ScopedDataPipeConsumerHandle consumer;
-  if (mojo::CreateDataPipe(nullptr, producer, consumer) != MOJO_RESULT_OK) {
-    client_remote->OnComplete(
-        network::URLLoaderCompletionStatus(net::ERR_INSUFFICIENT_RESOURCES));
-    return;
-  }
-
-  client_remote->OnStartLoadingResponseBody(std::move(consumer));
-
   auto write_data = std::make_unique<WriteData>();
-  write_data->client = std::move(client_remote);
   write_data->data = std::move(data);
-  write_data->producer =
-      std::make_unique<mojo::DataPipeProducer>(std::move(producer));
-  auto* producer_ptr = write_data->producer.get();
+  write_data->body = write_data->data;
+  SendBody(request, std::move(client), std::move(head), std::move(write_data));
+}
 
-  base::StringPiece string_piece(write_data->data);
-  producer_ptr->Write(
-      std::make_unique<mojo::StringDataSource>(
-          string_piece, mojo::StringDataSource::AsyncWritingMode::
-                            STRING_STAYS_VALID_UNTIL_COMPLETION),
-      base::BindOnce(OnWrite, std::move(write_data)));
+// static
+void ElectronURLLoaderFactory::SendBuffer(
+    const network::ResourceRequest& request,
+    mojo::PendingRemote<network::mojom::URLLoaderClient> client,
+    network::mojom::URLResponseHeadPtr head,
+    std::shared_ptr<v8::BackingStore> backing_store,
+    base::StringPiece data) {
+  auto write_data = std::make_unique<WriteData>();
+  write_data->backing_store = std::move(backing_store);
+  write_data->body = data;
+  SendBody(request, std::move(client), std::move(head), std::move(write_data));
+}
+
+// static
+void ElectronURLLoaderFactory::SendMemory(
+    const network::ResourceRequest& request,
+    mojo::PendingRemote<network::mojom::URLLoaderClient> client,
+    network::mojom::URLResponseHeadPtr head,
+    scoped_refptr<base::RefCountedMemory> data) {
+  auto write_data = std::make_unique<WriteData>();
+  write_data->body = base::StringPiece(data->front_as<char>(), data->size());
+  write_data->memory = std::move(data);
+  SendBody(request, std::move(client), std::move(head), std::move(write_data));
 }
 
 }  // namespace electron
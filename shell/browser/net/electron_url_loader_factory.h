@@ -6,10 +6,14 @@
 #define ELECTRON_SHELL_BROWSER_NET_ELECTRON_URL_LOADER_FACTORY_H_
 
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/weak_ptr.h"
+#include "base/strings/string_piece.h"
 #include "mojo/public/cpp/bindings/pending_receiver.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
 #include "mojo/public/cpp/bindings/receiver_set.h"
@@ -20,6 +24,7 @@
 #include "services/network/public/mojom/url_loader.mojom.h"
 #include "services/network/public/mojom/url_loader_factory.mojom.h"
 #include "services/network/public/mojom/url_response_head.mojom.h"
+#include "shell/browser/net/static_protocol_source.h"
 #include "shell/common/gin_helper/dictionary.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 
@@ -98,6 +103,12 @@ class ElectronURLLoaderFactory : public network::SelfDeletingURLLoaderFactory {
   static mojo::PendingRemote<network::mojom::URLLoaderFactory> Create(
       ProtocolType type,
       const ProtocolHandler& handler);
+  // Requests are first offered to |static_source|, the handler only runs for
+  // those it can not serve.
+  static mojo::PendingRemote<network::mojom::URLLoaderFactory> Create(
+      ProtocolType type,
+      const ProtocolHandler& handler,
+      scoped_refptr<StaticProtocolSource> static_source);
 
   // network::mojom::URLLoaderFactory:
   void CreateLoaderAndStart(
@@ -120,6 +131,14 @@ class ElectronURLLoaderFactory : public network::SelfDeletingURLLoaderFactory {
       ProtocolType type,
       gin::Arguments* args);
 
+  // Helper to send refcounted memory as response. Unlike the other helpers
+  // this one can be called on any sequence.
+  static void SendMemory(
+      const network::ResourceRequest& request,
+      mojo::PendingRemote<network::mojom::URLLoaderClient> client,
+      network::mojom::URLResponseHeadPtr head,
+      scoped_refptr<base::RefCountedMemory> data);
+
   // disable copy
   ElectronURLLoaderFactory(const ElectronURLLoaderFactory&) = delete;
   ElectronURLLoaderFactory& operator=(const ElectronURLLoaderFactory&) = delete;
@@ -128,18 +147,29 @@ class ElectronURLLoaderFactory : public network::SelfDeletingURLLoaderFactory {
   ElectronURLLoaderFactory(
       ProtocolType type,
       const ProtocolHandler& handler,
+      scoped_refptr<StaticProtocolSource> static_source,
       mojo::PendingReceiver<network::mojom::URLLoaderFactory> factory_receiver);
   ~ElectronURLLoaderFactory() override;
 
+  void RunHandler(
+      int32_t request_id,
+      uint32_t options,
+      const network::ResourceRequest& request,
+      const net::MutableNetworkTrafficAnnotationTag& traffic_annotation,
+      mojo::PendingReceiver<network::mojom::URLLoader> loader,
+      mojo::PendingRemote<network::mojom::URLLoaderClient> client);
+
   static void OnComplete(
       mojo::PendingRemote<network::mojom::URLLoaderClient> client,
       int32_t request_id,
       const network::URLLoaderCompletionStatus& status);
   static void StartLoadingBuffer(
+      const network::ResourceRequest& request,
       mojo::PendingRemote<network::mojom::URLLoaderClient> client,
       network::mojom::URLResponseHeadPtr head,
       const gin_helper::Dictionary& dict);
   static void StartLoadingString(
+      const network::ResourceRequest& request,
       mojo::PendingRemote<network::mojom::URLLoaderClient> client,
       network::mojom::URLResponseHeadPtr head,
       const gin_helper::Dictionary& dict,
@@ -167,12 +197,26 @@ class ElectronURLLoaderFactory : public network::SelfDeletingURLLoaderFactory {
 
   // Helper to send string as response.
   static void SendContents(
+      const network::ResourceRequest& request,
       mojo::PendingRemote<network::mojom::URLLoaderClient> client,
       network::mojom::URLResponseHeadPtr head,
       std::string data);
 
+  // Helper to send the bytes of a JS Buffer as response without copying them.
+  // The backing store is kept alive until the whole response has been
+  // written.
+  static void SendBuffer(
+      const network::ResourceRequest& request,
+      mojo::PendingRemote<network::mojom::URLLoaderClient> client,
+      network::mojom::URLResponseHeadPtr head,
+      std::shared_ptr<v8::BackingStore> backing_store,
+      base::StringPiece data);
+
   ProtocolType type_;
   ProtocolHandler handler_;
+  scoped_refptr<StaticProtocolSource> static_source_;
+
+  base::WeakPtrFactory<ElectronURLLoaderFactory> weak_factory_{this};
 };
 
 }  // namespace electron
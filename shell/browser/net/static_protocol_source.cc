@@ -0,0 +1,262 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/static_protocol_source.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/task/thread_pool.h"
+#include "content/public/browser/browser_task_traits.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/base/escape.h"
+#include "net/base/filename_util.h"
+#include "net/base/mime_sniffer.h"
+#include "net/base/mime_util.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_status_code.h"
+#include "services/network/public/mojom/url_response_head.mojom.h"
+#include "shell/browser/net/asar/asar_url_loader.h"
+#include "shell/browser/net/electron_url_loader_factory.h"
+#include "shell/common/asar/archive.h"
+#include "shell/common/asar/asar_util.h"
+
+namespace electron {
+
+namespace {
+
+// Larger files are streamed from disk instead of being cached, which also
+// keeps the per-block integrity checks of asar archives for them.
+constexpr int64_t kMaxCachedFileSize = 1024 * 1024;
+
+const char kIndexFile[] = "index.html";
+
+// Maps the path of |url| to a file under |directory|, refusing anything that
+// would escape it.
+bool GetPathInDirectory(const base::FilePath& directory,
+                        const GURL& url,
+                        base::FilePath* out) {
+  std::string path = net::UnescapeBinaryURLComponent(url.path_piece());
+  if (path.find('\0') != std::string::npos)
+    return false;
+
+  base::TrimString(path, "/", base::TRIM_LEADING, &path);
+  if (path.empty() || base::EndsWith(path, "/"))
+    path += kIndexFile;
+
+  base::FilePath relative_path = base::FilePath::FromUTF8Unsafe(path);
+  if (relative_path.IsAbsolute() || relative_path.ReferencesParent())
+    return false;
+
+  *out = directory.Append(relative_path);
+  return true;
+}
+
+// Same with base::GetFileInfo but supports asar archives, only regular files
+// are reported.
+bool GetFileSize(const base::FilePath& path, int64_t* size) {
+  base::FilePath asar_path, relative_path;
+  if (!asar::GetAsarArchivePath(path, &asar_path, &relative_path)) {
+    base::File::Info info;
+    if (!base::GetFileInfo(path, &info) || info.is_directory)
+      return false;
+    *size = info.size;
+    return true;
+  }
+
+  std::shared_ptr<asar::Archive> archive =
+      asar::GetOrCreateAsarArchive(asar_path);
+  asar::Archive::Stats stats;
+  if (!archive || !archive->Stat(relative_path, &stats) || !stats.is_file)
+    return false;
+  *size = stats.size;
+  return true;
+}
+
+network::mojom::URLResponseHeadPtr CreateResponseHead(
+    int status_code,
+    const std::string& mime_type,
+    const std::string& charset,
+    const StaticProtocolSource::Headers& headers) {
+  auto head = network::mojom::URLResponseHead::New();
+  head->headers = base::MakeRefCounted<net::HttpResponseHeaders>(
+      base::StringPrintf("HTTP/1.1 %d %s", status_code,
+                         net::GetHttpReasonPhrase(
+                             static_cast<net::HttpStatusCode>(status_code))));
+  for (const auto& header : headers)
+    head->headers->AddHeader(header.first, header.second);
+
+  head->mime_type = mime_type;
+  head->charset = charset;
+  if (!head->headers->HasHeader(net::HttpRequestHeaders::kContentType)) {
+    head->headers->AddHeader(net::HttpRequestHeaders::kContentType,
+                             charset.empty() ? mime_type
+                                             : mime_type + ";charset=" +
+                                                   charset);
+  }
+  return head;
+}
+
+}  // namespace
+
+StaticProtocolSource::Response::Response() = default;
+StaticProtocolSource::Response::Response(const Response&) = default;
+StaticProtocolSource::Response::~Response() = default;
+
+StaticProtocolSource::StaticProtocolSource(
+    std::map<std::string, Response> responses,
+    base::FilePath directory,
+    Headers headers,
+    size_t cache_size)
+    : responses_(std::move(responses)),
+      directory_(std::move(directory)),
+      headers_(std::move(headers)),
+      max_cache_bytes_(cache_size),
+      cache_(decltype(cache_)::NO_AUTO_EVICT) {}
+
+StaticProtocolSource::~StaticProtocolSource() = default;
+
+void StaticProtocolSource::Serve(
+    const network::ResourceRequest& request,
+    mojo::PendingReceiver<network::mojom::URLLoader> loader,
+    mojo::PendingRemote<network::mojom::URLLoaderClient> client,
+    MissCallback on_miss) {
+  // Anything but a plain GET may depend on state only JS knows about.
+  if (request.method != net::HttpRequestHeaders::kGetMethod) {
+    std::move(on_miss).Run(std::move(loader), std::move(client));
+    return;
+  }
+
+  auto it = responses_.find(request.url.path());
+  if (it != responses_.end()) {
+    const Response& response = it->second;
+    Headers headers = headers_;
+    headers.insert(headers.end(), response.headers.begin(),
+                   response.headers.end());
+    ElectronURLLoaderFactory::SendMemory(
+        request, std::move(client),
+        CreateResponseHead(response.status_code, response.mime_type,
+                           response.charset, headers),
+        response.data);
+    return;
+  }
+
+  base::FilePath path;
+  if (directory_.empty() ||
+      !GetPathInDirectory(directory_, request.url, &path)) {
+    std::move(on_miss).Run(std::move(loader), std::move(client));
+    return;
+  }
+
+  // The response is written from the same sequence, which the data pipe
+  // producer requires.
+  auto task_runner = base::ThreadPool::CreateSequencedTaskRunner(
+      {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN});
+  task_runner->PostTask(
+      FROM_HERE,
+      base::BindOnce(&StaticProtocolSource::ServeFile, this, request,
+                     std::move(loader), std::move(client), std::move(path),
+                     std::move(on_miss)));
+}
+
+void StaticProtocolSource::ServeFile(
+    const network::ResourceRequest& request,
+    mojo::PendingReceiver<network::mojom::URLLoader> loader,
+    mojo::PendingRemote<network::mojom::URLLoaderClient> client,
+    base::FilePath path,
+    MissCallback on_miss) {
+  CachedFile file;
+  if (!GetCachedFile(path, &file)) {
+    int64_t size = 0;
+    if (!GetFileSize(path, &size)) {
+      content::GetUIThreadTaskRunner({})->PostTask(
+          FROM_HERE, base::BindOnce(std::move(on_miss), std::move(loader),
+                                    std::move(client)));
+      return;
+    }
+
+    std::string contents;
+    if (size > kMaxCachedFileSize ||
+        !asar::ReadFileToString(path, &contents)) {
+      // The asar loader streams the file and takes care of ranges, mime
+      // sniffing and integrity checks.
+      network::ResourceRequest file_request(request);
+      file_request.url = net::FilePathToFileURL(path);
+      scoped_refptr<net::HttpResponseHeaders> headers = CreateFileHeaders();
+      headers->AddHeader("Access-Control-Allow-Origin", "*");
+      asar::CreateAsarURLLoader(file_request, std::move(loader),
+                                std::move(client), std::move(headers));
+      return;
+    }
+
+    if (!net::GetMimeTypeFromFile(path, &file.mime_type)) {
+      net::SniffMimeType(
+          base::StringPiece(contents.data(),
+                            std::min<size_t>(contents.size(),
+                                            net::kMaxBytesToSniff)),
+          request.url, std::string(), net::ForceSniffFileUrlsForHtml::kDisabled,
+          &file.mime_type);
+    }
+    file.data = base::RefCountedString::TakeString(&contents);
+    AddCachedFile(path, file);
+  }
+
+  auto head = network::mojom::URLResponseHead::New();
+  head->headers = CreateFileHeaders();
+  head->mime_type = file.mime_type;
+  head->headers->AddHeader(net::HttpRequestHeaders::kContentType,
+                           file.mime_type);
+  ElectronURLLoaderFactory::SendMemory(request, std::move(client),
+                                       std::move(head), std::move(file.data));
+}
+
+bool StaticProtocolSource::GetCachedFile(const base::FilePath& path,
+                                         CachedFile* out) {
+  base::AutoLock auto_lock(cache_lock_);
+  auto it = cache_.Get(path);
+  if (it == cache_.end())
+    return false;
+  *out = it->second;
+  return true;
+}
+
+void StaticProtocolSource::AddCachedFile(const base::FilePath& path,
+                                         const CachedFile& file) {
+  if (file.data->size() > max_cache_bytes_)
+    return;
+
+  base::AutoLock auto_lock(cache_lock_);
+  auto it = cache_.Peek(path);
+  if (it != cache_.end()) {
+    cache_bytes_ -= it->second.data->size();
+    cache_.Erase(it);
+  }
+  cache_.Put(path, file);
+  cache_bytes_ += file.data->size();
+
+  while (cache_bytes_ > max_cache_bytes_) {
+    auto oldest = cache_.rbegin();
+    cache_bytes_ -= oldest->second.data->size();
+    cache_.Erase(oldest);
+  }
+}
+
+scoped_refptr<net::HttpResponseHeaders>
+StaticProtocolSource::CreateFileHeaders() const {
+  auto headers =
+      base::MakeRefCounted<net::HttpResponseHeaders>("HTTP/1.1 200 OK");
+  for (const auto& header : headers_)
+    headers->AddHeader(header.first, header.second);
+  return headers;
+}
+
+}  // namespace electron
@@ -0,0 +1,118 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ELECTRON_SHELL_BROWSER_NET_STATIC_PROTOCOL_SOURCE_H_
+#define ELECTRON_SHELL_BROWSER_NET_STATIC_PROTOCOL_SOURCE_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/containers/lru_cache.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/synchronization/lock.h"
+#include "mojo/public/cpp/bindings/pending_receiver.h"
+#include "mojo/public/cpp/bindings/pending_remote.h"
+#include "services/network/public/cpp/resource_request.h"
+#include "services/network/public/mojom/url_loader.mojom.h"
+
+namespace net {
+class HttpResponseHeaders;
+}
+
+namespace electron {
+
+// Responses that a registered scheme serves natively, without calling into
+// JS.
+//
+// A source is made of an in-memory table of responses keyed by URL path and
+// of a directory, which may live inside an asar archive. Table lookups happen
+// on the thread that receives the request, everything touching the disk runs
+// on the thread pool. Small files are kept in a shared LRU cache, so hot
+// assets are neither read nor hashed again. Requests the source can not serve
+// are handed back to the UI thread to be answered by the JS handler.
+//
+// The contents of the directory are assumed not to change while the source
+// is registered.
+class StaticProtocolSource
+    : public base::RefCountedThreadSafe<StaticProtocolSource> {
+ public:
+  using Headers = std::vector<std::pair<std::string, std::string>>;
+
+  struct Response {
+    Response();
+    Response(const Response&);
+    ~Response();
+
+    int status_code = 200;
+    std::string mime_type;
+    std::string charset;
+    Headers headers;
+    scoped_refptr<base::RefCountedMemory> data;
+  };
+
+  // Called on the UI thread with the loader and client of a request that the
+  // source could not serve.
+  using MissCallback = base::OnceCallback<void(
+      mojo::PendingReceiver<network::mojom::URLLoader>,
+      mojo::PendingRemote<network::mojom::URLLoaderClient>)>;
+
+  // Default budget of the cache of file contents, in bytes.
+  static constexpr size_t kDefaultCacheSize = 32 * 1024 * 1024;
+
+  StaticProtocolSource(std::map<std::string, Response> responses,
+                       base::FilePath directory,
+                       Headers headers,
+                       size_t cache_size);
+
+  // disable copy
+  StaticProtocolSource(const StaticProtocolSource&) = delete;
+  StaticProtocolSource& operator=(const StaticProtocolSource&) = delete;
+
+  // Answers |request| from the table, the cache or the directory, or passes
+  // |loader| and |client| to |on_miss|.
+  void Serve(const network::ResourceRequest& request,
+             mojo::PendingReceiver<network::mojom::URLLoader> loader,
+             mojo::PendingRemote<network::mojom::URLLoaderClient> client,
+             MissCallback on_miss);
+
+ private:
+  friend class base::RefCountedThreadSafe<StaticProtocolSource>;
+
+  struct CachedFile {
+    std::string mime_type;
+    scoped_refptr<base::RefCountedMemory> data;
+  };
+
+  ~StaticProtocolSource();
+
+  void ServeFile(const network::ResourceRequest& request,
+                 mojo::PendingReceiver<network::mojom::URLLoader> loader,
+                 mojo::PendingRemote<network::mojom::URLLoaderClient> client,
+                 base::FilePath path,
+                 MissCallback on_miss);
+
+  bool GetCachedFile(const base::FilePath& path, CachedFile* out);
+  void AddCachedFile(const base::FilePath& path, const CachedFile& file);
+
+  // Builds the 200 response all files from |directory_| are sent with.
+  scoped_refptr<net::HttpResponseHeaders> CreateFileHeaders() const;
+
+  const std::map<std::string, Response> responses_;
+  const base::FilePath directory_;
+  const Headers headers_;
+  const size_t max_cache_bytes_;
+
+  base::Lock cache_lock_;
+  base::LRUCache<base::FilePath, CachedFile> cache_;
+  size_t cache_bytes_ = 0;
+};
+
+}  // namespace electron
+
+#endif  // ELECTRON_SHELL_BROWSER_NET_STATIC_PROTOCOL_SOURCE_H_
@@ -0,0 +1,151 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/url_pattern_matcher.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "base/strings/string_util.h"
+#include "url/gurl.h"
+
+namespace electron {
+
+namespace {
+
+base::StringPiece TrimTrailingDot(base::StringPiece host) {
+  if (base::EndsWith(host, "."))
+    host.remove_suffix(1);
+  return host;
+}
+
+// The part of |path| before its first wildcard. A trailing slash is dropped,
+// because URLPattern lets "/foo/*" match "/foo" too.
+base::StringPiece LiteralPrefix(base::StringPiece path) {
+  base::StringPiece prefix = path.substr(0, path.find('*'));
+  if (base::EndsWith(prefix, "/"))
+    prefix.remove_suffix(1);
+  return prefix;
+}
+
+}  // namespace
+
+URLPatternMatcher::PathIndex::PathIndex() = default;
+URLPatternMatcher::PathIndex::PathIndex(PathIndex&&) = default;
+URLPatternMatcher::PathIndex& URLPatternMatcher::PathIndex::operator=(
+    PathIndex&&) = default;
+URLPatternMatcher::PathIndex::~PathIndex() = default;
+
+URLPatternMatcher::URLPatternMatcher() = default;
+
+URLPatternMatcher::URLPatternMatcher(const std::set<URLPattern>& patterns)
+    : patterns_(patterns.begin(), patterns.end()) {
+  std::map<std::string, PendingPathIndex> hosts;
+  std::map<std::string, PendingPathIndex> subdomain_hosts;
+  PendingPathIndex any_host;
+  for (uint32_t i = 0; i < patterns_.size(); ++i) {
+    const URLPattern& pattern = patterns_[i];
+    const std::string prefix(LiteralPrefix(pattern.path()));
+    const std::string host =
+        base::ToLowerASCII(TrimTrailingDot(pattern.host()));
+    if (pattern.match_all_urls() ||
+        (pattern.match_subdomains() && host.empty())) {
+      any_host[prefix].push_back(i);
+    } else if (pattern.match_subdomains()) {
+      subdomain_hosts[host][prefix].push_back(i);
+    } else {
+      hosts[host][prefix].push_back(i);
+    }
+  }
+
+  hosts_ = BuildHostIndex(std::move(hosts));
+  subdomain_hosts_ = BuildHostIndex(std::move(subdomain_hosts));
+  any_host_ = BuildPathIndex(std::move(any_host));
+}
+
+URLPatternMatcher::~URLPatternMatcher() = default;
+
+URLPatternMatcher::URLPatternMatcher(URLPatternMatcher&&) = default;
+URLPatternMatcher& URLPatternMatcher::operator=(URLPatternMatcher&&) = default;
+
+bool URLPatternMatcher::MatchesURL(const GURL& url) const {
+  if (patterns_.empty())
+    return true;
+
+  // URLPattern matches filesystem: URLs by their inner URL, which the index
+  // knows nothing about. They are rare enough to be tested one by one.
+  if (url.inner_url()) {
+    return std::any_of(
+        patterns_.begin(), patterns_.end(),
+        [&url](const URLPattern& pattern) { return pattern.MatchesURL(url); });
+  }
+
+  const base::StringPiece path = url.PathForRequestPiece();
+  const base::StringPiece host = TrimTrailingDot(url.host_piece());
+
+  auto it = hosts_.find(host);
+  if (it != hosts_.end() && MatchesIndex(it->second, url, path))
+    return true;
+
+  // "*.example.com" matches "example.com" and any of its subdomains, so
+  // every label suffix of the host is looked up.
+  base::StringPiece suffix = host;
+  while (true) {
+    it = subdomain_hosts_.find(suffix);
+    if (it != subdomain_hosts_.end() && MatchesIndex(it->second, url, path))
+      return true;
+    const size_t dot = suffix.find('.');
+    if (dot == base::StringPiece::npos)
+      break;
+    suffix = suffix.substr(dot + 1);
+  }
+
+  return MatchesIndex(any_host_, url, path);
+}
+
+// static
+URLPatternMatcher::PathIndex URLPatternMatcher::BuildPathIndex(
+    PendingPathIndex pending) {
+  PathIndex index;
+  for (const auto& prefix : pending)
+    index.lengths.push_back(prefix.first.size());
+  std::sort(index.lengths.begin(), index.lengths.end());
+  index.lengths.erase(std::unique(index.lengths.begin(), index.lengths.end()),
+                      index.lengths.end());
+
+  index.prefixes = decltype(index.prefixes)(
+      std::make_move_iterator(pending.begin()),
+      std::make_move_iterator(pending.end()));
+  return index;
+}
+
+// static
+URLPatternMatcher::HostIndex URLPatternMatcher::BuildHostIndex(
+    std::map<std::string, PendingPathIndex> pending) {
+  std::vector<std::pair<std::string, PathIndex>> hosts;
+  hosts.reserve(pending.size());
+  for (auto& host : pending)
+    hosts.emplace_back(host.first, BuildPathIndex(std::move(host.second)));
+  return HostIndex(std::move(hosts));
+}
+
+bool URLPatternMatcher::MatchesIndex(const PathIndex& index,
+                                     const GURL& url,
+                                     base::StringPiece path) const {
+  for (const size_t length : index.lengths) {
+    if (length > path.size())
+      break;
+    const auto it = index.prefixes.find(path.substr(0, length));
+    if (it == index.prefixes.end())
+      continue;
+    for (const uint32_t i : it->second) {
+      if (patterns_[i].MatchesURL(url))
+        return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace electron
@@ -0,0 +1,78 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ELECTRON_SHELL_BROWSER_NET_URL_PATTERN_MATCHER_H_
+#define ELECTRON_SHELL_BROWSER_NET_URL_PATTERN_MATCHER_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+#include "base/strings/string_piece.h"
+#include "extensions/common/url_pattern.h"
+
+class GURL;
+
+namespace electron {
+
+// Matches URLs against a set of URLPatterns without testing every pattern.
+//
+// Patterns are indexed by host, by host suffix for patterns matching
+// subdomains, and then by the literal prefix of their path. Matching a URL
+// looks up each label suffix of its host and each distinct prefix length of
+// the indexed paths, and only runs URLPattern::MatchesURL on the patterns
+// found there, so the cost does not grow with the number of patterns.
+class URLPatternMatcher {
+ public:
+  URLPatternMatcher();
+  explicit URLPatternMatcher(const std::set<URLPattern>& patterns);
+  ~URLPatternMatcher();
+
+  URLPatternMatcher(URLPatternMatcher&&);
+  URLPatternMatcher& operator=(URLPatternMatcher&&);
+
+  // disable copy
+  URLPatternMatcher(const URLPatternMatcher&) = delete;
+  URLPatternMatcher& operator=(const URLPatternMatcher&) = delete;
+
+  // Like an empty filter, an empty matcher matches every URL.
+  bool is_empty() const { return patterns_.empty(); }
+
+  bool MatchesURL(const GURL& url) const;
+
+ private:
+  // Patterns keyed by the literal prefix of their path.
+  struct PathIndex {
+    PathIndex();
+    PathIndex(PathIndex&&);
+    PathIndex& operator=(PathIndex&&);
+    ~PathIndex();
+
+    base::flat_map<std::string, std::vector<uint32_t>, std::less<>> prefixes;
+    // The distinct lengths of the keys of |prefixes|, in ascending order.
+    std::vector<size_t> lengths;
+  };
+
+  using HostIndex = base::flat_map<std::string, PathIndex, std::less<>>;
+  using PendingPathIndex = std::map<std::string, std::vector<uint32_t>>;
+
+  static PathIndex BuildPathIndex(PendingPathIndex pending);
+  static HostIndex BuildHostIndex(
+      std::map<std::string, PendingPathIndex> pending);
+
+  bool MatchesIndex(const PathIndex& index,
+                    const GURL& url,
+                    base::StringPiece path) const;
+
+  std::vector<URLPattern> patterns_;
+  HostIndex hosts_;
+  HostIndex subdomain_hosts_;
+  PathIndex any_host_;
+};
+
+}  // namespace electron
+
+#endif  // ELECTRON_SHELL_BROWSER_NET_URL_PATTERN_MATCHER_H_
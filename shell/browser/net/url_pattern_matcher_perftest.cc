@@ -0,0 +1,124 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/url_pattern_matcher.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "url/gurl.h"
+
+namespace electron {
+
+namespace {
+
+constexpr int kPatternCount = 10000;
+constexpr int kURLCount = 10000;
+
+class URLPatternMatcherPerfTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    // A mix of the shapes content filters use: whole domains, paths on a
+    // given host and paths on any host.
+    for (int i = 0; i < kPatternCount; ++i) {
+      std::string spec;
+      switch (i % 3) {
+        case 0:
+          spec = base::StringPrintf("*://*.tracker%d.com/*", i);
+          break;
+        case 1:
+          spec = base::StringPrintf("https://cdn%d.example.org/ads/%d/*", i, i);
+          break;
+        default:
+          spec = base::StringPrintf("*://*/banner%d/*", i);
+          break;
+      }
+      URLPattern pattern(URLPattern::SCHEME_ALL);
+      ASSERT_EQ(URLPattern::ParseResult::kSuccess, pattern.Parse(spec));
+      patterns_.insert(pattern);
+    }
+
+    // Half of the URLs hit one of the patterns.
+    for (int i = 0; i < kURLCount; ++i) {
+      const int n = (i * 7919) % kPatternCount;
+      std::string spec;
+      if (i % 2) {
+        spec = base::StringPrintf("https://www.site%d.net/page/%d.html", i, i);
+      } else if (n % 3 == 0) {
+        spec = base::StringPrintf("https://a.b.tracker%d.com/pixel.gif", n);
+      } else if (n % 3 == 1) {
+        spec =
+            base::StringPrintf("https://cdn%d.example.org/ads/%d/x.js", n, n);
+      } else {
+        spec = base::StringPrintf("http://news.example/banner%d/img.png", n);
+      }
+      urls_.emplace_back(spec);
+    }
+  }
+
+  bool MatchesLinearly(const GURL& url) const {
+    for (const auto& pattern : patterns_) {
+      if (pattern.MatchesURL(url))
+        return true;
+    }
+    return false;
+  }
+
+  void Report(const std::string& story, base::TimeDelta elapsed) {
+    perf_test::PerfResultReporter reporter("URLPatternMatcher", story);
+    reporter.RegisterImportantMetric("_time_per_url", "ns");
+    reporter.AddResult("_time_per_url",
+                       elapsed.InMicrosecondsF() * 1000 / kURLCount);
+  }
+
+  std::set<URLPattern> patterns_;
+  std::vector<GURL> urls_;
+};
+
+}  // namespace
+
+TEST_F(URLPatternMatcherPerfTest, MatchesLikeLinearScan) {
+  URLPatternMatcher matcher(patterns_);
+  int matches = 0;
+  for (const GURL& url : urls_) {
+    const bool expected = MatchesLinearly(url);
+    EXPECT_EQ(expected, matcher.MatchesURL(url)) << url.spec();
+    matches += expected;
+  }
+  EXPECT_EQ(kURLCount / 2, matches);
+}
+
+TEST_F(URLPatternMatcherPerfTest, Compile) {
+  base::ElapsedTimer timer;
+  URLPatternMatcher matcher(patterns_);
+  perf_test::PerfResultReporter reporter("URLPatternMatcher", "compile");
+  reporter.RegisterImportantMetric("_time", "ms");
+  reporter.AddResult("_time", timer.Elapsed().InMillisecondsF());
+}
+
+TEST_F(URLPatternMatcherPerfTest, LinearScan) {
+  base::ElapsedTimer timer;
+  int matches = 0;
+  for (const GURL& url : urls_)
+    matches += MatchesLinearly(url);
+  Report("linear", timer.Elapsed());
+  EXPECT_GT(matches, 0);
+}
+
+TEST_F(URLPatternMatcherPerfTest, Indexed) {
+  URLPatternMatcher matcher(patterns_);
+  base::ElapsedTimer timer;
+  int matches = 0;
+  for (const GURL& url : urls_)
+    matches += matcher.MatchesURL(url);
+  Report("indexed", timer.Elapsed());
+  EXPECT_GT(matches, 0);
+}
+
+}  // namespace electron
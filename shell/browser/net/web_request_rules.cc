@@ -0,0 +1,153 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/web_request_rules.h"
+
+#include <utility>
+
+#include "base/containers/contains.h"
+#include "base/notreached.h"
+#include "extensions/browser/api/web_request/web_request_info.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "url/url_constants.h"
+
+namespace electron {
+
+namespace {
+
+// The secure equivalent of |url|, or an empty GURL if there is none.
+GURL UpgradeScheme(const GURL& url) {
+  const char* scheme = nullptr;
+  if (url.SchemeIs(url::kHttpScheme))
+    scheme = url::kHttpsScheme;
+  else if (url.SchemeIs(url::kWsScheme))
+    scheme = url::kWssScheme;
+  else
+    return GURL();
+
+  GURL::Replacements replacements;
+  replacements.SetSchemeStr(scheme);
+  return url.ReplaceComponents(replacements);
+}
+
+}  // namespace
+
+WebRequestRules::Rule::Rule() = default;
+WebRequestRules::Rule::Rule(Rule&&) = default;
+WebRequestRules::Rule& WebRequestRules::Rule::operator=(Rule&&) = default;
+WebRequestRules::Rule::~Rule() = default;
+
+WebRequestRules::WebRequestRules() = default;
+
+WebRequestRules::~WebRequestRules() = default;
+
+void WebRequestRules::SetRules(std::vector<Rule> rules) {
+  rules_ = std::move(rules);
+  before_request_.clear();
+  before_send_headers_.clear();
+  headers_received_.clear();
+  for (size_t i = 0; i < rules_.size(); ++i) {
+    const Rule& rule = rules_[i];
+    if (rule.action != Action::kModifyHeaders) {
+      before_request_.push_back(i);
+      continue;
+    }
+    if (!rule.set_request_headers.empty() ||
+        !rule.remove_request_headers.empty())
+      before_send_headers_.push_back(i);
+    if (!rule.set_response_headers.empty() ||
+        !rule.remove_response_headers.empty())
+      headers_received_.push_back(i);
+  }
+}
+
+int WebRequestRules::OnBeforeRequest(const extensions::WebRequestInfo& info,
+                                     GURL* new_url) const {
+  for (const size_t i : before_request_) {
+    const Rule& rule = rules_[i];
+    if (!Matches(rule, info))
+      continue;
+
+    switch (rule.action) {
+      case Action::kBlock:
+        return net::ERR_BLOCKED_BY_CLIENT;
+      case Action::kRedirect:
+        // Redirecting a request to itself would loop forever.
+        if (rule.redirect_url == info.url)
+          continue;
+        *new_url = rule.redirect_url;
+        return net::OK;
+      case Action::kUpgradeScheme: {
+        GURL upgraded = UpgradeScheme(info.url);
+        if (upgraded.is_empty())
+          continue;
+        *new_url = std::move(upgraded);
+        return net::OK;
+      }
+      case Action::kModifyHeaders:
+        NOTREACHED();
+        break;
+    }
+  }
+  return net::OK;
+}
+
+void WebRequestRules::OnBeforeSendHeaders(
+    const extensions::WebRequestInfo& info,
+    net::HttpRequestHeaders* headers) const {
+  for (const size_t i : before_send_headers_) {
+    const Rule& rule = rules_[i];
+    if (!Matches(rule, info))
+      continue;
+    for (const auto& name : rule.remove_request_headers)
+      headers->RemoveHeader(name);
+    for (const auto& header : rule.set_request_headers)
+      headers->SetHeader(header.first, header.second);
+  }
+}
+
+void WebRequestRules::OnHeadersReceived(
+    const extensions::WebRequestInfo& info,
+    const net::HttpResponseHeaders* original_response_headers,
+    scoped_refptr<net::HttpResponseHeaders>* override_response_headers) const {
+  if (!original_response_headers)
+    return;
+
+  for (const size_t i : headers_received_) {
+    const Rule& rule = rules_[i];
+    if (!Matches(rule, info))
+      continue;
+    // The original headers are only copied once a rule applies.
+    if (!*override_response_headers) {
+      *override_response_headers =
+          base::MakeRefCounted<net::HttpResponseHeaders>(
+              original_response_headers->raw_headers());
+    }
+    for (const auto& name : rule.remove_response_headers)
+      (*override_response_headers)->RemoveHeader(name);
+    for (const auto& header : rule.set_response_headers)
+      (*override_response_headers)->SetHeader(header.first, header.second);
+  }
+}
+
+// static
+bool WebRequestRules::Matches(const Rule& rule,
+                              const extensions::WebRequestInfo& info) {
+  if (!rule.resource_types.empty() &&
+      !base::Contains(rule.resource_types, info.web_request_type))
+    return false;
+
+  if (!rule.initiators.is_empty()) {
+    // Browser-initiated requests and opaque origins have nothing to match.
+    if (!info.initiator || info.initiator->opaque() ||
+        !rule.initiators.MatchesURL(info.initiator->GetURL()))
+      return false;
+  }
+
+  return rule.urls.MatchesURL(info.url);
+}
+
+}  // namespace electron
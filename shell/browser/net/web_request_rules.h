@@ -0,0 +1,99 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ELECTRON_SHELL_BROWSER_NET_WEB_REQUEST_RULES_H_
+#define ELECTRON_SHELL_BROWSER_NET_WEB_REQUEST_RULES_H_
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/memory/scoped_refptr.h"
+#include "extensions/browser/api/web_request/web_request_resource_type.h"
+#include "shell/browser/net/url_pattern_matcher.h"
+#include "url/gurl.h"
+
+namespace extensions {
+struct WebRequestInfo;
+}
+
+namespace net {
+class HttpRequestHeaders;
+class HttpResponseHeaders;
+}  // namespace net
+
+namespace electron {
+
+// Declarative webRequest rules, evaluated natively for every request so that
+// blocking, redirecting and rewriting headers never has to enter JavaScript.
+class WebRequestRules {
+ public:
+  using Headers = std::vector<std::pair<std::string, std::string>>;
+
+  enum class Action {
+    kBlock,
+    kRedirect,
+    kUpgradeScheme,
+    kModifyHeaders,
+  };
+
+  struct Rule {
+    Rule();
+    Rule(Rule&&);
+    Rule& operator=(Rule&&);
+    ~Rule();
+
+    // An empty condition matches every request.
+    URLPatternMatcher urls;
+    URLPatternMatcher initiators;
+    std::set<extensions::WebRequestResourceType> resource_types;
+
+    Action action = Action::kBlock;
+    GURL redirect_url;
+    Headers set_request_headers;
+    std::vector<std::string> remove_request_headers;
+    Headers set_response_headers;
+    std::vector<std::string> remove_response_headers;
+  };
+
+  WebRequestRules();
+  ~WebRequestRules();
+
+  // disable copy
+  WebRequestRules(const WebRequestRules&) = delete;
+  WebRequestRules& operator=(const WebRequestRules&) = delete;
+
+  void SetRules(std::vector<Rule> rules);
+
+  bool empty() const { return rules_.empty(); }
+
+  // The first matching block, redirect or upgradeScheme rule decides the fate
+  // of the request. Returns net::ERR_BLOCKED_BY_CLIENT to cancel it, otherwise
+  // net::OK with |new_url| set when it is redirected.
+  int OnBeforeRequest(const extensions::WebRequestInfo& info,
+                      GURL* new_url) const;
+
+  // Apply every matching modifyHeaders rule, in order.
+  void OnBeforeSendHeaders(const extensions::WebRequestInfo& info,
+                           net::HttpRequestHeaders* headers) const;
+  void OnHeadersReceived(
+      const extensions::WebRequestInfo& info,
+      const net::HttpResponseHeaders* original_response_headers,
+      scoped_refptr<net::HttpResponseHeaders>* override_response_headers) const;
+
+ private:
+  static bool Matches(const Rule& rule, const extensions::WebRequestInfo& info);
+
+  std::vector<Rule> rules_;
+  // Indices into |rules_| of the rules acting in each stage, so that a stage
+  // only looks at the rules that can change its outcome.
+  std::vector<size_t> before_request_;
+  std::vector<size_t> before_send_headers_;
+  std::vector<size_t> headers_received_;
+};
+
+}  // namespace electron
+
+#endif  // ELECTRON_SHELL_BROWSER_NET_WEB_REQUEST_RULES_H_
@@ -0,0 +1,155 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/web_request_rules.h"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "extensions/browser/api/web_request/web_request_info.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "url/origin.h"
+
+namespace electron {
+
+namespace {
+
+constexpr int kBlockedHostCount = 10000;
+constexpr int kRequestCount = 10000;
+
+URLPatternMatcher CompilePatterns(const std::vector<std::string>& specs) {
+  std::set<URLPattern> patterns;
+  for (const std::string& spec : specs) {
+    URLPattern pattern(URLPattern::SCHEME_ALL);
+    EXPECT_EQ(URLPattern::ParseResult::kSuccess, pattern.Parse(spec));
+    patterns.insert(pattern);
+  }
+  return URLPatternMatcher(patterns);
+}
+
+class WebRequestRulesPerfTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    // A content blocker's worth of hosts in a single rule, followed by the
+    // other kinds of rules a session typically combines with it.
+    std::vector<std::string> blocked;
+    for (int i = 0; i < kBlockedHostCount; ++i)
+      blocked.push_back(base::StringPrintf("*://*.tracker%d.com/*", i));
+
+    std::vector<WebRequestRules::Rule> rules(4);
+    rules[0].urls = CompilePatterns(blocked);
+    rules[0].action = WebRequestRules::Action::kBlock;
+    rules[1].urls = CompilePatterns({"http://*/*"});
+    rules[1].resource_types = {extensions::WebRequestResourceType::MAIN_FRAME};
+    rules[1].action = WebRequestRules::Action::kUpgradeScheme;
+    rules[2].initiators = CompilePatterns({"https://*.example.com/*"});
+    rules[2].action = WebRequestRules::Action::kModifyHeaders;
+    rules[2].set_request_headers = {{"User-Agent", "Electron"}};
+    rules[3].urls = CompilePatterns({"https://*/*"});
+    rules[3].action = WebRequestRules::Action::kModifyHeaders;
+    rules[3].set_response_headers = {{"X-Frame-Options", "DENY"}};
+    rules[3].remove_response_headers = {"Server"};
+    rules_.SetRules(std::move(rules));
+
+    // A quarter of the requests are blocked.
+    const url::Origin initiator =
+        url::Origin::Create(GURL("https://www.example.com"));
+    for (int i = 0; i < kRequestCount; ++i) {
+      extensions::WebRequestInfoInitParams params;
+      params.id = i;
+      if (i % 4 == 0) {
+        params.url = GURL(base::StringPrintf(
+            "https://ads.tracker%d.com/pixel.gif", (i * 7919) % 10000));
+        params.web_request_type = extensions::WebRequestResourceType::IMAGE;
+      } else {
+        params.url =
+            GURL(base::StringPrintf("https://www.site%d.net/app.js", i));
+        params.web_request_type = extensions::WebRequestResourceType::SCRIPT;
+      }
+      params.initiator = initiator;
+      requests_.push_back(
+          std::make_unique<extensions::WebRequestInfo>(std::move(params)));
+    }
+
+    response_headers_ = net::HttpResponseHeaders::TryToCreate(
+        "HTTP/1.1 200 OK\r\nServer: test\r\nContent-Type: text/html\r\n\r\n");
+    ASSERT_TRUE(response_headers_);
+  }
+
+  // Run every request through the stages a rule can act in.
+  int RunRequests() {
+    int blocked = 0;
+    for (const auto& info : requests_) {
+      GURL new_url;
+      if (rules_.OnBeforeRequest(*info, &new_url) != net::OK) {
+        ++blocked;
+        continue;
+      }
+      net::HttpRequestHeaders headers;
+      headers.SetHeader("Accept", "*/*");
+      rules_.OnBeforeSendHeaders(*info, &headers);
+      scoped_refptr<net::HttpResponseHeaders> override_headers;
+      rules_.OnHeadersReceived(*info, response_headers_.get(),
+                               &override_headers);
+    }
+    return blocked;
+  }
+
+  WebRequestRules rules_;
+  std::vector<std::unique_ptr<extensions::WebRequestInfo>> requests_;
+  scoped_refptr<net::HttpResponseHeaders> response_headers_;
+};
+
+}  // namespace
+
+TEST_F(WebRequestRulesPerfTest, AppliesRules) {
+  const auto& blocked = *requests_[0];
+  GURL new_url;
+  EXPECT_EQ(net::ERR_BLOCKED_BY_CLIENT,
+            rules_.OnBeforeRequest(blocked, &new_url));
+
+  const auto& allowed = *requests_[1];
+  EXPECT_EQ(net::OK, rules_.OnBeforeRequest(allowed, &new_url));
+  EXPECT_TRUE(new_url.is_empty());
+
+  net::HttpRequestHeaders headers;
+  rules_.OnBeforeSendHeaders(allowed, &headers);
+  std::string value;
+  EXPECT_TRUE(headers.GetHeader("User-Agent", &value));
+  EXPECT_EQ("Electron", value);
+
+  scoped_refptr<net::HttpResponseHeaders> override_headers;
+  rules_.OnHeadersReceived(allowed, response_headers_.get(),
+                           &override_headers);
+  ASSERT_TRUE(override_headers);
+  EXPECT_FALSE(override_headers->HasHeader("Server"));
+  EXPECT_TRUE(override_headers->HasHeaderValue("X-Frame-Options", "DENY"));
+  EXPECT_TRUE(response_headers_->HasHeader("Server"));
+}
+
+TEST_F(WebRequestRulesPerfTest, Throughput) {
+  base::ElapsedTimer timer;
+  const int blocked = RunRequests();
+  const base::TimeDelta elapsed = timer.Elapsed();
+  EXPECT_EQ(kRequestCount / 4, blocked);
+
+  perf_test::PerfResultReporter reporter("WebRequestRules", "throughput");
+  reporter.RegisterImportantMetric("_requests_per_second", "count");
+  reporter.RegisterImportantMetric("_time_per_request", "ns");
+  reporter.AddResult("_requests_per_second",
+                     kRequestCount / elapsed.InSecondsF());
+  reporter.AddResult("_time_per_request",
+                     elapsed.InMicrosecondsF() * 1000 / kRequestCount);
+}
+
+}  // namespace electron
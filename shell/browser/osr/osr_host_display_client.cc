@@ -29,6 +29,8 @@ LayeredWindowUpdater::LayeredWindowUpdater(
 LayeredWindowUpdater::~LayeredWindowUpdater() = default;
 
 void LayeredWindowUpdater::SetActive(bool active) {
+  if (active && !active_)
+    needs_full_update_ = true;
   active_ = active;
 }
 
@@ -36,6 +38,7 @@ void LayeredWindowUpdater::OnAllocatedSharedMemory(
     const gfx::Size& pixel_size,
     base::UnsafeSharedMemoryRegion region) {
   canvas_.reset();
+  needs_full_update_ = true;
 
   if (!region.IsValid())
     return;
@@ -69,9 +72,15 @@ void LayeredWindowUpdater::Draw(const gfx::Rect& damage_rect,
   SkPixmap pixmap;
   SkBitmap bitmap;
 
-  if (active_ && canvas_->peekPixels(&pixmap)) {
+  if (active_ && canvas_ && canvas_->peekPixels(&pixmap)) {
     bitmap.installPixels(pixmap);
-    callback_.Run(damage_rect, bitmap);
+    callback_.Run(needs_full_update_
+                      ? gfx::Rect(pixmap.width(), pixmap.height())
+                      : damage_rect,
+                  bitmap);
+    needs_full_update_ = false;
+  } else {
+    needs_full_update_ = true;
   }
 
   std::move(draw_callback).Run();
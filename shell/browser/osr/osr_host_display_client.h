@@ -43,6 +43,10 @@ class LayeredWindowUpdater : public viz::mojom::LayeredWindowUpdater {
   mojo::Receiver<viz::mojom::LayeredWindowUpdater> receiver_;
   std::unique_ptr<SkCanvas> canvas_;
   bool active_ = false;
+  // The damage rect of a frame only covers what changed since the frame
+  // before it, so after dropping a frame the next one is reported as
+  // entirely damaged.
+  bool needs_full_update_ = true;
 
 #if !defined(WIN32)
   base::WritableSharedMemoryMapping shm_mapping_;
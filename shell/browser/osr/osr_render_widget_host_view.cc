@@ -43,6 +43,7 @@
 #include "ui/gfx/canvas.h"
 #include "ui/gfx/geometry/dip_util.h"
 #include "ui/gfx/geometry/size_conversions.h"
+#include "ui/gfx/geometry/skia_conversions.h"
 #include "ui/gfx/image/image_skia.h"
 #include "ui/gfx/native_widget_types.h"
 #include "ui/gfx/skbitmap_operations.h"
@@ -233,7 +234,7 @@ OffScreenRenderWidgetHostView::OffScreenRenderWidgetHostView(
     video_consumer_ = std::make_unique<OffScreenVideoConsumer>(
         this, base::BindRepeating(&OffScreenRenderWidgetHostView::OnPaint,
                                   weak_ptr_factory_.GetWeakPtr()));
-    video_consumer_->SetActive(IsPainting());
+    video_consumer_->SetActive(ShouldProduceFrames());
     video_consumer_->SetFrameRate(GetFrameRate());
   }
 }
@@ -262,6 +263,7 @@ void OffScreenRenderWidgetHostView::InitAsChild(gfx::NativeView) {
   parent_host_view_->Hide();
 
   ResizeRootLayer(false);
+  frames_paused_ = parent_host_view_->frames_paused_;
   SetPainting(parent_host_view_->IsPainting());
 }
 
@@ -414,6 +416,7 @@ void OffScreenRenderWidgetHostView::InitAsPopup(
   popup_position_ = pos;
 
   ResizeRootLayer(false);
+  frames_paused_ = parent_host_view_->frames_paused_;
   SetPainting(parent_host_view_->IsPainting());
   if (video_consumer_) {
     video_consumer_->SizeChanged();
@@ -638,7 +641,7 @@ OffScreenRenderWidgetHostView::CreateHostDisplayClient(
       gfx::kNullAcceleratedWidget,
       base::BindRepeating(&OffScreenRenderWidgetHostView::OnPaint,
                           weak_ptr_factory_.GetWeakPtr()));
-  host_display_client_->SetActive(IsPainting());
+  host_display_client_->SetActive(ShouldProduceFrames());
   return base::WrapUnique(host_display_client_);
 }
 
@@ -675,9 +678,33 @@ bool OffScreenRenderWidgetHostView::UpdateNSViewAndDisplay() {
 
 void OffScreenRenderWidgetHostView::OnPaint(const gfx::Rect& damage_rect,
                                             const SkBitmap& bitmap) {
-  backing_ = std::make_unique<SkBitmap>();
-  backing_->allocN32Pixels(bitmap.width(), bitmap.height(), !transparent_);
-  bitmap.readPixels(backing_->pixmap());
+  // |damage_rect| is what changed since the previous frame, so when nothing
+  // else holds on to the pixels of the backing, e.g. a NativeImage from an
+  // earlier paint event, only that region needs to be copied into it. That
+  // only holds if the backing has every frame before this one, which is not
+  // the case after painting was stopped.
+  const SkAlphaType alpha_type =
+      transparent_ ? kPremul_SkAlphaType : kOpaque_SkAlphaType;
+  const gfx::Rect damage = gfx::IntersectRects(
+      damage_rect, gfx::Rect(bitmap.width(), bitmap.height()));
+  if (!needs_full_update_ && backing_->width() == bitmap.width() &&
+      backing_->height() == bitmap.height() &&
+      backing_->alphaType() == alpha_type && backing_->pixelRef() &&
+      backing_->pixelRef()->unique() && !backing_->isImmutable()) {
+    SkPixmap damaged_pixels;
+    if (backing_->pixmap().extractSubset(&damaged_pixels,
+                                         gfx::RectToSkIRect(damage))) {
+      bitmap.readPixels(damaged_pixels, damage.x(), damage.y());
+      // Skia caches derived data, like images, by the generation ID of the
+      // pixels, which has to change when they are written in place.
+      backing_->notifyPixelsChanged();
+    }
+  } else {
+    backing_ = std::make_unique<SkBitmap>();
+    backing_->allocN32Pixels(bitmap.width(), bitmap.height(), !transparent_);
+    bitmap.readPixels(backing_->pixmap());
+  }
+  needs_full_update_ = false;
 
   if (IsPopupWidget() && parent_callback_) {
     parent_callback_.Run(this->popup_position_);
@@ -905,6 +932,8 @@ void OffScreenRenderWidgetHostView::SendMouseWheelEvent(
 }
 
 void OffScreenRenderWidgetHostView::SetPainting(bool painting) {
+  if (painting && !painting_)
+    needs_full_update_ = true;
   painting_ = painting;
 
   if (popup_host_view_) {
@@ -915,9 +944,9 @@ void OffScreenRenderWidgetHostView::SetPainting(bool painting) {
     guest_host_view->SetPainting(painting);
 
   if (video_consumer_) {
-    video_consumer_->SetActive(IsPainting());
+    video_consumer_->SetActive(ShouldProduceFrames());
   } else if (host_display_client_) {
-    host_display_client_->SetActive(IsPainting());
+    host_display_client_->SetActive(ShouldProduceFrames());
   }
 }
 
@@ -925,6 +954,31 @@ bool OffScreenRenderWidgetHostView::IsPainting() const {
   return painting_;
 }
 
+void OffScreenRenderWidgetHostView::SetFramesPaused(bool paused) {
+  if (frames_paused_ == paused)
+    return;
+  frames_paused_ = paused;
+  if (!paused)
+    needs_full_update_ = true;
+
+  if (popup_host_view_)
+    popup_host_view_->SetFramesPaused(paused);
+
+  if (video_consumer_) {
+    video_consumer_->SetActive(ShouldProduceFrames());
+  } else if (host_display_client_) {
+    host_display_client_->SetActive(ShouldProduceFrames());
+  }
+
+  // What changed while frames were paused is painted in a new frame.
+  if (!paused && compositor_)
+    compositor_->ScheduleFullRedraw();
+}
+
+bool OffScreenRenderWidgetHostView::ShouldProduceFrames() const {
+  return painting_ && !frames_paused_;
+}
+
 void OffScreenRenderWidgetHostView::SetFrameRate(int frame_rate) {
   if (parent_host_view_) {
     if (parent_host_view_->GetFrameRate() == GetFrameRate())
@@ -985,6 +1039,9 @@ void OffScreenRenderWidgetHostView::Invalidate() {
 }
 
 void OffScreenRenderWidgetHostView::InvalidateBounds(const gfx::Rect& bounds) {
+  // Resuming frames paints everything anyway.
+  if (frames_paused_)
+    return;
   CompositeFrame(bounds);
 }
 
@@ -206,6 +206,11 @@ class OffScreenRenderWidgetHostView : public content::RenderWidgetHostViewBase,
   void SetPainting(bool painting);
   bool IsPainting() const;
 
+  // Stops producing frames while painting, for as long as the consumer of the
+  // frames can't take any more. Once resumed, the next frame is painted in
+  // full.
+  void SetFramesPaused(bool paused);
+
   void SetFrameRate(int frame_rate);
   int GetFrameRate() const;
 
@@ -233,6 +238,7 @@ class OffScreenRenderWidgetHostView : public content::RenderWidgetHostViewBase,
  private:
   void SetupFrameRate(bool force);
   void ResizeRootLayer(bool force);
+  bool ShouldProduceFrames() const;
 
   viz::FrameSinkId AllocateFrameSinkId();
 
@@ -261,6 +267,7 @@ class OffScreenRenderWidgetHostView : public content::RenderWidgetHostViewBase,
   gfx::Vector2dF last_scroll_offset_;
   gfx::Size size_;
   bool painting_;
+  bool frames_paused_ = false;
 
   bool is_showing_ = false;
   bool is_destroyed_ = false;
@@ -299,6 +306,9 @@ class OffScreenRenderWidgetHostView : public content::RenderWidgetHostViewBase,
   SkColor background_color_ = SkColor();
 
   std::unique_ptr<SkBitmap> backing_;
+  // Whether the next frame has to be copied into |backing_| in full, because
+  // frames may have been missed since the last one it was updated with.
+  bool needs_full_update_ = true;
 
   base::WeakPtrFactory<OffScreenRenderWidgetHostView> weak_ptr_factory_{this};
 };
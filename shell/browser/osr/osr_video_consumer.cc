@@ -33,6 +33,7 @@ OffScreenVideoConsumer::~OffScreenVideoConsumer() = default;
 
 void OffScreenVideoConsumer::SetActive(bool active) {
   if (active) {
+    needs_full_update_ = true;
     video_capturer_->Start(this, viz::mojom::BufferFormatPreference::kDefault);
   } else {
     video_capturer_->Stop();
@@ -61,6 +62,7 @@ void OffScreenVideoConsumer::OnFrameCaptured(
     gfx::Size view_size = view_->SizeInPixels();
     video_capturer_->SetResolutionConstraints(view_size, view_size, true);
     video_capturer_->RequestRefreshFrame();
+    needs_full_update_ = true;
     return;
   }
 
@@ -68,18 +70,21 @@ void OffScreenVideoConsumer::OnFrameCaptured(
       callbacks_remote(std::move(callbacks));
 
   if (!data_region.IsValid()) {
+    needs_full_update_ = true;
     callbacks_remote->Done();
     return;
   }
   base::ReadOnlySharedMemoryMapping mapping = data_region.Map();
   if (!mapping.IsValid()) {
     DLOG(ERROR) << "Shared memory mapping failed.";
+    needs_full_update_ = true;
     callbacks_remote->Done();
     return;
   }
   if (mapping.size() <
       media::VideoFrame::AllocationSize(info->pixel_format, info->coded_size)) {
     DLOG(ERROR) << "Shared memory size was less than expected.";
+    needs_full_update_ = true;
     callbacks_remote->Done();
     return;
   }
@@ -114,9 +119,11 @@ void OffScreenVideoConsumer::OnFrameCaptured(
   bitmap.setImmutable();
 
   absl::optional<gfx::Rect> update_rect = info->metadata.capture_update_rect;
-  if (!update_rect.has_value() || update_rect->IsEmpty()) {
+  if (!update_rect.has_value() || update_rect->IsEmpty() ||
+      needs_full_update_) {
     update_rect = content_rect;
   }
+  needs_full_update_ = false;
 
   callback_.Run(*update_rect, bitmap);
 }
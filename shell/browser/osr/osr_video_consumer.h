@@ -53,6 +53,11 @@ class OffScreenVideoConsumer : public viz::mojom::FrameSinkVideoConsumer {
   OffScreenRenderWidgetHostView* view_;
   std::unique_ptr<viz::ClientFrameSinkVideoCapturer> video_capturer_;
 
+  // The update rect of a captured frame only covers what changed since the
+  // frame before it, so after dropping a frame the next one is reported as
+  // entirely updated.
+  bool needs_full_update_ = true;
+
   base::WeakPtrFactory<OffScreenVideoConsumer> weak_ptr_factory_{this};
 };
 
@@ -0,0 +1,278 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/preload_script_cache.h"
+
+#include <cstring>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/bind_post_task.h"
+#include "base/callback_helpers.h"
+#include "base/containers/contains.h"
+#include "base/files/file.h"
+#include "base/files/file_path_watcher.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/strings/stringprintf.h"
+#include "base/task/task_runner_util.h"
+#include "base/task/thread_pool.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "shell/common/js2c_code_cache.h"
+
+namespace electron {
+
+namespace {
+
+using WatcherPtr =
+    std::unique_ptr<base::FilePathWatcher, base::OnTaskRunnerDeleter>;
+
+// A renderer decides how large the code cache it sends is, a single one must
+// not take up most of the budget.
+constexpr size_t kMaxCodeCacheSize = 16 * 1024 * 1024;
+
+// The budget of the code caches of all sites together.
+constexpr size_t kMaxCodeCacheBytes = 64 * 1024 * 1024;
+
+std::string ReadError(const base::FilePath& path, base::File::Error error) {
+  return base::StringPrintf("Failed to read '%s': %s",
+                            path.AsUTF8Unsafe().c_str(),
+                            base::File::ErrorToString(error).c_str());
+}
+
+}  // namespace
+
+struct PreloadScriptCache::Entry {
+  explicit Entry(WatcherPtr watcher) : watcher(std::move(watcher)) {}
+
+  base::ReadOnlySharedMemoryRegion source;
+  std::string error;
+  // Lives on |file_task_runner_|.
+  WatcherPtr watcher;
+};
+
+struct PreloadScriptCache::ReadResult {
+  explicit ReadResult(WatcherPtr watcher) : watcher(std::move(watcher)) {}
+  ReadResult(ReadResult&&) = default;
+
+  base::ReadOnlySharedMemoryRegion source;
+  std::string error;
+  // Null when the file can not be watched, the script is not cached then.
+  WatcherPtr watcher;
+};
+
+bool PreloadScriptCache::CodeCacheKey::operator<(
+    const CodeCacheKey& other) const {
+  return std::tie(site, paths, path, bundle_id) <
+         std::tie(other.site, other.paths, other.path, other.bundle_id);
+}
+
+PreloadScriptCache::PreloadScriptCache()
+    : PreloadScriptCache(kMaxCodeCacheBytes) {}
+
+PreloadScriptCache::PreloadScriptCache(size_t max_code_cache_bytes)
+    : file_task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+          {base::MayBlock(), base::TaskPriority::USER_BLOCKING,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})),
+      max_code_cache_bytes_(max_code_cache_bytes) {}
+
+PreloadScriptCache::~PreloadScriptCache() = default;
+
+void PreloadScriptCache::Load(const std::vector<base::FilePath>& paths) {
+  for (const base::FilePath& path : paths) {
+    if (entries_.count(path) || pending_.count(path))
+      continue;
+    pending_[path] = false;
+
+    auto on_change = base::BindPostTask(
+        base::SequencedTaskRunnerHandle::Get(),
+        base::BindRepeating(&PreloadScriptCache::OnChanged,
+                            weak_factory_.GetWeakPtr(), path));
+    base::PostTaskAndReplyWithResult(
+        file_task_runner_.get(), FROM_HERE,
+        base::BindOnce(&PreloadScriptCache::ReadScript, path, on_change),
+        base::BindOnce(&PreloadScriptCache::OnRead, weak_factory_.GetWeakPtr(),
+                       path));
+  }
+}
+
+absl::optional<std::vector<mojom::PreloadScriptPtr>>
+PreloadScriptCache::GetScripts(const std::vector<base::FilePath>& paths,
+                               const GURL& site) {
+  std::vector<mojom::PreloadScriptPtr> scripts;
+  for (const base::FilePath& path : paths) {
+    auto it = entries_.find(path);
+    if (it == entries_.end()) {
+      Load(paths);
+      return absl::nullopt;
+    }
+    const Entry& entry = *it->second;
+    base::ReadOnlySharedMemoryRegion code_cache;
+    auto code_cache_it =
+        code_caches_.find(CodeCacheKey{site, paths, path, std::string()});
+    if (code_cache_it != code_caches_.end())
+      code_cache = UseCodeCache(code_cache_it);
+    scripts.push_back(mojom::PreloadScript::New(
+        path,
+        entry.source.IsValid()
+            ? absl::make_optional(entry.source.Duplicate())
+            : absl::nullopt,
+        entry.error,
+        code_cache.IsValid() ? absl::make_optional(std::move(code_cache))
+                             : absl::nullopt));
+  }
+  return scripts;
+}
+
+void PreloadScriptCache::SetCodeCache(const base::FilePath& path,
+                                      const std::vector<base::FilePath>& paths,
+                                      const GURL& site,
+                                      base::span<const uint8_t> data) {
+  if (!base::Contains(paths, path) || !entries_.count(path))
+    return;
+  StoreCodeCache(CodeCacheKey{site, paths, path, std::string()}, data);
+}
+
+base::flat_map<std::string, base::ReadOnlySharedMemoryRegion>
+PreloadScriptCache::GetJs2cCodeCaches(const GURL& site) {
+  base::flat_map<std::string, base::ReadOnlySharedMemoryRegion> caches;
+  // The keys of the js2c bundles have no preload scripts and come first.
+  for (auto it = code_caches_.lower_bound(CodeCacheKey{site});
+       it != code_caches_.end() && it->first.site == site &&
+       it->first.paths.empty();
+       ++it) {
+    caches[it->first.bundle_id] = UseCodeCache(it);
+  }
+  return caches;
+}
+
+void PreloadScriptCache::SetJs2cCodeCache(const std::string& id,
+                                          const GURL& site,
+                                          base::span<const uint8_t> data) {
+  if (!IsRendererJs2cBundle(id))
+    return;
+  StoreCodeCache(CodeCacheKey{site, {}, base::FilePath(), id}, data);
+}
+
+// static
+PreloadScriptCache::ReadResult PreloadScriptCache::ReadScript(
+    const base::FilePath& path,
+    const base::RepeatingClosure& on_change) {
+  // Watch before reading, so that no change after the read is missed.
+  ReadResult result(WatcherPtr(
+      new base::FilePathWatcher,
+      base::OnTaskRunnerDeleter(base::SequencedTaskRunnerHandle::Get())));
+  // A script whose changes would be missed is not cached, it is read again
+  // for every renderer instead.
+  if (!result.watcher->Watch(
+          path, base::FilePathWatcher::Type::kNonRecursive,
+          base::BindRepeating(
+              [](const base::RepeatingClosure& on_change,
+                 const base::FilePath&, bool error) { on_change.Run(); },
+              on_change))) {
+    result.watcher.reset();
+    return result;
+  }
+
+  base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (!file.IsValid()) {
+    result.error = ReadError(path, file.error_details());
+    return result;
+  }
+  int64_t length = file.GetLength();
+  if (length < 0 || length > std::numeric_limits<int>::max()) {
+    result.error = ReadError(path, base::File::GetLastFileError());
+    return result;
+  }
+  if (length == 0)
+    return result;
+
+  // Read straight into the region that is shared with the renderers.
+  base::MappedReadOnlyRegion mapped =
+      base::ReadOnlySharedMemoryRegion::Create(length);
+  if (!mapped.IsValid()) {
+    result.error = ReadError(path, base::File::FILE_ERROR_NO_MEMORY);
+    return result;
+  }
+  int size = static_cast<int>(length);
+  if (file.Read(0, static_cast<char*>(mapped.mapping.memory()), size) !=
+      size) {
+    result.error = ReadError(path, base::File::GetLastFileError());
+    return result;
+  }
+  result.source = std::move(mapped.region);
+  return result;
+}
+
+void PreloadScriptCache::OnRead(const base::FilePath& path,
+                                ReadResult result) {
+  bool changed = pending_[path];
+  pending_.erase(path);
+  // Read it again the next time it is needed.
+  if (changed || !result.watcher)
+    return;
+
+  auto entry = std::make_unique<Entry>(std::move(result.watcher));
+  entry->source = std::move(result.source);
+  entry->error = std::move(result.error);
+  entries_[path] = std::move(entry);
+}
+
+void PreloadScriptCache::OnChanged(const base::FilePath& path) {
+  auto it = pending_.find(path);
+  if (it != pending_.end())
+    it->second = true;
+  entries_.erase(path);
+  for (auto code_cache_it = code_caches_.begin();
+       code_cache_it != code_caches_.end();) {
+    if (code_cache_it->first.path == path)
+      EraseCodeCache(code_cache_it++);
+    else
+      ++code_cache_it;
+  }
+}
+
+base::ReadOnlySharedMemoryRegion PreloadScriptCache::UseCodeCache(
+    CodeCacheMap::iterator it) {
+  code_cache_uses_.erase(it->second.last_use);
+  it->second.last_use = next_code_cache_use_++;
+  code_cache_uses_[it->second.last_use] = it->first;
+  return it->second.region.Duplicate();
+}
+
+void PreloadScriptCache::StoreCodeCache(CodeCacheKey key,
+                                        base::span<const uint8_t> data) {
+  if (data.empty() || data.size() > kMaxCodeCacheSize ||
+      data.size() > max_code_cache_bytes_)
+    return;
+  auto it = code_caches_.find(key);
+  if (it != code_caches_.end())
+    EraseCodeCache(it);
+  // Make room by dropping the code caches that were used least recently.
+  while (code_cache_bytes_ + data.size() > max_code_cache_bytes_)
+    EraseCodeCache(code_caches_.find(code_cache_uses_.begin()->second));
+
+  base::MappedReadOnlyRegion mapped =
+      base::ReadOnlySharedMemoryRegion::Create(data.size());
+  if (!mapped.IsValid())
+    return;
+  memcpy(mapped.mapping.memory(), data.data(), data.size());
+
+  CodeCache& code_cache = code_caches_[key];
+  code_cache.region = std::move(mapped.region);
+  code_cache.size = data.size();
+  code_cache.last_use = next_code_cache_use_++;
+  code_cache_uses_[code_cache.last_use] = std::move(key);
+  code_cache_bytes_ += data.size();
+}
+
+void PreloadScriptCache::EraseCodeCache(CodeCacheMap::iterator it) {
+  code_cache_bytes_ -= it->second.size;
+  code_cache_uses_.erase(it->second.last_use);
+  code_caches_.erase(it);
+}
+
+}  // namespace electron
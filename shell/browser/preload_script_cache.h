@@ -0,0 +1,139 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ELECTRON_SHELL_BROWSER_PRELOAD_SCRIPT_CACHE_H_
+#define ELECTRON_SHELL_BROWSER_PRELOAD_SCRIPT_CACHE_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/containers/flat_map.h"
+#include "base/containers/span.h"
+#include "base/files/file_path.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/task/sequenced_task_runner.h"
+#include "shell/common/api/api.mojom.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+#include "url/gurl.h"
+
+namespace electron {
+
+// Holds the preload scripts of a session in read-only shared memory, so that
+// every sandboxed renderer gets them without a synchronous IPC and without
+// reading them again. A script is dropped from the cache when its file
+// changes.
+//
+// Renderers hand the code cache they create for a script back to the browser.
+// It is only shared with renderers of the same site that run the same preload
+// scripts, a compromised renderer must not be able to provide the bytecode
+// another site's preload runs. The code caches renderers create for
+// Electron's own js2c bundles are kept and shared per site the same way.
+//
+// The code caches of all sites together are kept within a byte budget, the
+// least recently used ones are dropped to make room for a new one.
+class PreloadScriptCache {
+ public:
+  PreloadScriptCache();
+  explicit PreloadScriptCache(size_t max_code_cache_bytes);
+  ~PreloadScriptCache();
+
+  // disable copy
+  PreloadScriptCache(const PreloadScriptCache&) = delete;
+  PreloadScriptCache& operator=(const PreloadScriptCache&) = delete;
+
+  // Starts reading the scripts at |paths| that are not cached yet.
+  void Load(const std::vector<base::FilePath>& paths);
+
+  // Returns the scripts at |paths| along with the code caches created by
+  // renderers of |site| that run the same scripts, or nothing if any of them
+  // is not cached yet.
+  absl::optional<std::vector<mojom::PreloadScriptPtr>> GetScripts(
+      const std::vector<base::FilePath>& paths,
+      const GURL& site);
+
+  // Stores the code cache a renderer of |site| that runs the scripts at
+  // |paths| created for the script at |path|. Ignored when the script is not
+  // cached, is not one of |paths| or when the code cache is too large.
+  // Replaces the code caches that were used least recently when the budget
+  // is exceeded.
+  void SetCodeCache(const base::FilePath& path,
+                    const std::vector<base::FilePath>& paths,
+                    const GURL& site,
+                    base::span<const uint8_t> data);
+
+  // Returns the code caches renderers of |site| created for the js2c bundles,
+  // keyed by bundle id.
+  base::flat_map<std::string, base::ReadOnlySharedMemoryRegion>
+  GetJs2cCodeCaches(const GURL& site);
+
+  // Stores the code cache a renderer of |site| created for the js2c bundle
+  // |id|. Ignored when |id| is not a renderer bundle or when the code cache is
+  // too large. Shares the budget of the preload code caches.
+  void SetJs2cCodeCache(const std::string& id,
+                        const GURL& site,
+                        base::span<const uint8_t> data);
+
+ private:
+  struct Entry;
+  struct ReadResult;
+
+  // A code cache belongs to the site of the renderer that created it, and to
+  // either the preload script at |path| run along with |paths| or the js2c
+  // bundle |bundle_id|.
+  struct CodeCacheKey {
+    GURL site;
+    std::vector<base::FilePath> paths;
+    base::FilePath path;
+    std::string bundle_id;
+
+    bool operator<(const CodeCacheKey& other) const;
+  };
+
+  struct CodeCache {
+    base::ReadOnlySharedMemoryRegion region;
+    size_t size = 0;
+    // The key of the code cache in |code_cache_uses_|.
+    uint64_t last_use = 0;
+  };
+
+  using CodeCacheMap = std::map<CodeCacheKey, CodeCache>;
+
+  static ReadResult ReadScript(const base::FilePath& path,
+                               const base::RepeatingClosure& on_change);
+
+  void OnRead(const base::FilePath& path, ReadResult result);
+  void OnChanged(const base::FilePath& path);
+
+  // Returns a duplicate of the code cache at |it| and marks it as used.
+  base::ReadOnlySharedMemoryRegion UseCodeCache(CodeCacheMap::iterator it);
+  void StoreCodeCache(CodeCacheKey key, base::span<const uint8_t> data);
+  void EraseCodeCache(CodeCacheMap::iterator it);
+
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+
+  std::map<base::FilePath, std::unique_ptr<Entry>> entries_;
+
+  // The scripts being read, mapped to whether they changed in the meantime.
+  std::map<base::FilePath, bool> pending_;
+
+  const size_t max_code_cache_bytes_;
+  CodeCacheMap code_caches_;
+  size_t code_cache_bytes_ = 0;
+  // The keys of |code_caches_| ordered by their last use, oldest first.
+  std::map<uint64_t, CodeCacheKey> code_cache_uses_;
+  uint64_t next_code_cache_use_ = 0;
+
+  base::WeakPtrFactory<PreloadScriptCache> weak_factory_{this};
+};
+
+}  // namespace electron
+
+#endif  // ELECTRON_SHELL_BROWSER_PRELOAD_SCRIPT_CACHE_H_
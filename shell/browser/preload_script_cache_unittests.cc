@@ -0,0 +1,137 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/preload_script_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/task_environment.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace electron {
+
+class PreloadScriptCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    first_ = temp_dir_.GetPath().AppendASCII("first.js");
+    second_ = temp_dir_.GetPath().AppendASCII("second.js");
+    ASSERT_TRUE(base::WriteFile(first_, "first()"));
+    ASSERT_TRUE(base::WriteFile(second_, "second()"));
+    cache_.Load({first_, second_});
+    task_environment_.RunUntilIdle();
+  }
+
+  // Whether the first script comes with a code cache for |site| and |paths|.
+  bool HasCodeCache(const std::vector<base::FilePath>& paths,
+                    const GURL& site) {
+    auto scripts = cache_.GetScripts(paths, site);
+    EXPECT_TRUE(scripts);
+    return scripts && (*scripts)[0]->code_cache.has_value();
+  }
+
+  // FilePathWatcher needs an IO thread.
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::MainThreadType::IO};
+  base::ScopedTempDir temp_dir_;
+  base::FilePath first_;
+  base::FilePath second_;
+  PreloadScriptCache cache_;
+};
+
+TEST_F(PreloadScriptCacheTest, SharesCodeCacheWithinSiteAndPreloads) {
+  const std::vector<base::FilePath> paths = {first_, second_};
+  const GURL site("https://example.com");
+  const std::vector<uint8_t> data(16, 1);
+
+  cache_.SetCodeCache(first_, paths, site, data);
+  EXPECT_TRUE(HasCodeCache(paths, site));
+  EXPECT_FALSE(HasCodeCache(paths, GURL("https://example.org")));
+  EXPECT_FALSE(HasCodeCache({first_}, site));
+}
+
+TEST_F(PreloadScriptCacheTest, IgnoresPathsThatAreNotPreloads) {
+  const GURL site("https://example.com");
+  const std::vector<uint8_t> data(16, 1);
+
+  cache_.SetCodeCache(first_, {second_}, site, data);
+  EXPECT_FALSE(HasCodeCache({second_}, site));
+  EXPECT_FALSE(HasCodeCache({first_}, site));
+}
+
+TEST_F(PreloadScriptCacheTest, IgnoresOversizedCodeCache) {
+  const std::vector<base::FilePath> paths = {first_};
+  const GURL site("https://example.com");
+
+  cache_.SetCodeCache(first_, paths, site,
+                      std::vector<uint8_t>(64 * 1024 * 1024, 1));
+  EXPECT_FALSE(HasCodeCache(paths, site));
+}
+
+TEST_F(PreloadScriptCacheTest, SharesJs2cCodeCacheWithinSite) {
+  const GURL site("https://example.com");
+  const std::vector<uint8_t> data(16, 1);
+
+  cache_.SetJs2cCodeCache("electron/js2c/renderer_init", site, data);
+  // Only the bundles renderers create a code cache for are kept.
+  cache_.SetJs2cCodeCache("electron/js2c/browser_init", site, data);
+  cache_.SetJs2cCodeCache("internal/bootstrap/node", site, data);
+
+  auto caches = cache_.GetJs2cCodeCaches(site);
+  ASSERT_EQ(1u, caches.size());
+  EXPECT_EQ("electron/js2c/renderer_init", caches.begin()->first);
+  EXPECT_TRUE(cache_.GetJs2cCodeCaches(GURL("https://example.org")).empty());
+}
+
+TEST_F(PreloadScriptCacheTest, EvictsLeastRecentlyUsedCodeCache) {
+  PreloadScriptCache cache(32);
+  cache.Load({first_});
+  task_environment_.RunUntilIdle();
+  const std::vector<base::FilePath> paths = {first_};
+  const char kBundle[] = "electron/js2c/renderer_init";
+  const GURL first_site("https://example.com");
+  const GURL second_site("https://example.org");
+  const std::vector<uint8_t> data(16, 1);
+
+  cache.SetCodeCache(first_, paths, first_site, data);
+  cache.SetJs2cCodeCache(kBundle, second_site, data);
+  // Using the preload code cache leaves the bundle's as the least recently
+  // used one.
+  auto scripts = cache.GetScripts(paths, first_site);
+  ASSERT_TRUE(scripts);
+  EXPECT_TRUE((*scripts)[0]->code_cache.has_value());
+
+  cache.SetJs2cCodeCache(kBundle, first_site, data);
+  EXPECT_TRUE(cache.GetJs2cCodeCaches(second_site).empty());
+  EXPECT_EQ(1u, cache.GetJs2cCodeCaches(first_site).size());
+  scripts = cache.GetScripts(paths, first_site);
+  ASSERT_TRUE(scripts);
+  EXPECT_TRUE((*scripts)[0]->code_cache.has_value());
+
+  // A code cache larger than the whole budget is not kept.
+  cache.SetJs2cCodeCache(kBundle, second_site, std::vector<uint8_t>(64, 1));
+  EXPECT_TRUE(cache.GetJs2cCodeCaches(second_site).empty());
+}
+
+TEST_F(PreloadScriptCacheTest, DropsScriptWhenItChanges) {
+  const std::vector<base::FilePath> paths = {first_};
+  const GURL site("https://example.com");
+  cache_.SetCodeCache(first_, paths, site, std::vector<uint8_t>(16, 1));
+  ASSERT_TRUE(HasCodeCache(paths, site));
+
+  ASSERT_TRUE(base::WriteFile(first_, "changed()"));
+  // The watcher reports the change asynchronously.
+  for (int i = 0; i < 100 && cache_.GetScripts(paths, site); ++i) {
+    base::PlatformThread::Sleep(base::Milliseconds(10));
+    task_environment_.RunUntilIdle();
+  }
+  EXPECT_FALSE(cache_.GetScripts(paths, site));
+}
+
+}  // namespace electron
@@ -4,6 +4,8 @@
 
 #include "shell/browser/protocol_registry.h"
 
+#include <utility>
+
 #include "base/stl_util.h"
 #include "content/public/browser/web_contents.h"
 #include "shell/browser/electron_browser_context.h"
@@ -40,17 +42,36 @@ void ProtocolRegistry::RegisterURLLoaderFactories(
 
   for (const auto& it : handlers_) {
     factories->emplace(it.first, ElectronURLLoaderFactory::Create(
-                                     it.second.first, it.second.second));
+                                     it.second.first, it.second.second,
+                                     GetStaticSource(it.first)));
   }
 }
 
+scoped_refptr<StaticProtocolSource> ProtocolRegistry::GetStaticSource(
+    const std::string& scheme) const {
+  auto it = static_sources_.find(scheme);
+  return it != static_sources_.end() ? it->second : nullptr;
+}
+
 bool ProtocolRegistry::RegisterProtocol(ProtocolType type,
                                         const std::string& scheme,
                                         const ProtocolHandler& handler) {
   return base::TryEmplace(handlers_, scheme, type, handler).second;
 }
 
+bool ProtocolRegistry::RegisterStaticProtocol(
+    ProtocolType type,
+    const std::string& scheme,
+    scoped_refptr<StaticProtocolSource> source,
+    const ProtocolHandler& handler) {
+  if (!RegisterProtocol(type, scheme, handler))
+    return false;
+  static_sources_[scheme] = std::move(source);
+  return true;
+}
+
 bool ProtocolRegistry::UnregisterProtocol(const std::string& scheme) {
+  static_sources_.erase(scheme);
   return handlers_.erase(scheme) != 0;
 }
 
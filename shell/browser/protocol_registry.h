@@ -5,10 +5,13 @@
 #ifndef ELECTRON_SHELL_BROWSER_PROTOCOL_REGISTRY_H_
 #define ELECTRON_SHELL_BROWSER_PROTOCOL_REGISTRY_H_
 
+#include <map>
 #include <string>
 
+#include "base/memory/scoped_refptr.h"
 #include "content/public/browser/content_browser_client.h"
 #include "shell/browser/net/electron_url_loader_factory.h"
+#include "shell/browser/net/static_protocol_source.h"
 
 namespace content {
 class BrowserContext;
@@ -31,10 +34,17 @@ class ProtocolRegistry {
 
   const HandlersMap& intercept_handlers() const { return intercept_handlers_; }
   const HandlersMap& handlers() const { return handlers_; }
+  scoped_refptr<StaticProtocolSource> GetStaticSource(
+      const std::string& scheme) const;
 
   bool RegisterProtocol(ProtocolType type,
                         const std::string& scheme,
                         const ProtocolHandler& handler);
+  // Requests are served from |source| where possible, |handler| may be null.
+  bool RegisterStaticProtocol(ProtocolType type,
+                              const std::string& scheme,
+                              scoped_refptr<StaticProtocolSource> source,
+                              const ProtocolHandler& handler);
   bool UnregisterProtocol(const std::string& scheme);
   bool IsProtocolRegistered(const std::string& scheme);
 
@@ -51,6 +61,7 @@ class ProtocolRegistry {
 
   HandlersMap handlers_;
   HandlersMap intercept_handlers_;
+  std::map<std::string, scoped_refptr<StaticProtocolSource>> static_sources_;
 };
 
 }  // namespace electron
@@ -0,0 +1,200 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/startup_snapshot.h"
+
+#include <utility>
+
+#include "base/command_line.h"
+#include "base/files/file_util.h"
+#include "base/logging.h"
+#include "base/memory/ptr_util.h"
+#include "base/pickle.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/thread_restrictions.h"
+#include "crypto/sha2.h"
+#include "electron/electron_version.h"
+#include "electron/fuses.h"
+#include "gin/converter.h"
+#include "shell/common/asar/archive.h"
+#include "shell/common/asar/asar_util.h"
+#include "shell/common/node_bindings.h"
+#include "shell/common/options_switches.h"
+
+namespace electron {
+
+namespace {
+
+constexpr uint32_t kFormatVersion = 2;
+
+// Whether the main process loads the app from the resources directory, rather
+// than the default app loading one from the command line. This follows the
+// search paths of lib/browser/init.ts.
+bool IsPackagedApp() {
+  base::FilePath resources_path = GetResourcesPath();
+  return base::PathExists(
+             resources_path.Append(FILE_PATH_LITERAL("app.asar"))) ||
+         base::PathExists(resources_path.Append(FILE_PATH_LITERAL("app")));
+}
+
+std::string DescribeException(v8::Isolate* isolate,
+                              v8::Local<v8::Context> context,
+                              const v8::TryCatch& try_catch) {
+  v8::Local<v8::Message> message = try_catch.Message();
+  if (message.IsEmpty())
+    return "Failed to run the entry script";
+  return base::StringPrintf(
+      "%s:%d: %s",
+      gin::V8ToString(isolate, message->GetScriptResourceName()).c_str(),
+      message->GetLineNumber(context).FromMaybe(0),
+      gin::V8ToString(isolate, message->Get()).c_str());
+}
+
+}  // namespace
+
+// static
+bool StartupSnapshot::IsEnabled() {
+  return fuses::IsStartupSnapshotEnabled();
+}
+
+// static
+base::FilePath StartupSnapshot::GetPath() {
+  // Whoever can launch a packaged app must not be able to make it start from
+  // another heap, so it only uses the snapshot it ships with.
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  auto* command_line = base::CommandLine::ForCurrentProcess();
+  if (command_line->HasSwitch(switches::kSnapshotBlob) && !IsPackagedApp())
+    return command_line->GetSwitchValuePath(switches::kSnapshotBlob);
+  return GetResourcesPath().Append(FILE_PATH_LITERAL("app_snapshot.bin"));
+}
+
+// static
+std::unique_ptr<StartupSnapshot> StartupSnapshot::Load() {
+  if (!IsEnabled())
+    return nullptr;
+
+  // The isolate of the main process is created from it right away.
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  base::FilePath path = GetPath();
+  std::string contents;
+  if (!base::ReadFileToString(path, &contents))
+    return nullptr;
+
+#if defined(OS_MAC)
+  // The snapshot runs as part of the app, so it is covered by the integrity
+  // of the app like its asar archive. A snapshot without an embedded hash is
+  // not trusted at all.
+  if (fuses::IsEmbeddedAsarIntegrityValidationEnabled()) {
+    absl::optional<asar::IntegrityPayload> integrity =
+        asar::GetEmbeddedIntegrity(path);
+    if (!integrity || integrity->algorithm == asar::HashAlgorithm::NONE) {
+      LOG(WARNING) << "Ignoring the startup snapshot at " << path.value()
+                   << ", the app has no integrity hash for it";
+      return nullptr;
+    }
+    asar::ValidateIntegrityOrDie(contents.data(), contents.size(),
+                                 *integrity);
+  }
+#endif
+
+  auto snapshot = base::WrapUnique(new StartupSnapshot(std::move(contents)));
+  if (!snapshot->data_.data) {
+    LOG(WARNING) << "Ignoring the startup snapshot at " << path.value()
+                 << ", it is corrupt or was built by another version of "
+                    "Electron or with other V8 flags";
+    return nullptr;
+  }
+  return snapshot;
+}
+
+// static
+bool StartupSnapshot::Build(const std::string& source,
+                            const std::string& filename,
+                            const base::FilePath& path,
+                            std::string* error) {
+  if (!IsEnabled()) {
+    *error = "Startup snapshots are disabled by the startupSnapshot fuse";
+    return false;
+  }
+
+  v8::StartupData blob;
+  {
+    // The creator starts from the default snapshot, not from the heap of the
+    // main process.
+    v8::SnapshotCreator creator;
+    v8::Isolate* isolate = creator.GetIsolate();
+    v8::Locker locker(isolate);
+    {
+      v8::HandleScope handle_scope(isolate);
+      v8::Local<v8::Context> context = v8::Context::New(isolate);
+      v8::Context::Scope context_scope(context);
+
+      v8::TryCatch try_catch(isolate);
+      v8::ScriptOrigin origin(isolate, gin::StringToV8(isolate, filename));
+      v8::Local<v8::Script> script;
+      if (!v8::Script::Compile(context, gin::StringToV8(isolate, source),
+                               &origin)
+               .ToLocal(&script) ||
+          script->Run(context).IsEmpty()) {
+        *error = DescribeException(isolate, context, try_catch);
+      }
+      creator.SetDefaultContext(context);
+    }
+    // The creator has to create a blob even when it is not used. Keeping the
+    // compiled functions spares the app compiling them again.
+    blob = creator.CreateBlob(v8::SnapshotCreator::FunctionCodeHandling::kKeep);
+  }
+  std::unique_ptr<const char[]> blob_data(blob.data);
+  if (!error->empty())
+    return false;
+  if (!blob.data) {
+    *error = "Failed to serialize the heap";
+    return false;
+  }
+
+  base::Pickle pickle;
+  pickle.WriteUInt32(kFormatVersion);
+  pickle.WriteString(ELECTRON_VERSION_STRING);
+  pickle.WriteUInt32(v8::ScriptCompiler::CachedDataVersionTag());
+  pickle.WriteString(crypto::SHA256HashString(
+      base::StringPiece(blob.data, static_cast<size_t>(blob.raw_size))));
+  pickle.WriteData(blob.data, blob.raw_size);
+
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  base::StringPiece contents(static_cast<const char*>(pickle.data()),
+                             pickle.size());
+  if (!base::CreateDirectory(path.DirName()) ||
+      !base::WriteFile(path, contents)) {
+    *error = "Failed to write " + path.AsUTF8Unsafe();
+    return false;
+  }
+  return true;
+}
+
+StartupSnapshot::StartupSnapshot(std::string contents)
+    : contents_(std::move(contents)) {
+  // V8 refuses snapshots of other versions by crashing, a snapshot built with
+  // other flags may not work, and V8 does not check that the blob is intact,
+  // so check all of them upfront.
+  base::Pickle pickle(contents_.data(), contents_.size());
+  base::PickleIterator iter(pickle);
+  uint32_t version, version_tag;
+  std::string electron_version, hash;
+  const char* data;
+  int length;
+  if (!iter.ReadUInt32(&version) || version != kFormatVersion ||
+      !iter.ReadString(&electron_version) ||
+      electron_version != ELECTRON_VERSION_STRING ||
+      !iter.ReadUInt32(&version_tag) ||
+      version_tag != v8::ScriptCompiler::CachedDataVersionTag() ||
+      !iter.ReadString(&hash) || !iter.ReadData(&data, &length) ||
+      hash != crypto::SHA256HashString(
+                  base::StringPiece(data, static_cast<size_t>(length))))
+    return;
+  data_ = {data, length};
+}
+
+StartupSnapshot::~StartupSnapshot() = default;
+
+}  // namespace electron
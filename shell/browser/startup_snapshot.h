@@ -0,0 +1,64 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ELECTRON_SHELL_BROWSER_STARTUP_SNAPSHOT_H_
+#define ELECTRON_SHELL_BROWSER_STARTUP_SNAPSHOT_H_
+
+#include <memory>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "v8/include/v8.h"
+
+namespace electron {
+
+// A startup snapshot lets the main process start from a heap that the app
+// prepared with `electron --build-snapshot`, instead of a fresh one.
+//
+// The entry script of the snapshot runs in a plain V8 context, since the
+// native functions of Node.js and Electron cannot be serialized. Whatever it
+// leaves in the global object is there when the app's main script runs.
+class StartupSnapshot {
+ public:
+  // Whether startup snapshots can be built and used, which the
+  // startupSnapshot fuse controls.
+  static bool IsEnabled();
+
+  // Returns the path the snapshot is read from and written to by default,
+  // which is app_snapshot.bin in the resources directory. Apps that are not
+  // packaged can pass another path with the --snapshot-blob switch.
+  static base::FilePath GetPath();
+
+  // Returns the snapshot at GetPath(), or nullptr when there is none, it is
+  // corrupt, or it was built by another version of Electron or with other V8
+  // flags. When the integrity of the app is validated, the snapshot also has
+  // to match its embedded hash.
+  static std::unique_ptr<StartupSnapshot> Load();
+
+  // Runs |source| and writes the resulting heap to |path|. Returns false and
+  // sets |error| on failure, or when snapshots are disabled.
+  static bool Build(const std::string& source,
+                    const std::string& filename,
+                    const base::FilePath& path,
+                    std::string* error);
+
+  ~StartupSnapshot();
+
+  // disable copy
+  StartupSnapshot(const StartupSnapshot&) = delete;
+  StartupSnapshot& operator=(const StartupSnapshot&) = delete;
+
+  const v8::StartupData* data() const { return &data_; }
+
+ private:
+  explicit StartupSnapshot(std::string contents);
+
+  // The contents of the file, |data_| points into it.
+  const std::string contents_;
+  v8::StartupData data_ = {nullptr, 0};
+};
+
+}  // namespace electron
+
+#endif  // ELECTRON_SHELL_BROWSER_STARTUP_SNAPSHOT_H_
@@ -0,0 +1,184 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/thread_pool_platform.h"
+
+#include <utility>
+
+#include "gin/public/v8_platform.h"
+#include "shell/common/node_includes.h"
+
+namespace electron {
+
+namespace {
+
+// Runs the worker tasks of V8 and Node.js on Chromium's thread pool, with the
+// task priorities of V8, instead of on a second pool next to it. Everything
+// that belongs to an isolate is left to the platform of Node.js.
+class ThreadPoolPlatform : public node::MultiIsolatePlatform {
+ public:
+  ThreadPoolPlatform(v8::TracingController* tracing_controller,
+                     v8::PageAllocator* page_allocator)
+      // Node.js still starts the thread of its delayed worker tasks, which
+      // stays idle.
+      : node_platform_(node::MultiIsolatePlatform::Create(0,
+                                                          tracing_controller,
+                                                          page_allocator)),
+        gin_platform_(gin::V8Platform::Get()) {
+    uv_mutex_init(&worker_tasks_mutex_);
+    uv_cond_init(&worker_tasks_done_);
+  }
+
+  ~ThreadPoolPlatform() override {
+    uv_cond_destroy(&worker_tasks_done_);
+    uv_mutex_destroy(&worker_tasks_mutex_);
+  }
+
+  // disable copy
+  ThreadPoolPlatform(const ThreadPoolPlatform&) = delete;
+  ThreadPoolPlatform& operator=(const ThreadPoolPlatform&) = delete;
+
+  // v8::Platform implementation.
+  v8::PageAllocator* GetPageAllocator() override {
+    return node_platform_->GetPageAllocator();
+  }
+  int NumberOfWorkerThreads() override {
+    return gin_platform_->NumberOfWorkerThreads();
+  }
+  std::shared_ptr<v8::TaskRunner> GetForegroundTaskRunner(
+      v8::Isolate* isolate) override {
+    return node_platform_->GetForegroundTaskRunner(isolate);
+  }
+  void CallOnWorkerThread(std::unique_ptr<v8::Task> task) override {
+    gin_platform_->CallOnWorkerThread(
+        std::make_unique<WorkerTask>(std::move(task), this));
+  }
+  void CallBlockingTaskOnWorkerThread(std::unique_ptr<v8::Task> task) override {
+    gin_platform_->CallBlockingTaskOnWorkerThread(
+        std::make_unique<WorkerTask>(std::move(task), this));
+  }
+  // DrainTasks() does not wait for the best-effort tasks either, the thread
+  // pool may hold them back for as long as there is other work, or forever
+  // with --disable-best-effort-tasks.
+  void CallLowPriorityTaskOnWorkerThread(
+      std::unique_ptr<v8::Task> task) override {
+    gin_platform_->CallLowPriorityTaskOnWorkerThread(std::move(task));
+  }
+  // Like Node.js, DrainTasks() does not wait for the delayed tasks.
+  void CallDelayedOnWorkerThread(std::unique_ptr<v8::Task> task,
+                                 double delay_in_seconds) override {
+    gin_platform_->CallDelayedOnWorkerThread(std::move(task),
+                                             delay_in_seconds);
+  }
+  std::unique_ptr<v8::JobHandle> PostJob(
+      v8::TaskPriority priority,
+      std::unique_ptr<v8::JobTask> job_task) override {
+    return gin_platform_->PostJob(priority, std::move(job_task));
+  }
+  bool IdleTasksEnabled(v8::Isolate* isolate) override {
+    return node_platform_->IdleTasksEnabled(isolate);
+  }
+  double MonotonicallyIncreasingTime() override {
+    return node_platform_->MonotonicallyIncreasingTime();
+  }
+  double CurrentClockTimeMillis() override {
+    return node_platform_->CurrentClockTimeMillis();
+  }
+  StackTracePrinter GetStackTracePrinter() override {
+    return node_platform_->GetStackTracePrinter();
+  }
+  v8::TracingController* GetTracingController() override {
+    return node_platform_->GetTracingController();
+  }
+
+  // node::MultiIsolatePlatform implementation.
+  bool FlushForegroundTasks(v8::Isolate* isolate) override {
+    return node_platform_->FlushForegroundTasks(isolate);
+  }
+  void DrainTasks(v8::Isolate* isolate) override {
+    do {
+      WaitForWorkerTasks();
+    } while (FlushForegroundTasks(isolate));
+  }
+  void RegisterIsolate(v8::Isolate* isolate, uv_loop_t* loop) override {
+    node_platform_->RegisterIsolate(isolate, loop);
+  }
+  void RegisterIsolate(v8::Isolate* isolate,
+                       node::IsolatePlatformDelegate* delegate) override {
+    node_platform_->RegisterIsolate(isolate, delegate);
+  }
+  void UnregisterIsolate(v8::Isolate* isolate) override {
+    node_platform_->UnregisterIsolate(isolate);
+  }
+  void AddIsolateFinishedCallback(v8::Isolate* isolate,
+                                  void (*callback)(void*),
+                                  void* data) override {
+    node_platform_->AddIsolateFinishedCallback(isolate, callback, data);
+  }
+
+ private:
+  // Counts a worker task until it ran, or was dropped by the thread pool on
+  // shutdown.
+  class WorkerTask : public v8::Task {
+   public:
+    WorkerTask(std::unique_ptr<v8::Task> task, ThreadPoolPlatform* platform)
+        : task_(std::move(task)), platform_(platform) {
+      platform_->AddWorkerTask();
+    }
+    ~WorkerTask() override {
+      task_.reset();
+      platform_->RemoveWorkerTask();
+    }
+
+    // disable copy
+    WorkerTask(const WorkerTask&) = delete;
+    WorkerTask& operator=(const WorkerTask&) = delete;
+
+    void Run() override { task_->Run(); }
+
+   private:
+    std::unique_ptr<v8::Task> task_;
+    ThreadPoolPlatform* platform_;
+  };
+
+  void AddWorkerTask() {
+    uv_mutex_lock(&worker_tasks_mutex_);
+    ++pending_worker_tasks_;
+    uv_mutex_unlock(&worker_tasks_mutex_);
+  }
+
+  void RemoveWorkerTask() {
+    uv_mutex_lock(&worker_tasks_mutex_);
+    if (--pending_worker_tasks_ == 0)
+      uv_cond_broadcast(&worker_tasks_done_);
+    uv_mutex_unlock(&worker_tasks_mutex_);
+  }
+
+  // This blocks the calling thread like the platform of Node.js does, which
+  // Chromium's primitives would not allow on the main thread.
+  void WaitForWorkerTasks() {
+    uv_mutex_lock(&worker_tasks_mutex_);
+    while (pending_worker_tasks_ > 0)
+      uv_cond_wait(&worker_tasks_done_, &worker_tasks_mutex_);
+    uv_mutex_unlock(&worker_tasks_mutex_);
+  }
+
+  std::unique_ptr<node::MultiIsolatePlatform> node_platform_;
+  gin::V8Platform* gin_platform_;
+
+  uv_mutex_t worker_tasks_mutex_;
+  uv_cond_t worker_tasks_done_;
+  int pending_worker_tasks_ = 0;
+};
+
+}  // namespace
+
+std::unique_ptr<node::MultiIsolatePlatform> CreateThreadPoolPlatform(
+    v8::TracingController* tracing_controller,
+    v8::PageAllocator* page_allocator) {
+  return std::make_unique<ThreadPoolPlatform>(tracing_controller,
+                                              page_allocator);
+}
+
+}  // namespace electron
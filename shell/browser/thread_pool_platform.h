@@ -0,0 +1,31 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ELECTRON_SHELL_BROWSER_THREAD_POOL_PLATFORM_H_
+#define ELECTRON_SHELL_BROWSER_THREAD_POOL_PLATFORM_H_
+
+#include <memory>
+
+namespace node {
+class MultiIsolatePlatform;
+}
+
+namespace v8 {
+class PageAllocator;
+class TracingController;
+}  // namespace v8
+
+namespace electron {
+
+// Creates the platform of the main process, which runs the worker tasks of V8
+// and Node.js on Chromium's thread pool instead of on threads of its own.
+// gin::V8Platform has to be usable, the tasks are queued until the thread pool
+// is started.
+std::unique_ptr<node::MultiIsolatePlatform> CreateThreadPoolPlatform(
+    v8::TracingController* tracing_controller,
+    v8::PageAllocator* page_allocator);
+
+}  // namespace electron
+
+#endif  // ELECTRON_SHELL_BROWSER_THREAD_POOL_PLATFORM_H_
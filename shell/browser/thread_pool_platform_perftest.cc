@@ -0,0 +1,148 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/thread_pool_platform.h"
+
+#include <atomic>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "base/process/process_metrics.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/platform_thread.h"
+#include "base/timer/elapsed_timer.h"
+#include "build/build_config.h"
+#include "gin/test/v8_test.h"
+#include "shell/common/node_includes.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+#if defined(OS_POSIX)
+#include <sys/resource.h>
+#endif
+
+namespace electron {
+
+namespace {
+
+constexpr int kTaskCount = 10000;
+
+// The worker threads Node.js's own platform gets, roughly what
+// JavascriptEnvironment gave it before it used the thread pool.
+constexpr int kNodeWorkerThreads = 4;
+
+#if defined(OS_POSIX)
+int64_t GetContextSwitches() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+  return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+#endif
+
+// Records the threads the worker tasks ran on.
+class Threads {
+ public:
+  void Add() {
+    base::AutoLock lock(lock_);
+    ids_.insert(base::PlatformThread::CurrentId());
+  }
+
+  size_t size() {
+    base::AutoLock lock(lock_);
+    return ids_.size();
+  }
+
+ private:
+  base::Lock lock_;
+  std::set<base::PlatformThreadId> ids_;
+};
+
+class RecordingTask : public v8::Task {
+ public:
+  explicit RecordingTask(Threads* threads) : threads_(threads) {}
+
+  void Run() override { threads_->Add(); }
+
+ private:
+  Threads* threads_;
+};
+
+class ThreadPoolPlatformPerfTest : public gin::V8Test {
+ protected:
+  v8::Isolate* isolate() { return instance_->isolate(); }
+
+  // Posts short worker tasks the way V8's GC and compiler do, then drains
+  // them like Node.js does when it tears down an environment. Reports the
+  // threads the platform started next to the thread pool, which were created
+  // since |threads_before|, and the context switches of the whole process.
+  void RunTasks(const std::string& story,
+                std::unique_ptr<node::MultiIsolatePlatform> platform,
+                int threads_before) {
+    uv_loop_t loop;
+    ASSERT_EQ(0, uv_loop_init(&loop));
+    platform->RegisterIsolate(isolate(), &loop);
+
+    perf_test::PerfResultReporter reporter("NodePlatform", story);
+    reporter.RegisterImportantMetric("_time_per_task", "us");
+    reporter.RegisterImportantMetric("_threads_used", "count");
+#if defined(OS_LINUX)
+    reporter.RegisterImportantMetric("_threads_created", "count");
+    reporter.AddResult(
+        "_threads_created",
+        static_cast<size_t>(
+            base::GetNumberOfThreads(base::GetCurrentProcessHandle()) -
+            threads_before));
+#endif
+#if defined(OS_POSIX)
+    reporter.RegisterImportantMetric("_context_switches", "count");
+    const int64_t context_switches = GetContextSwitches();
+#endif
+
+    Threads threads;
+    base::ElapsedTimer timer;
+    for (int i = 0; i < kTaskCount; ++i)
+      platform->CallOnWorkerThread(std::make_unique<RecordingTask>(&threads));
+    platform->DrainTasks(isolate());
+    reporter.AddResult("_time_per_task",
+                       timer.Elapsed().InMicrosecondsF() / kTaskCount);
+#if defined(OS_POSIX)
+    reporter.AddResult(
+        "_context_switches",
+        static_cast<size_t>(GetContextSwitches() - context_switches));
+#endif
+    reporter.AddResult("_threads_used", threads.size());
+
+    platform->UnregisterIsolate(isolate());
+    platform.reset();
+    uv_run(&loop, UV_RUN_NOWAIT);
+    ASSERT_EQ(0, uv_loop_close(&loop));
+  }
+};
+
+int GetThreadCount() {
+#if defined(OS_LINUX)
+  return base::GetNumberOfThreads(base::GetCurrentProcessHandle());
+#else
+  return 0;
+#endif
+}
+
+}  // namespace
+
+TEST_F(ThreadPoolPlatformPerfTest, NodePlatform) {
+  const int threads_before = GetThreadCount();
+  RunTasks("node_platform",
+           node::MultiIsolatePlatform::Create(kNodeWorkerThreads),
+           threads_before);
+}
+
+TEST_F(ThreadPoolPlatformPerfTest, ThreadPoolPlatform) {
+  const int threads_before = GetThreadCount();
+  RunTasks("thread_pool_platform", CreateThreadPoolPlatform(nullptr, nullptr),
+           threads_before);
+}
+
+}  // namespace electron
@@ -0,0 +1,86 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/thread_pool_platform.h"
+
+#include <atomic>
+#include <memory>
+
+#include "base/task/thread_pool/thread_pool_instance.h"
+#include "gin/test/v8_test.h"
+#include "shell/common/node_includes.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace electron {
+
+namespace {
+
+class CountingTask : public v8::Task {
+ public:
+  explicit CountingTask(std::atomic<int>* count) : count_(count) {}
+
+  void Run() override { ++*count_; }
+
+ private:
+  std::atomic<int>* count_;
+};
+
+}  // namespace
+
+class ThreadPoolPlatformTest : public gin::V8Test {
+ protected:
+  void SetUp() override {
+    gin::V8Test::SetUp();
+    ASSERT_EQ(0, uv_loop_init(&loop_));
+    platform_ = CreateThreadPoolPlatform(nullptr, nullptr);
+    platform_->RegisterIsolate(isolate(), &loop_);
+  }
+
+  void TearDown() override {
+    platform_->UnregisterIsolate(isolate());
+    platform_.reset();
+    // Closes the handles Node.js registered for the isolate.
+    uv_run(&loop_, UV_RUN_NOWAIT);
+    ASSERT_EQ(0, uv_loop_close(&loop_));
+    gin::V8Test::TearDown();
+  }
+
+  v8::Isolate* isolate() { return instance_->isolate(); }
+
+  uv_loop_t loop_;
+  std::unique_ptr<node::MultiIsolatePlatform> platform_;
+};
+
+TEST_F(ThreadPoolPlatformTest, DrainTasksWaitsForWorkerTasks) {
+  std::atomic<int> count(0);
+  for (int i = 0; i < 100; ++i)
+    platform_->CallOnWorkerThread(std::make_unique<CountingTask>(&count));
+  platform_->CallBlockingTaskOnWorkerThread(
+      std::make_unique<CountingTask>(&count));
+
+  platform_->DrainTasks(isolate());
+  EXPECT_EQ(101, count);
+}
+
+// The thread pool does not run best-effort tasks with
+// --disable-best-effort-tasks, which must not hang DrainTasks().
+TEST_F(ThreadPoolPlatformTest, DrainTasksDoesNotWaitForBestEffortTasks) {
+  base::ThreadPoolInstance::Get()->BeginBestEffortFence();
+
+  std::atomic<int> best_effort_count(0);
+  std::atomic<int> count(0);
+  platform_->CallLowPriorityTaskOnWorkerThread(
+      std::make_unique<CountingTask>(&best_effort_count));
+  platform_->CallOnWorkerThread(std::make_unique<CountingTask>(&count));
+
+  platform_->DrainTasks(isolate());
+  EXPECT_EQ(1, count);
+  EXPECT_EQ(0, best_effort_count);
+
+  base::ThreadPoolInstance::Get()->EndBestEffortFence();
+  base::ThreadPoolInstance::Get()->FlushForTesting();
+  EXPECT_EQ(1, best_effort_count);
+}
+
+}  // namespace electron
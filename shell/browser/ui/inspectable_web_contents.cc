@@ -712,8 +712,9 @@ void InspectableWebContents::LoadNetworkResource(DispatchCallback callback,
   } else if (protocol_registry->IsProtocolRegistered(gurl.scheme())) {
     auto& protocol_handler = protocol_registry->handlers().at(gurl.scheme());
     mojo::PendingRemote<network::mojom::URLLoaderFactory> pending_remote =
-        ElectronURLLoaderFactory::Create(protocol_handler.first,
-                                         protocol_handler.second);
+        ElectronURLLoaderFactory::Create(
+            protocol_handler.first, protocol_handler.second,
+            protocol_registry->GetStaticSource(gurl.scheme()));
     url_loader_factory = network::SharedURLLoaderFactory::Create(
         std::make_unique<network::WrapperPendingSharedURLLoaderFactory>(
             std::move(pending_remote)));
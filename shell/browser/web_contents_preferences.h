@@ -76,6 +76,9 @@ class WebContentsPreferences
   bool GetSafeDialogsMessage(std::string* message) const;
   bool ShouldDisablePopups() const { return disable_popups_; }
   bool IsWebSecurityEnabled() const { return web_security_; }
+  bool AllowsNodeIntegrationInSubFrames() const {
+    return node_integration_in_sub_frames_;
+  }
   bool GetPreloadPath(base::FilePath* path) const;
   bool IsSandboxed() const;
 
@@ -6,6 +6,7 @@
 
 #include <string>
 
+#include "base/bind.h"
 #include "content/public/browser/navigation_details.h"
 #include "content/public/browser/navigation_entry.h"
 #include "content/public/browser/navigation_handle.h"
@@ -15,17 +16,36 @@
 #include "content/public/browser/web_contents.h"
 #include "content/public/browser/web_contents_user_data.h"
 #include "content/public/common/page_type.h"
+#include "mojo/public/cpp/bindings/associated_remote.h"
 #include "net/base/url_util.h"
+#include "shell/common/api/api.mojom.h"
+#include "third_party/blink/public/common/associated_interfaces/associated_interface_provider.h"
 #include "third_party/blink/public/common/page/page_zoom.h"
 
 namespace electron {
 
+namespace {
+
+void SendZoomLevel(double level, content::RenderFrameHost* render_frame_host) {
+  if (!render_frame_host->IsRenderFrameLive())
+    return;
+  mojo::AssociatedRemote<mojom::ElectronZoomAgent> zoom_agent;
+  render_frame_host->GetRemoteAssociatedInterfaces()->GetInterface(
+      &zoom_agent);
+  zoom_agent->UpdateZoomLevel(level);
+}
+
+}  // namespace
+
 WebContentsZoomController::WebContentsZoomController(
     content::WebContents* web_contents)
     : content::WebContentsObserver(web_contents),
       content::WebContentsUserData<WebContentsZoomController>(*web_contents) {
   default_zoom_factor_ = kPageZoomEpsilon;
   host_zoom_map_ = content::HostZoomMap::GetForWebContents(web_contents);
+  zoom_subscription_ = host_zoom_map_->AddZoomLevelChangedCallback(
+      base::BindRepeating(&WebContentsZoomController::OnZoomLevelChanged,
+                          base::Unretained(this)));
 }
 
 WebContentsZoomController::~WebContentsZoomController() = default;
@@ -57,6 +77,7 @@ void WebContentsZoomController::SetZoomLevel(double level) {
 
   if (zoom_mode_ == ZoomMode::kManual) {
     zoom_level_ = level;
+    UpdateRendererZoomLevel();
 
     for (Observer& observer : observers_)
       observer.OnZoomLevelChanged(web_contents(), level, true);
@@ -96,6 +117,9 @@ double WebContentsZoomController::GetDefaultZoomFactor() {
 }
 
 void WebContentsZoomController::SetTemporaryZoomLevel(double level) {
+  // Called on behalf of a renderer that has already cached |level|, so the
+  // actual level has to be sent back even if it did not change.
+  renderer_zoom_level_.reset();
   old_process_id_ = web_contents()->GetRenderViewHost()->GetProcess()->GetID();
   old_view_id_ = web_contents()->GetRenderViewHost()->GetRoutingID();
   host_zoom_map_->SetTemporaryZoomLevel(old_process_id_, old_view_id_, level);
@@ -194,6 +218,7 @@ void WebContentsZoomController::SetZoomMode(ZoomMode new_mode) {
   }
 
   zoom_mode_ = new_mode;
+  UpdateRendererZoomLevel();
 }
 
 void WebContentsZoomController::ResetZoomModeOnNavigationIfNeeded(
@@ -213,6 +238,7 @@ void WebContentsZoomController::ResetZoomModeOnNavigationIfNeeded(
     observer.OnZoomLevelChanged(web_contents(), new_zoom_level, false);
   zoom_map->ClearTemporaryZoomLevel(render_process_id, render_view_id);
   zoom_mode_ = ZoomMode::kDefault;
+  UpdateRendererZoomLevel();
 }
 
 void WebContentsZoomController::DidFinishNavigation(
@@ -222,11 +248,21 @@ void WebContentsZoomController::DidFinishNavigation(
 
   if (navigation_handle->IsErrorPage()) {
     content::HostZoomMap::SendErrorPageZoomLevelRefresh(web_contents());
-    return;
+  } else {
+    ResetZoomModeOnNavigationIfNeeded(navigation_handle->GetURL());
+    SetZoomFactorOnNavigationIfNeeded(navigation_handle->GetURL());
   }
 
-  ResetZoomModeOnNavigationIfNeeded(navigation_handle->GetURL());
-  SetZoomFactorOnNavigationIfNeeded(navigation_handle->GetURL());
+  // In default mode the level follows the host of the new page without any
+  // zoom event, and the frames created for the navigation were sent the level
+  // of the previous page, so every frame is sent the level again.
+  renderer_zoom_level_.reset();
+  UpdateRendererZoomLevel();
+}
+
+void WebContentsZoomController::RenderFrameCreated(
+    content::RenderFrameHost* render_frame_host) {
+  SendZoomLevel(GetZoomLevel(), render_frame_host);
 }
 
 void WebContentsZoomController::WebContentsDestroyed() {
@@ -235,6 +271,7 @@ void WebContentsZoomController::WebContentsDestroyed() {
 
   observers_.Clear();
   embedder_zoom_controller_ = nullptr;
+  zoom_subscription_ = {};
 }
 
 void WebContentsZoomController::RenderFrameHostChanged(
@@ -247,6 +284,10 @@ void WebContentsZoomController::RenderFrameHostChanged(
     return;
 
   host_zoom_map_ = new_host_zoom_map;
+  zoom_subscription_ = host_zoom_map_->AddZoomLevelChangedCallback(
+      base::BindRepeating(&WebContentsZoomController::OnZoomLevelChanged,
+                          base::Unretained(this)));
+  UpdateRendererZoomLevel();
 }
 
 void WebContentsZoomController::SetZoomFactorOnNavigationIfNeeded(
@@ -282,6 +323,22 @@ void WebContentsZoomController::SetZoomFactorOnNavigationIfNeeded(
   SetZoomLevel(zoom_level);
 }
 
+void WebContentsZoomController::OnZoomLevelChanged(
+    const content::HostZoomMap::ZoomLevelChange& change) {
+  // Changes for other hosts and pages leave the level of this page as it was,
+  // which UpdateRendererZoomLevel does not send again.
+  UpdateRendererZoomLevel();
+}
+
+void WebContentsZoomController::UpdateRendererZoomLevel() {
+  const double level = GetZoomLevel();
+  if (renderer_zoom_level_ == level)
+    return;
+  renderer_zoom_level_ = level;
+  web_contents()->GetMainFrame()->ForEachRenderFrameHost(
+      base::BindRepeating(&SendZoomLevel, level));
+}
+
 WEB_CONTENTS_USER_DATA_KEY_IMPL(WebContentsZoomController);
 
 }  // namespace electron
@@ -5,10 +5,12 @@
 #ifndef ELECTRON_SHELL_BROWSER_WEB_CONTENTS_ZOOM_CONTROLLER_H_
 #define ELECTRON_SHELL_BROWSER_WEB_CONTENTS_ZOOM_CONTROLLER_H_
 
+#include "base/callback_list.h"
 #include "base/observer_list_types.h"
 #include "content/public/browser/host_zoom_map.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/browser/web_contents_user_data.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace electron {
 
@@ -86,6 +88,7 @@ class WebContentsZoomController
  protected:
   // content::WebContentsObserver:
   void DidFinishNavigation(content::NavigationHandle* handle) override;
+  void RenderFrameCreated(content::RenderFrameHost* render_frame_host) override;
   void WebContentsDestroyed() override;
   void RenderFrameHostChanged(content::RenderFrameHost* old_host,
                               content::RenderFrameHost* new_host) override;
@@ -96,6 +99,12 @@ class WebContentsZoomController
   // Called after a navigation has committed to set default zoom factor.
   void SetZoomFactorOnNavigationIfNeeded(const GURL& url);
 
+  void OnZoomLevelChanged(const content::HostZoomMap::ZoomLevelChange& change);
+
+  // Sends the current zoom level to every frame of the page if the renderers
+  // have not been sent it yet, see mojom::ElectronZoomAgent.
+  void UpdateRendererZoomLevel();
+
   // The current zoom mode.
   ZoomMode zoom_mode_ = ZoomMode::kDefault;
 
@@ -116,6 +125,11 @@ class WebContentsZoomController
 
   content::HostZoomMap* host_zoom_map_;
 
+  base::CallbackListSubscription zoom_subscription_;
+
+  // The zoom level last sent to the renderers.
+  absl::optional<double> renderer_zoom_level_;
+
   WEB_CONTENTS_USER_DATA_KEY_DECL();
 };
 
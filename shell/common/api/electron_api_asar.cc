@@ -2,6 +2,8 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "gin/handle.h"
@@ -21,8 +23,10 @@ class Archive : public gin::Wrappable<Archive> {
  public:
   static gin::Handle<Archive> Create(v8::Isolate* isolate,
                                      const base::FilePath& path) {
-    auto archive = std::make_unique<asar::Archive>(path);
-    if (!archive->Init())
+    // Share the archive, and its header index, with native readers.
+    std::shared_ptr<asar::Archive> archive =
+        asar::GetOrCreateAsarArchive(path);
+    if (!archive)
       return gin::Handle<Archive>();
     return gin::CreateHandle(isolate, new Archive(isolate, std::move(archive)));
   }
@@ -47,7 +51,7 @@ class Archive : public gin::Wrappable<Archive> {
   Archive& operator=(const Archive&) = delete;
 
  protected:
-  Archive(v8::Isolate* isolate, std::unique_ptr<asar::Archive> archive)
+  Archive(v8::Isolate* isolate, std::shared_ptr<asar::Archive> archive)
       : archive_(std::move(archive)) {}
 
   // Reads the offset and size of file.
@@ -126,7 +130,7 @@ class Archive : public gin::Wrappable<Archive> {
   }
 
  private:
-  std::unique_ptr<asar::Archive> archive_;
+  std::shared_ptr<asar::Archive> archive_;
 };
 
 // static
@@ -134,12 +138,10 @@ gin::WrapperInfo Archive::kWrapperInfo = {gin::kEmbedderNativeGin};
 
 void InitAsarSupport(v8::Isolate* isolate, v8::Local<v8::Value> require) {
   // Evaluate asar_bundle.js.
-  std::vector<v8::Local<v8::String>> asar_bundle_params = {
-      node::FIXED_ONE_BYTE_STRING(isolate, "require")};
   std::vector<v8::Local<v8::Value>> asar_bundle_args = {require};
-  electron::util::CompileAndCall(
-      isolate->GetCurrentContext(), "electron/js2c/asar_bundle",
-      &asar_bundle_params, &asar_bundle_args, nullptr);
+  electron::util::CompileAndCall(isolate->GetCurrentContext(),
+                                 "electron/js2c/asar_bundle",
+                                 &asar_bundle_args, nullptr);
 }
 
 v8::Local<v8::Value> SplitPath(v8::Isolate* isolate,
@@ -156,6 +158,67 @@ v8::Local<v8::Value> SplitPath(v8::Isolate* isolate,
   return dict.GetHandle();
 }
 
+// Results of |ProbeModulePath|, kept in sync with ModulePathResult in
+// lib/asar/fs-wrapper.ts. Paths inside an archive use the same values as
+// Node's internalModuleStat().
+constexpr int32_t kModulePathFile = 0;
+constexpr int32_t kModulePathDirectory = 1;
+constexpr int32_t kModulePathNotFound = -34;
+// The path is not inside an archive and has to be resolved by Node.
+constexpr int32_t kModulePathNotAsar = -1;
+constexpr int32_t kModulePathInvalidArchive = -2;
+
+int32_t StatModulePath(const base::FilePath& path) {
+  base::FilePath asar_path, relative_path;
+  if (!asar::GetAsarArchivePath(path, &asar_path, &relative_path, true))
+    return kModulePathNotAsar;
+
+  std::shared_ptr<asar::Archive> archive =
+      asar::GetOrCreateAsarArchive(asar_path);
+  if (!archive)
+    return kModulePathInvalidArchive;
+
+  asar::Archive::Stats stats;
+  if (!archive->Stat(relative_path, &stats))
+    return kModulePathNotFound;
+  return stats.is_directory ? kModulePathDirectory : kModulePathFile;
+}
+
+// Stats |path| followed by |path| with each of |extensions| appended, the
+// order in which require() probes them, and writes one result per candidate
+// into the |results| Int32Array. When |path| is a directory inside an archive
+// and |read_package_json| is set, the contents of its package.json are
+// returned too, so resolving a package takes a single call.
+v8::Local<v8::Value> ProbeModulePath(
+    v8::Isolate* isolate,
+    const base::FilePath& path,
+    const std::vector<base::FilePath::StringType>& extensions,
+    v8::Local<v8::Value> results,
+    bool read_package_json) {
+  if (!results->IsInt32Array() ||
+      results.As<v8::Int32Array>()->Length() < extensions.size() + 1) {
+    isolate->ThrowException(v8::Exception::TypeError(gin::StringToV8(
+        isolate, "results must be an Int32Array with a slot per candidate")));
+    return v8::Undefined(isolate);
+  }
+
+  auto array = results.As<v8::Int32Array>();
+  int32_t* out = reinterpret_cast<int32_t*>(
+      static_cast<char*>(array->Buffer()->GetBackingStore()->Data()) +
+      array->ByteOffset());
+
+  out[0] = StatModulePath(path);
+  for (size_t i = 0; i < extensions.size(); ++i)
+    out[i + 1] = StatModulePath(base::FilePath(path.value() + extensions[i]));
+
+  std::string package_json;
+  if (out[0] != kModulePathDirectory || !read_package_json ||
+      !asar::ReadFileToString(path.Append(FILE_PATH_LITERAL("package.json")),
+                              &package_json))
+    return v8::Undefined(isolate);
+  return gin::StringToV8(isolate, package_json);
+}
+
 void Initialize(v8::Local<v8::Object> exports,
                 v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context,
@@ -163,6 +226,7 @@ void Initialize(v8::Local<v8::Object> exports,
   gin_helper::Dictionary dict(context->GetIsolate(), exports);
   dict.SetMethod("createArchive", &Archive::Create);
   dict.SetMethod("splitPath", &SplitPath);
+  dict.SetMethod("probeModulePath", &ProbeModulePath);
   dict.SetMethod("initAsarSupport", &InitAsarSupport);
 }
 
@@ -11,6 +11,7 @@
 #include "shell/common/gin_converters/gurl_converter.h"
 #include "shell/common/gin_converters/std_converter.h"
 #include "shell/common/gin_helper/dictionary.h"
+#include "shell/common/js2c_code_cache.h"
 #include "shell/common/node_includes.h"
 #include "url/origin.h"
 #include "v8/include/v8-profiler.h"
@@ -116,6 +117,18 @@ void RunUntilIdle() {
   base::RunLoop().RunUntilIdle();
 }
 
+// Which builtins of the current Node.js environment were compiled with a code
+// cache, and whether this build has code caches for the js2c bundles.
+v8::Local<v8::Value> GetCodeCacheUsageForTesting(v8::Isolate* isolate) {
+  gin_helper::Dictionary dict = gin::Dictionary::CreateEmpty(isolate);
+  dict.Set("hasJs2cCodeCache", !electron::GetJs2cCodeCaches().empty());
+  if (node::Environment* env = node::Environment::GetCurrent(isolate)) {
+    dict.Set("compiledWithCache", env->native_modules_with_cache);
+    dict.Set("compiledWithoutCache", env->native_modules_without_cache);
+  }
+  return dict.GetHandle();
+}
+
 void Initialize(v8::Local<v8::Object> exports,
                 v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context,
@@ -130,6 +143,7 @@ void Initialize(v8::Local<v8::Object> exports,
                  &RequestGarbageCollectionForTesting);
   dict.SetMethod("triggerFatalErrorForTesting", &TriggerFatalErrorForTesting);
   dict.SetMethod("runUntilIdle", &RunUntilIdle);
+  dict.SetMethod("getCodeCacheUsageForTesting", &GetCodeCacheUsageForTesting);
 }
 
 }  // namespace
@@ -11,6 +11,7 @@
 #include "base/check.h"
 #include "base/files/file.h"
 #include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/pickle.h"
@@ -18,7 +19,9 @@
 #include "base/task/post_task.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/values.h"
+#include "crypto/sha2.h"
 #include "electron/fuses.h"
+#include "shell/common/asar/archive_index.h"
 #include "shell/common/asar/asar_util.h"
 #include "shell/common/asar/scoped_temporary_file.h"
 
@@ -30,128 +33,44 @@ namespace asar {
 
 namespace {
 
+// Converts |path| into the UTF-8 form used by the header without allocating
+// where the platform already stores paths as UTF-8.
 #if defined(OS_WIN)
-const char kSeparators[] = "\\/";
-#else
-const char kSeparators[] = "/";
-#endif
-
-bool GetNodeFromPath(std::string path,
-                     const base::DictionaryValue* root,
-                     const base::DictionaryValue** out);
-
-// Gets the "files" from "dir".
-bool GetFilesNode(const base::DictionaryValue* root,
-                  const base::DictionaryValue* dir,
-                  const base::DictionaryValue** out) {
-  // Test for symbol linked directory.
-  const std::string* link = dir->FindStringKey("link");
-  if (link != nullptr) {
-    const base::DictionaryValue* linked_node = nullptr;
-    if (!GetNodeFromPath(*link, root, &linked_node))
-      return false;
-    dir = linked_node;
-  }
-
-  return dir->GetDictionaryWithoutPathExpansion("files", out);
-}
-
-// Gets sub-file "name" from "dir".
-bool GetChildNode(const base::DictionaryValue* root,
-                  const std::string& name,
-                  const base::DictionaryValue* dir,
-                  const base::DictionaryValue** out) {
-  if (name.empty()) {
-    *out = root;
-    return true;
-  }
-
-  const base::DictionaryValue* files = nullptr;
-  return GetFilesNode(root, dir, &files) &&
-         files->GetDictionaryWithoutPathExpansion(name, out);
+std::string ToHeaderPath(const base::FilePath& path) {
+  return path.AsUTF8Unsafe();
 }
-
-// Gets the node of "path" from "root".
-bool GetNodeFromPath(std::string path,
-                     const base::DictionaryValue* root,
-                     const base::DictionaryValue** out) {
-  if (path.empty()) {
-    *out = root;
-    return true;
-  }
-
-  const base::DictionaryValue* dir = root;
-  for (size_t delimiter_position = path.find_first_of(kSeparators);
-       delimiter_position != std::string::npos;
-       delimiter_position = path.find_first_of(kSeparators)) {
-    const base::DictionaryValue* child = nullptr;
-    if (!GetChildNode(root, path.substr(0, delimiter_position), dir, &child))
-      return false;
-
-    dir = child;
-    path.erase(0, delimiter_position + 1);
-  }
-
-  return GetChildNode(root, path, dir, out);
+#else
+const std::string& ToHeaderPath(const base::FilePath& path) {
+  return path.value();
 }
+#endif
 
 bool FillFileInfoWithNode(Archive::FileInfo* info,
                           uint32_t header_size,
                           bool load_integrity,
-                          const base::DictionaryValue* node) {
-  if (auto size = node->FindIntKey("size")) {
-    info->size = static_cast<uint32_t>(size.value());
-  } else {
+                          const ArchiveIndex& index,
+                          const ArchiveIndex::Node& node) {
+  using Node = ArchiveIndex::Node;
+
+  if (!node.HasFlag(Node::kHasSize))
     return false;
-  }
+  info->size = node.size;
 
-  if (auto unpacked = node->FindBoolKey("unpacked")) {
-    info->unpacked = unpacked.value();
-    if (info->unpacked) {
-      return true;
-    }
-  }
+  info->unpacked = node.HasFlag(Node::kUnpacked);
+  if (info->unpacked)
+    return true;
 
-  auto* offset = node->FindStringKey("offset");
-  if (offset &&
-      base::StringToUint64(base::StringPiece(*offset), &info->offset)) {
-    info->offset += header_size;
-  } else {
+  if (!node.HasFlag(Node::kHasOffset))
     return false;
-  }
+  info->offset = node.offset + header_size;
 
-  if (auto executable = node->FindBoolKey("executable")) {
-    info->executable = executable.value();
-  }
+  info->executable = node.HasFlag(Node::kExecutable);
 
 #if defined(OS_MAC)
   if (load_integrity &&
       electron::fuses::IsEmbeddedAsarIntegrityValidationEnabled()) {
-    if (auto* integrity = node->FindDictKey("integrity")) {
-      auto* algorithm = integrity->FindStringKey("algorithm");
-      auto* hash = integrity->FindStringKey("hash");
-      auto block_size = integrity->FindIntKey("blockSize");
-      auto* blocks = integrity->FindListKey("blocks");
-
-      if (algorithm && hash && block_size && block_size > 0 && blocks) {
-        IntegrityPayload integrity_payload;
-        integrity_payload.hash = *hash;
-        integrity_payload.block_size =
-            static_cast<uint32_t>(block_size.value());
-        for (auto& value : blocks->GetList()) {
-          if (auto* block = value.GetIfString()) {
-            integrity_payload.blocks.push_back(*block);
-          } else {
-            LOG(FATAL)
-                << "Invalid block integrity value for file in ASAR archive";
-          }
-        }
-        if (*algorithm == "SHA256") {
-          integrity_payload.algorithm = HashAlgorithm::SHA256;
-          info->integrity = std::move(integrity_payload);
-        }
-      }
-    }
+    if (const IntegrityPayload* integrity = index.Integrity(node))
+      info->integrity = *integrity;
 
     if (!info->integrity.has_value()) {
       LOG(FATAL) << "Failed to read integrity for file in ASAR archive";
@@ -279,9 +198,14 @@ bool Archive::Init() {
     return false;
   }
 
+  index_ = ArchiveIndex::Create(*value, header_validated_);
+  if (!index_) {
+    LOG(ERROR) << "Failed to index header";
+    return false;
+  }
+
   header_size_ = 8 + size;
-  header_ = base::DictionaryValue::From(
-      base::Value::ToUniquePtrValue(std::move(*value)));
+  header_hash_ = crypto::SHA256HashString(header);
   return true;
 }
 
@@ -296,76 +220,82 @@ absl::optional<base::FilePath> Archive::RelativePath() const {
 #endif
 
 bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) const {
-  if (!header_)
+  if (!index_)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  ArchiveIndex::NodeId id;
+  if (!index_->Lookup(ToHeaderPath(path), &id))
     return false;
 
-  std::string link;
-  if (node->GetString("link", &link))
-    return GetFileInfo(base::FilePath::FromUTF8Unsafe(link), info);
+  const ArchiveIndex::Node& node = index_->node(id);
+  if (node.type == ArchiveIndex::NodeType::kLink) {
+    return GetFileInfo(
+        base::FilePath::FromUTF8Unsafe(index_->LinkTarget(node)), info);
+  }
 
-  return FillFileInfoWithNode(info, header_size_, header_validated_, node);
+  return FillFileInfoWithNode(info, header_size_, header_validated_, *index_,
+                              node);
 }
 
 bool Archive::Stat(const base::FilePath& path, Stats* stats) const {
-  if (!header_)
+  if (!index_)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  ArchiveIndex::NodeId id;
+  if (!index_->Lookup(ToHeaderPath(path), &id))
     return false;
 
-  if (node->FindKey("link")) {
+  const ArchiveIndex::Node& node = index_->node(id);
+  if (node.type == ArchiveIndex::NodeType::kLink) {
     stats->is_file = false;
     stats->is_link = true;
     return true;
   }
 
-  if (node->FindKey("files")) {
+  if (node.type == ArchiveIndex::NodeType::kDirectory) {
     stats->is_file = false;
     stats->is_directory = true;
     return true;
   }
 
-  return FillFileInfoWithNode(stats, header_size_, header_validated_, node);
+  return FillFileInfoWithNode(stats, header_size_, header_validated_, *index_,
+                              node);
 }
 
 bool Archive::Readdir(const base::FilePath& path,
                       std::vector<base::FilePath>* files) const {
-  if (!header_)
+  if (!index_)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  ArchiveIndex::NodeId id;
+  if (!index_->Lookup(ToHeaderPath(path), &id))
     return false;
 
-  const base::DictionaryValue* files_node;
-  if (!GetFilesNode(header_.get(), node, &files_node))
+  ArchiveIndex::NodeId dir_id;
+  if (!index_->ResolveDirectory(id, &dir_id))
     return false;
 
-  base::DictionaryValue::Iterator iter(*files_node);
-  while (!iter.IsAtEnd()) {
-    files->push_back(base::FilePath::FromUTF8Unsafe(iter.key()));
-    iter.Advance();
+  const ArchiveIndex::Node& dir = index_->node(dir_id);
+  files->reserve(files->size() + dir.count);
+  for (uint32_t i = 0; i < dir.count; ++i) {
+    files->push_back(base::FilePath::FromUTF8Unsafe(
+        index_->Name(index_->node(dir.first + i))));
   }
   return true;
 }
 
 bool Archive::Realpath(const base::FilePath& path,
                        base::FilePath* realpath) const {
-  if (!header_)
+  if (!index_)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  ArchiveIndex::NodeId id;
+  if (!index_->Lookup(ToHeaderPath(path), &id))
     return false;
 
-  std::string link;
-  if (node->GetString("link", &link)) {
-    *realpath = base::FilePath::FromUTF8Unsafe(link);
+  const ArchiveIndex::Node& node = index_->node(id);
+  if (node.type == ArchiveIndex::NodeType::kLink) {
+    *realpath = base::FilePath::FromUTF8Unsafe(index_->LinkTarget(node));
     return true;
   }
 
@@ -374,7 +304,7 @@ bool Archive::Realpath(const base::FilePath& path,
 }
 
 bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
-  if (!header_)
+  if (!index_)
     return false;
 
   base::AutoLock auto_lock(external_files_lock_);
@@ -416,4 +346,86 @@ int Archive::GetUnsafeFD() const {
   return fd_;
 }
 
+bool Archive::IsIntegrityVerified(uint64_t offset, uint64_t size) const {
+  if (size == 0)
+    return false;
+  base::AutoLock auto_lock(verified_ranges_lock_);
+  return verified_ranges_.count(std::make_pair(offset, size)) != 0;
+}
+
+void Archive::MarkIntegrityVerified(uint64_t offset,
+                                    uint64_t size,
+                                    uint64_t generation) {
+  if (size == 0)
+    return;
+  base::AutoLock auto_lock(verified_ranges_lock_);
+  if (generation == verified_generation_)
+    verified_ranges_.emplace(offset, size);
+}
+
+uint64_t Archive::RevalidateIntegrityCache() {
+  FileIdentity identity;
+  const bool has_identity = GetFileIdentity(&identity);
+
+  base::AutoLock auto_lock(verified_ranges_lock_);
+  if (has_identity && identity.size == verified_identity_.size &&
+      identity.last_changed == verified_identity_.last_changed)
+    return verified_generation_;
+
+  if (!verified_ranges_.empty()) {
+    LOG(WARNING) << path_.value()
+                 << " changed on disk, revalidating its integrity";
+  }
+  verified_ranges_.clear();
+  verified_identity_ = identity;
+  return ++verified_generation_;
+}
+
+bool Archive::GetFileIdentity(FileIdentity* identity) {
+  // The archive is always read through |file_| or a mapping of it, so the
+  // open handle is what has to stay unmodified. Replacing the file at |path_|
+  // does not affect what is read.
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  if (!file_.IsValid())
+    return false;
+
+#if defined(OS_POSIX)
+  // Unlike the modification time, the status change time cannot be set back
+  // with utimes(), so it catches in-place edits that try to hide themselves.
+  base::stat_wrapper_t file_info;
+  if (base::File::Fstat(file_.GetPlatformFile(), &file_info) != 0)
+    return false;
+  identity->size = file_info.st_size;
+#if defined(OS_MAC)
+  identity->last_changed = base::Time::FromTimeSpec(file_info.st_ctimespec);
+#else
+  identity->last_changed = base::Time::FromTimeSpec(file_info.st_ctim);
+#endif
+#else
+  base::File::Info info;
+  if (!file_.GetInfo(&info))
+    return false;
+  identity->size = info.size;
+  identity->last_changed = info.last_modified;
+#endif
+  return true;
+}
+
+base::span<const uint8_t> Archive::GetMappedFile() {
+  base::AutoLock auto_lock(mapped_file_lock_);
+
+  if (!mapped_file_) {
+    mapped_file_ = std::make_unique<base::MemoryMappedFile>();
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    if (!file_.IsValid() || !mapped_file_->Initialize(file_.Duplicate())) {
+      LOG(WARNING) << "Failed to map " << path_.value()
+                   << ", falling back to file reads";
+    }
+  }
+
+  if (!mapped_file_->IsValid())
+    return base::span<const uint8_t>();
+  return base::make_span(mapped_file_->data(), mapped_file_->length());
+}
+
 }  // namespace asar
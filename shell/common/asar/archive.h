@@ -6,21 +6,26 @@
 #define ELECTRON_SHELL_COMMON_ASAR_ARCHIVE_H_
 
 #include <memory>
+#include <set>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "base/containers/span.h"
 #include "base/files/file.h"
 #include "base/files/file_path.h"
 #include "base/synchronization/lock.h"
+#include "base/time/time.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace base {
-class DictionaryValue;
+class MemoryMappedFile;
 }
 
 namespace asar {
 
+class ArchiveIndex;
 class ScopedTemporaryFile;
 
 enum HashAlgorithm {
@@ -38,6 +43,13 @@ struct IntegrityPayload {
   std::vector<std::string> blocks;
 };
 
+#if defined(OS_MAC)
+// Returns the integrity that the app's Info.plist embeds for the file at
+// |path| in the app bundle, or nothing if it has none.
+absl::optional<IntegrityPayload> GetEmbeddedIntegrity(
+    const base::FilePath& path);
+#endif
+
 // This class represents an asar package, and provides methods to read
 // information from it. It is thread-safe after |Init| has been called.
 class Archive {
@@ -95,16 +107,66 @@ class Archive {
   // for integrity validation after this fd is handed over.
   int GetUnsafeFD() const;
 
+  // Returns the whole archive mapped read-only into memory, mapping it on the
+  // first call. The mapping stays valid for the lifetime of this Archive and
+  // is indexed by the same offsets as |FileInfo::offset|. Returns an empty
+  // span if the archive could not be mapped, in which case callers should
+  // read through a file handle instead.
+  base::span<const uint8_t> GetMappedFile();
+
+  // Remembers byte ranges of the archive whose contents already matched the
+  // integrity hash the header gives for them, so that reading them again
+  // does not rehash them. A range is keyed by its offset and the number of
+  // bytes that were actually hashed, which is less than the block size for
+  // the last block of a file. Empty ranges are never verified, as an empty
+  // file has the same offset as the file after it.
+  bool IsIntegrityVerified(uint64_t offset, uint64_t size) const;
+  // |generation| is the value returned by |RevalidateIntegrityCache| before
+  // the range was read. The range is ignored if the cache has been
+  // invalidated since.
+  void MarkIntegrityVerified(uint64_t offset,
+                             uint64_t size,
+                             uint64_t generation);
+
+  // Checks that the archive has not been modified on disk since its ranges
+  // were verified, and forgets all of them if it has. This only costs a
+  // stat of the open file, and should be called before trusting
+  // |IsIntegrityVerified| for a new read. Returns the current generation of
+  // the cache.
+  uint64_t RevalidateIntegrityCache();
+
   base::FilePath path() const { return path_; }
 
+  // The SHA256 hash of the header, which identifies the layout of the
+  // archive. It only covers the contents of the files that have integrity
+  // hashes in the header, other files at the same offset of archives with the
+  // same header hash can differ.
+  const std::string& header_hash() const { return header_hash_; }
+
  private:
+  struct FileIdentity {
+    int64_t size = 0;
+    base::Time last_changed;
+  };
+
+  bool GetFileIdentity(FileIdentity* identity);
+
   bool initialized_;
   bool header_validated_ = false;
   const base::FilePath path_;
   base::File file_;
   int fd_ = -1;
   uint32_t header_size_ = 0;
-  std::unique_ptr<base::DictionaryValue> header_;
+  std::string header_hash_;
+  std::unique_ptr<ArchiveIndex> index_;
+
+  base::Lock mapped_file_lock_;
+  std::unique_ptr<base::MemoryMappedFile> mapped_file_;
+
+  mutable base::Lock verified_ranges_lock_;
+  FileIdentity verified_identity_;
+  uint64_t verified_generation_ = 0;
+  std::set<std::pair<uint64_t, uint64_t>> verified_ranges_;
 
   // Cached external temporary files.
   base::Lock external_files_lock_;
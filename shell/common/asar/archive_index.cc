@@ -0,0 +1,247 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/asar/archive_index.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "base/logging.h"
+#include "base/memory/ptr_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/values.h"
+#include "electron/fuses.h"
+
+namespace asar {
+
+namespace {
+
+#if defined(OS_WIN)
+const char kSeparators[] = "\\/";
+#else
+const char kSeparators[] = "/";
+#endif
+
+// Guards against cycles of links pointing at each other.
+const int kMaxLinkDepth = 32;
+
+#if defined(OS_MAC)
+bool ReadIntegrity(const base::Value& node, IntegrityPayload* out) {
+  const base::Value* integrity = node.FindDictKey("integrity");
+  if (!integrity)
+    return false;
+
+  const std::string* algorithm = integrity->FindStringKey("algorithm");
+  const std::string* hash = integrity->FindStringKey("hash");
+  absl::optional<int> block_size = integrity->FindIntKey("blockSize");
+  const base::Value* blocks = integrity->FindListKey("blocks");
+  if (!algorithm || !hash || !block_size || block_size <= 0 || !blocks)
+    return false;
+
+  out->hash = *hash;
+  out->block_size = static_cast<uint32_t>(block_size.value());
+  for (const auto& value : blocks->GetList()) {
+    if (const std::string* block = value.GetIfString()) {
+      out->blocks.push_back(*block);
+    } else {
+      LOG(FATAL) << "Invalid block integrity value for file in ASAR archive";
+    }
+  }
+
+  if (*algorithm != "SHA256")
+    return false;
+  out->algorithm = HashAlgorithm::SHA256;
+  return true;
+}
+#endif
+
+}  // namespace
+
+ArchiveIndex::ArchiveIndex() = default;
+ArchiveIndex::~ArchiveIndex() = default;
+
+// static
+std::unique_ptr<ArchiveIndex> ArchiveIndex::Create(const base::Value& header,
+                                                   bool load_integrity) {
+  if (!header.is_dict())
+    return nullptr;
+
+  auto index = base::WrapUnique(new ArchiveIndex);
+  // Names repeat a lot in real archives ("index.js", "package.json", ...), so
+  // every distinct name is stored once.
+  std::map<base::StringPiece, uint32_t> interned;
+  auto intern = [&](base::StringPiece str) {
+    auto it = interned.find(str);
+    if (it != interned.end())
+      return it->second;
+    uint32_t offset = static_cast<uint32_t>(index->strings_.size());
+    index->strings_.append(str.data(), str.size());
+    interned.emplace(str, offset);
+    return offset;
+  };
+
+  // Nodes are laid out breadth-first so that the children of a directory are
+  // always appended together.
+  std::vector<std::pair<NodeId, const base::Value*>> pending;
+  index->nodes_.emplace_back();
+  pending.emplace_back(kRootNode, &header);
+  for (size_t i = 0; i < pending.size(); ++i) {
+    const NodeId id = pending[i].first;
+    const base::Value& value = *pending[i].second;
+    Node node = index->nodes_[id];
+
+    if (const std::string* link = value.FindStringKey("link")) {
+      node.type = NodeType::kLink;
+      node.first = intern(*link);
+      node.count = static_cast<uint32_t>(link->size());
+      index->nodes_[id] = node;
+      continue;
+    }
+
+    if (const base::Value* files = value.FindDictKey("files")) {
+      std::vector<std::pair<base::StringPiece, const base::Value*>> children;
+      for (const auto item : files->DictItems()) {
+        if (item.second.is_dict())
+          children.emplace_back(item.first, &item.second);
+      }
+      std::sort(children.begin(), children.end(),
+                [](const auto& a, const auto& b) { return a.first < b.first; });
+
+      node.type = NodeType::kDirectory;
+      node.first = static_cast<uint32_t>(index->nodes_.size());
+      node.count = static_cast<uint32_t>(children.size());
+      index->nodes_[id] = node;
+      for (const auto& child : children) {
+        Node child_node;
+        child_node.name_offset = intern(child.first);
+        child_node.name_size = static_cast<uint32_t>(child.first.size());
+        pending.emplace_back(static_cast<NodeId>(index->nodes_.size()),
+                             child.second);
+        index->nodes_.push_back(child_node);
+      }
+      continue;
+    }
+
+    if (absl::optional<int> size = value.FindIntKey("size")) {
+      node.size = static_cast<uint32_t>(size.value());
+      node.flags |= Node::kHasSize;
+    }
+    if (value.FindBoolKey("unpacked").value_or(false))
+      node.flags |= Node::kUnpacked;
+    if (value.FindBoolKey("executable").value_or(false))
+      node.flags |= Node::kExecutable;
+    const std::string* offset = value.FindStringKey("offset");
+    if (offset &&
+        base::StringToUint64(base::StringPiece(*offset), &node.offset)) {
+      node.flags |= Node::kHasOffset;
+    }
+
+#if defined(OS_MAC)
+    if (load_integrity &&
+        electron::fuses::IsEmbeddedAsarIntegrityValidationEnabled()) {
+      IntegrityPayload integrity;
+      if (ReadIntegrity(value, &integrity)) {
+        node.integrity = static_cast<uint32_t>(index->integrity_.size());
+        index->integrity_.push_back(std::move(integrity));
+      }
+    }
+#endif
+
+    index->nodes_[id] = node;
+  }
+
+  index->nodes_.shrink_to_fit();
+  index->strings_.shrink_to_fit();
+  return index;
+}
+
+bool ArchiveIndex::Lookup(base::StringPiece path, NodeId* out) const {
+  return Lookup(path, out, 0);
+}
+
+bool ArchiveIndex::ResolveDirectory(NodeId id, NodeId* out) const {
+  return ResolveDirectory(id, out, 0);
+}
+
+base::StringPiece ArchiveIndex::Name(const Node& node) const {
+  return base::StringPiece(strings_.data() + node.name_offset, node.name_size);
+}
+
+base::StringPiece ArchiveIndex::LinkTarget(const Node& node) const {
+  DCHECK(node.type == NodeType::kLink);
+  return base::StringPiece(strings_.data() + node.first, node.count);
+}
+
+const IntegrityPayload* ArchiveIndex::Integrity(const Node& node) const {
+  if (node.integrity == Node::kNoIntegrity)
+    return nullptr;
+  return &integrity_[node.integrity];
+}
+
+bool ArchiveIndex::Lookup(base::StringPiece path,
+                          NodeId* out,
+                          int depth) const {
+  NodeId current = kRootNode;
+  size_t start = 0;
+  while (true) {
+    const size_t end = path.find_first_of(kSeparators, start);
+    const base::StringPiece name = path.substr(
+        start, end == base::StringPiece::npos ? end : end - start);
+
+    // An empty component refers back to the root, matching how the header
+    // has always been walked.
+    if (name.empty()) {
+      current = kRootNode;
+    } else {
+      NodeId dir;
+      if (!ResolveDirectory(current, &dir, depth) ||
+          !FindChild(dir, name, &current))
+        return false;
+    }
+
+    if (end == base::StringPiece::npos)
+      break;
+    start = end + 1;
+  }
+
+  *out = current;
+  return true;
+}
+
+bool ArchiveIndex::ResolveDirectory(NodeId id, NodeId* out, int depth) const {
+  const Node* dir = &nodes_[id];
+  if (dir->type == NodeType::kLink) {
+    if (depth >= kMaxLinkDepth ||
+        !Lookup(LinkTarget(*dir), &id, depth + 1))
+      return false;
+    dir = &nodes_[id];
+  }
+
+  if (dir->type != NodeType::kDirectory)
+    return false;
+
+  *out = id;
+  return true;
+}
+
+bool ArchiveIndex::FindChild(NodeId dir,
+                             base::StringPiece name,
+                             NodeId* out) const {
+  const Node& parent = nodes_[dir];
+  const auto begin = nodes_.begin() + parent.first;
+  const auto end = begin + parent.count;
+  const auto it = std::lower_bound(
+      begin, end, name,
+      [this](const Node& node, base::StringPiece name) {
+        return Name(node) < name;
+      });
+  if (it == end || Name(*it) != name)
+    return false;
+
+  *out = static_cast<NodeId>(it - nodes_.begin());
+  return true;
+}
+
+}  // namespace asar
@@ -0,0 +1,104 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ELECTRON_SHELL_COMMON_ASAR_ARCHIVE_INDEX_H_
+#define ELECTRON_SHELL_COMMON_ASAR_ARCHIVE_INDEX_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/strings/string_piece.h"
+#include "shell/common/asar/archive.h"
+
+namespace base {
+class Value;
+}
+
+namespace asar {
+
+// A compact, read-only index of an asar header.
+//
+// The JSON header is flattened once into a node table and an interned string
+// table. The children of every directory occupy a contiguous run of the node
+// table sorted by name, so resolving a path costs one binary search per path
+// component and never allocates.
+class ArchiveIndex {
+ public:
+  using NodeId = uint32_t;
+
+  static constexpr NodeId kRootNode = 0;
+
+  enum class NodeType : uint8_t {
+    kFile,
+    kDirectory,
+    kLink,
+  };
+
+  struct Node {
+    enum Flags : uint8_t {
+      kHasSize = 1 << 0,
+      kHasOffset = 1 << 1,
+      kUnpacked = 1 << 2,
+      kExecutable = 1 << 3,
+    };
+
+    static constexpr uint32_t kNoIntegrity = static_cast<uint32_t>(-1);
+
+    // The name of this node in the string table.
+    uint32_t name_offset = 0;
+    uint32_t name_size = 0;
+    // For directories the range of children in the node table, for links the
+    // target path in the string table.
+    uint32_t first = 0;
+    uint32_t count = 0;
+    uint64_t offset = 0;
+    uint32_t size = 0;
+    uint32_t integrity = kNoIntegrity;
+    NodeType type = NodeType::kFile;
+    uint8_t flags = 0;
+
+    bool HasFlag(Flags flag) const { return (flags & flag) != 0; }
+  };
+
+  // Builds the index from the parsed JSON |header|. Integrity payloads are
+  // only kept when |load_integrity| is true. Returns nullptr if the header is
+  // malformed.
+  static std::unique_ptr<ArchiveIndex> Create(const base::Value& header,
+                                              bool load_integrity);
+
+  ~ArchiveIndex();
+
+  // disable copy
+  ArchiveIndex(const ArchiveIndex&) = delete;
+  ArchiveIndex& operator=(const ArchiveIndex&) = delete;
+
+  // Resolves |path| relative to the root of the archive, following links in
+  // intermediate path components but not in the last one.
+  bool Lookup(base::StringPiece path, NodeId* out) const;
+
+  // Resolves the directory whose children are listed for |id|, following a
+  // link if |id| is one.
+  bool ResolveDirectory(NodeId id, NodeId* out) const;
+
+  const Node& node(NodeId id) const { return nodes_[id]; }
+  base::StringPiece Name(const Node& node) const;
+  base::StringPiece LinkTarget(const Node& node) const;
+  const IntegrityPayload* Integrity(const Node& node) const;
+
+ private:
+  ArchiveIndex();
+
+  bool Lookup(base::StringPiece path, NodeId* out, int depth) const;
+  bool ResolveDirectory(NodeId id, NodeId* out, int depth) const;
+  bool FindChild(NodeId dir, base::StringPiece name, NodeId* out) const;
+
+  std::vector<Node> nodes_;
+  std::string strings_;
+  std::vector<IntegrityPayload> integrity_;
+};
+
+}  // namespace asar
+
+#endif  // ELECTRON_SHELL_COMMON_ASAR_ARCHIVE_INDEX_H_
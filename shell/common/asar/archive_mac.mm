@@ -20,20 +20,36 @@
 
 namespace asar {
 
-absl::optional<base::FilePath> Archive::RelativePath() const {
+namespace {
+
+absl::optional<base::FilePath> GetBundleRelativePath(
+    const base::FilePath& path) {
   base::FilePath bundle_path = base::mac::MainBundlePath().Append("Contents");
 
   base::FilePath relative_path;
-  if (!bundle_path.AppendRelativePath(path_, &relative_path))
+  if (!bundle_path.AppendRelativePath(path, &relative_path))
     return absl::nullopt;
 
   return relative_path;
 }
 
+}  // namespace
+
+absl::optional<base::FilePath> Archive::RelativePath() const {
+  return GetBundleRelativePath(path_);
+}
+
 absl::optional<IntegrityPayload> Archive::HeaderIntegrity() const {
-  absl::optional<base::FilePath> relative_path = RelativePath();
   // Callers should have already asserted this
-  CHECK(relative_path.has_value());
+  CHECK(RelativePath().has_value());
+  return GetEmbeddedIntegrity(path_);
+}
+
+absl::optional<IntegrityPayload> GetEmbeddedIntegrity(
+    const base::FilePath& path) {
+  absl::optional<base::FilePath> relative_path = GetBundleRelativePath(path);
+  if (!relative_path.has_value())
+    return absl::nullopt;
 
   NSDictionary* integrity = [[NSBundle mainBundle]
       objectForInfoDictionaryKey:@"ElectronAsarIntegrity"];
@@ -130,20 +130,37 @@ bool ReadFileToString(const base::FilePath& path, std::string* contents) {
     return base::ReadFileToString(real_path, contents);
   }
 
-  base::File src(asar_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
-  if (!src.IsValid())
-    return false;
+  uint64_t integrity_generation = 0;
+  if (info.integrity.has_value())
+    integrity_generation = archive->RevalidateIntegrityCache();
+
+  base::span<const uint8_t> mapped_file = archive->GetMappedFile();
+  if (!mapped_file.empty()) {
+    if (info.offset > mapped_file.size() ||
+        info.size > mapped_file.size() - info.offset)
+      return false;
+    contents->assign(
+        reinterpret_cast<const char*>(mapped_file.data() + info.offset),
+        info.size);
+  } else {
+    base::File src(asar_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+    if (!src.IsValid())
+      return false;
 
-  contents->resize(info.size);
-  if (static_cast<int>(info.size) !=
-      src.Read(info.offset, const_cast<char*>(contents->data()),
-               contents->size())) {
-    return false;
+    contents->resize(info.size);
+    if (static_cast<int>(info.size) !=
+        src.Read(info.offset, const_cast<char*>(contents->data()),
+                 contents->size())) {
+      return false;
+    }
   }
 
-  if (info.integrity.has_value()) {
+  if (info.integrity.has_value() &&
+      !archive->IsIntegrityVerified(info.offset, info.size)) {
     ValidateIntegrityOrDie(contents->data(), contents->size(),
                            info.integrity.value());
+    archive->MarkIntegrityVerified(info.offset, info.size,
+                                   integrity_generation);
   }
 
   return true;
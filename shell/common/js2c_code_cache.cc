@@ -0,0 +1,67 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/js2c_code_cache.h"
+
+#include <cstring>
+#include <limits>
+
+#include "base/notreached.h"
+#include "shell/common/node_includes.h"
+
+namespace electron {
+
+std::vector<v8::Local<v8::String>> GetJs2cBundleParameters(
+    v8::Isolate* isolate,
+    const char* id) {
+  std::vector<v8::Local<v8::String>> parameters;
+  for (const Js2cBundle& bundle : kJs2cBundles) {
+    if (strcmp(bundle.id, id) != 0)
+      continue;
+    for (const char* name : bundle.parameters) {
+      parameters.push_back(
+          v8::String::NewFromUtf8(isolate, name,
+                                  v8::NewStringType::kInternalized)
+              .ToLocalChecked());
+    }
+    return parameters;
+  }
+  NOTREACHED() << "Unknown js2c bundle: " << id;
+  return parameters;
+}
+
+void RegisterJs2cCodeCache() {
+  for (const Js2cCodeCache& cache : GetJs2cCodeCaches()) {
+    node::native_module::NativeModuleEnv::AddCodeCache(
+        cache.id, cache.data, static_cast<int>(cache.size));
+  }
+}
+
+bool IsRendererJs2cBundle(const std::string& id) {
+  for (const Js2cBundle& bundle : kJs2cBundles) {
+    if (id == bundle.id)
+      return bundle.code_cache == Js2cCodeCacheSource::kRenderer;
+  }
+  return false;
+}
+
+bool AddRendererJs2cCodeCache(const std::string& id,
+                              base::span<const uint8_t> data) {
+  if (!IsRendererJs2cBundle(id) || data.empty() ||
+      data.size() > static_cast<size_t>(std::numeric_limits<int>::max()) ||
+      GetJs2cCodeCache(id))
+    return false;
+  node::native_module::NativeModuleEnv::AddCodeCache(
+      id.c_str(), data.data(), static_cast<int>(data.size()));
+  return true;
+}
+
+absl::optional<std::vector<uint8_t>> GetJs2cCodeCache(const std::string& id) {
+  std::vector<uint8_t> data;
+  if (!node::native_module::NativeModuleEnv::GetCodeCache(id.c_str(), &data))
+    return absl::nullopt;
+  return data;
+}
+
+}  // namespace electron
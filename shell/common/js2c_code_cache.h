@@ -0,0 +1,100 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ELECTRON_SHELL_COMMON_JS2C_CODE_CACHE_H_
+#define ELECTRON_SHELL_COMMON_JS2C_CODE_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+#include "v8/include/v8.h"
+
+namespace electron {
+
+// Where the code cache of a js2c bundle comes from. V8 rejects a cache created
+// with flags other than its own.
+enum class Js2cCodeCacheSource {
+  // Generated at build time, for the bundles the browser process runs.
+  kBuild,
+  // Created by the first renderer of a site that compiles the bundle and
+  // shared with the later ones through the browser. Renderers run with the
+  // flags Blink sets, which the generator has no way to reproduce.
+  kRenderer,
+};
+
+// A bundle built into the binary by the electron_js2c action, with the names
+// of the parameters of the function it is wrapped in. V8 doesn't check those
+// when it consumes a code cache, so the generator and the runtime both have to
+// compile the bundles with the parameters listed here.
+struct Js2cBundle {
+  const char* id;
+  base::span<const char* const> parameters;
+  Js2cCodeCacheSource code_cache;
+};
+
+// The init bundles are compiled by Node's builtin loader, which wraps them in
+// the same function as its own CommonJS builtins.
+constexpr const char* kNodeBuiltinParameters[] = {
+    "exports", "require",         "module",
+    "process", "internalBinding", "primordials"};
+constexpr const char* kAsarBundleParameters[] = {"require"};
+constexpr const char* kIsolatedBundleParameters[] = {"isolatedApi"};
+constexpr const char* kSandboxBundleParameters[] = {"binding"};
+
+constexpr Js2cBundle kJs2cBundles[] = {
+    {"electron/js2c/asar_bundle", kAsarBundleParameters,
+     Js2cCodeCacheSource::kBuild},
+    {"electron/js2c/browser_init", kNodeBuiltinParameters,
+     Js2cCodeCacheSource::kBuild},
+    {"electron/js2c/isolated_bundle", kIsolatedBundleParameters,
+     Js2cCodeCacheSource::kRenderer},
+    {"electron/js2c/renderer_init", kNodeBuiltinParameters,
+     Js2cCodeCacheSource::kRenderer},
+    {"electron/js2c/sandbox_bundle", kSandboxBundleParameters,
+     Js2cCodeCacheSource::kRenderer},
+    {"electron/js2c/worker_init", kNodeBuiltinParameters,
+     Js2cCodeCacheSource::kRenderer},
+};
+
+struct Js2cCodeCache {
+  const char* id;
+  const uint8_t* data;
+  size_t size;
+};
+
+// Defined by the electron_js2c_code_cache action, or empty when the caches
+// can't be generated on the build machine.
+base::span<const Js2cCodeCache> GetJs2cCodeCaches();
+
+// Returns the parameters the bundle |id| is compiled with.
+std::vector<v8::Local<v8::String>> GetJs2cBundleParameters(
+    v8::Isolate* isolate,
+    const char* id);
+
+// Hands the build-time code caches to Node's builtin loader. Has to be called
+// in the browser process before the bundles are compiled. V8 still rejects a
+// cache when --js-flags changed the flags, and compiles the bundle from source
+// instead.
+void RegisterJs2cCodeCache();
+
+// Whether |id| is a bundle whose code cache renderers create.
+bool IsRendererJs2cBundle(const std::string& id);
+
+// Hands |data| to Node's builtin loader as the code cache of the renderer
+// bundle |id|, unless the loader holds a cache for it already. |data| is not
+// copied and has to outlive the loader.
+bool AddRendererJs2cCodeCache(const std::string& id,
+                              base::span<const uint8_t> data);
+
+// Copies the code cache Node's builtin loader holds for the bundle |id|, which
+// is the one it created once the bundle is compiled.
+absl::optional<std::vector<uint8_t>> GetJs2cCodeCache(const std::string& id);
+
+}  // namespace electron
+
+#endif  // ELECTRON_SHELL_COMMON_JS2C_CODE_CACHE_H_
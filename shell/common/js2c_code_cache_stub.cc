@@ -0,0 +1,15 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/js2c_code_cache.h"
+
+namespace electron {
+
+// The generator can't run when cross-compiling, the bundles are then compiled
+// from source.
+base::span<const Js2cCodeCache> GetJs2cCodeCaches() {
+  return {};
+}
+
+}  // namespace electron
@@ -34,6 +34,7 @@
 #include "shell/common/gin_helper/event_emitter_caller.h"
 #include "shell/common/gin_helper/locker.h"
 #include "shell/common/gin_helper/microtasks_scope.h"
+#include "shell/common/js2c_code_cache.h"
 #include "shell/common/mac/main_application_bundle.h"
 #include "shell/common/node_includes.h"
 #include "third_party/blink/renderer/bindings/core/v8/v8_initializer.h"  // nogncheck
@@ -57,6 +58,7 @@
   V(electron_browser_in_app_purchase)    \
   V(electron_browser_menu)               \
   V(electron_browser_message_port)       \
+  V(electron_browser_module_code_cache)  \
   V(electron_browser_net)                \
   V(electron_browser_power_monitor)      \
   V(electron_browser_power_save_blocker) \
@@ -65,6 +67,7 @@
   V(electron_browser_safe_storage)       \
   V(electron_browser_scroll_view)        \
   V(electron_browser_session)            \
+  V(electron_browser_startup_snapshot)   \
   V(electron_browser_system_preferences) \
   V(electron_browser_base_window)        \
   V(electron_browser_tray)               \
@@ -302,8 +305,6 @@ void SetNodeOptions(base::Environment* env) {
 
 namespace electron {
 
-namespace {
-
 base::FilePath GetResourcesPath() {
 #if defined(OS_MAC)
   return MainApplicationBundlePath().Append("Contents").Append("Resources");
@@ -316,8 +317,6 @@ base::FilePath GetResourcesPath() {
 #endif
 }
 
-}  // namespace
-
 NodeBindings::NodeBindings(BrowserEnvironment browser_env)
     : browser_env_(browser_env) {
   if (browser_env == BrowserEnvironment::kWorker) {
@@ -380,6 +379,12 @@ void NodeBindings::Initialize() {
   // Explicitly register electron's builtin modules.
   RegisterBuiltinModules();
 
+  // Provide the code caches of the js2c bundles before any of them is
+  // compiled. They are only generated for the flags of the browser process,
+  // renderers get theirs from the browser, see CodeCacheAgent.
+  if (browser_env_ == BrowserEnvironment::kBrowser)
+    RegisterJs2cCodeCache();
+
   // Parse and set Node.js cli flags.
   SetNodeCliFlags();
 
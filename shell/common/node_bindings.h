@@ -72,6 +72,10 @@ class UvHandle {
   T* t_ = {};
 };
 
+// Returns the directory that holds the resources of the app, which is exposed
+// as process.resourcesPath.
+base::FilePath GetResourcesPath();
+
 class NodeBindings {
  public:
   enum class BrowserEnvironment { kBrowser, kRenderer, kWorker };
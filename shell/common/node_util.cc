@@ -5,6 +5,7 @@
 #include "shell/common/node_util.h"
 
 #include "base/logging.h"
+#include "shell/common/js2c_code_cache.h"
 #include "shell/common/node_includes.h"
 
 namespace electron {
@@ -14,14 +15,15 @@ namespace util {
 v8::MaybeLocal<v8::Value> CompileAndCall(
     v8::Local<v8::Context> context,
     const char* id,
-    std::vector<v8::Local<v8::String>>* parameters,
     std::vector<v8::Local<v8::Value>>* arguments,
     node::Environment* optional_env) {
   v8::Isolate* isolate = context->GetIsolate();
   v8::TryCatch try_catch(isolate);
+  std::vector<v8::Local<v8::String>> parameters =
+      GetJs2cBundleParameters(isolate, id);
   v8::MaybeLocal<v8::Function> compiled =
       node::native_module::NativeModuleEnv::LookupAndCompile(
-          context, id, parameters, optional_env);
+          context, id, &parameters, optional_env);
   if (compiled.IsEmpty()) {
     return v8::MaybeLocal<v8::Value>();
   }
@@ -19,13 +19,13 @@ namespace util {
 
 // Run a script with JS source bundled inside the binary as if it's wrapped
 // in a function called with a null receiver and arguments specified in C++.
+// The function's parameters are the ones listed for |id| in kJs2cBundles.
 // The returned value is empty if an exception is encountered.
 // JS code run with this method can assume that their top-level
 // declarations won't affect the global scope.
 v8::MaybeLocal<v8::Value> CompileAndCall(
     v8::Local<v8::Context> context,
     const char* id,
-    std::vector<v8::Local<v8::String>>* parameters,
     std::vector<v8::Local<v8::Value>>* arguments,
     node::Environment* optional_env);
 
@@ -212,6 +212,9 @@ const char kPpapiFlashVersion[] = "ppapi-flash-version";
 // Disable HTTP cache.
 const char kDisableHttpCache[] = "disable-http-cache";
 
+// Disable the on-disk code cache of the modules loaded by the main process.
+const char kDisableModuleCodeCache[] = "disable-module-code-cache";
+
 // The list of standard schemes.
 const char kStandardSchemes[] = "standard-schemes";
 
@@ -274,6 +277,12 @@ const char kGlobalCrashKeys[] = "global-crash-keys";
 
 const char kEnableWebSQL[] = "enable-websql";
 
+// Build the startup snapshot of the app from an entry script and exit.
+const char kBuildSnapshot[] = "build-snapshot";
+
+// Path of the startup snapshot of the app.
+const char kSnapshotBlob[] = "snapshot-blob";
+
 }  // namespace switches
 
 }  // namespace electron
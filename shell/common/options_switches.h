@@ -108,6 +108,7 @@ extern const char kEnableSandbox[];
 extern const char kPpapiFlashPath[];
 extern const char kPpapiFlashVersion[];
 extern const char kDisableHttpCache[];
+extern const char kDisableModuleCodeCache[];
 extern const char kStandardSchemes[];
 extern const char kServiceWorkerSchemes[];
 extern const char kSecureSchemes[];
@@ -134,6 +135,9 @@ extern const char kDisableNTLMv2[];
 extern const char kGlobalCrashKeys[];
 
 extern const char kEnableWebSQL[];
+
+extern const char kBuildSnapshot[];
+extern const char kSnapshotBlob[];
 }  // namespace switches
 
 }  // namespace electron
@@ -4,9 +4,12 @@
 
 #include "shell/common/v8_value_serializer.h"
 
+#include <cstring>
+#include <memory>
 #include <utility>
 #include <vector>
 
+#include "base/memory/shared_memory_mapping.h"
 #include "gin/converter.h"
 #include "shell/common/api/electron_api_native_image.h"
 #include "shell/common/gin_helper/microtasks_scope.h"
@@ -18,13 +21,125 @@
 namespace electron {
 
 namespace {
-enum SerializationTag { kNativeImageTag = 'i', kVersionTag = 0xFF };
+
+enum SerializationTag {
+  kNativeImageTag = 'i',
+  kArrayBufferViewTag = 'v',
+  kVersionTag = 0xFF
+};
+
+enum class ArrayBufferViewType : uint32_t {
+  kInt8,
+  kUint8,
+  kUint8Clamped,
+  kInt16,
+  kUint16,
+  kInt32,
+  kUint32,
+  kFloat32,
+  kFloat64,
+  kBigInt64,
+  kBigUint64,
+  kDataView,
+  kMaxValue = kDataView,
+};
+
+ArrayBufferViewType GetArrayBufferViewType(
+    v8::Local<v8::ArrayBufferView> view) {
+  if (view->IsInt8Array())
+    return ArrayBufferViewType::kInt8;
+  if (view->IsUint8Array())
+    return ArrayBufferViewType::kUint8;
+  if (view->IsUint8ClampedArray())
+    return ArrayBufferViewType::kUint8Clamped;
+  if (view->IsInt16Array())
+    return ArrayBufferViewType::kInt16;
+  if (view->IsUint16Array())
+    return ArrayBufferViewType::kUint16;
+  if (view->IsInt32Array())
+    return ArrayBufferViewType::kInt32;
+  if (view->IsUint32Array())
+    return ArrayBufferViewType::kUint32;
+  if (view->IsFloat32Array())
+    return ArrayBufferViewType::kFloat32;
+  if (view->IsFloat64Array())
+    return ArrayBufferViewType::kFloat64;
+  if (view->IsBigInt64Array())
+    return ArrayBufferViewType::kBigInt64;
+  if (view->IsBigUint64Array())
+    return ArrayBufferViewType::kBigUint64;
+  return ArrayBufferViewType::kDataView;
+}
+
+size_t GetElementSize(ArrayBufferViewType type) {
+  switch (type) {
+    case ArrayBufferViewType::kInt16:
+    case ArrayBufferViewType::kUint16:
+      return 2;
+    case ArrayBufferViewType::kInt32:
+    case ArrayBufferViewType::kUint32:
+    case ArrayBufferViewType::kFloat32:
+      return 4;
+    case ArrayBufferViewType::kFloat64:
+    case ArrayBufferViewType::kBigInt64:
+    case ArrayBufferViewType::kBigUint64:
+      return 8;
+    default:
+      return 1;
+  }
+}
+
+// Create a view of |type| over |byte_length| bytes of |buffer| starting at
+// |byte_offset|.
+v8::MaybeLocal<v8::Object> NewArrayBufferView(ArrayBufferViewType type,
+                                              v8::Local<v8::ArrayBuffer> buffer,
+                                              size_t byte_offset,
+                                              size_t byte_length) {
+  const size_t element_size = GetElementSize(type);
+  if (byte_length % element_size)
+    return v8::MaybeLocal<v8::Object>();
+  const size_t length = byte_length / element_size;
+  switch (type) {
+    case ArrayBufferViewType::kInt8:
+      return v8::Int8Array::New(buffer, byte_offset, length);
+    case ArrayBufferViewType::kUint8:
+      return v8::Uint8Array::New(buffer, byte_offset, length);
+    case ArrayBufferViewType::kUint8Clamped:
+      return v8::Uint8ClampedArray::New(buffer, byte_offset, length);
+    case ArrayBufferViewType::kInt16:
+      return v8::Int16Array::New(buffer, byte_offset, length);
+    case ArrayBufferViewType::kUint16:
+      return v8::Uint16Array::New(buffer, byte_offset, length);
+    case ArrayBufferViewType::kInt32:
+      return v8::Int32Array::New(buffer, byte_offset, length);
+    case ArrayBufferViewType::kUint32:
+      return v8::Uint32Array::New(buffer, byte_offset, length);
+    case ArrayBufferViewType::kFloat32:
+      return v8::Float32Array::New(buffer, byte_offset, length);
+    case ArrayBufferViewType::kFloat64:
+      return v8::Float64Array::New(buffer, byte_offset, length);
+    case ArrayBufferViewType::kBigInt64:
+      return v8::BigInt64Array::New(buffer, byte_offset, length);
+    case ArrayBufferViewType::kBigUint64:
+      return v8::BigUint64Array::New(buffer, byte_offset, length);
+    case ArrayBufferViewType::kDataView:
+      return v8::DataView::New(buffer, byte_offset, length);
+  }
+  return v8::MaybeLocal<v8::Object>();
+}
+
 }  // namespace
 
 class V8Serializer : public v8::ValueSerializer::Delegate {
  public:
-  explicit V8Serializer(v8::Isolate* isolate)
-      : isolate_(isolate), serializer_(isolate, this) {}
+  explicit V8Serializer(v8::Isolate* isolate,
+                        OutOfBandBuffers* buffers = nullptr)
+      : isolate_(isolate), buffers_(buffers), serializer_(isolate, this) {
+    // Views are written by WriteArrayBufferView, which decides whether their
+    // contents go out of band.
+    if (buffers_)
+      serializer_.SetTreatArrayBufferViewsAsHostObjects(true);
+  }
   ~V8Serializer() override = default;
 
   bool Serialize(v8::Local<v8::Value> value, blink::CloneableMessage* out) {
@@ -32,6 +147,9 @@ class V8Serializer : public v8::ValueSerializer::Delegate {
         isolate_, v8::MicrotasksScope::kDoNotRunMicrotasks);
     WriteBlinkEnvelope(19);
 
+    if (buffers_ && value->IsArray())
+      TransferArrayBuffers(value.As<v8::Array>());
+
     serializer_.WriteHeader();
     bool wrote_value;
     if (!serializer_.WriteValue(isolate_->GetCurrentContext(), value)
@@ -67,6 +185,11 @@ class V8Serializer : public v8::ValueSerializer::Delegate {
 
   v8::Maybe<bool> WriteHostObject(v8::Isolate* isolate,
                                   v8::Local<v8::Object> object) override {
+    if (buffers_ && object->IsArrayBufferView()) {
+      WriteArrayBufferView(object.As<v8::ArrayBufferView>());
+      return v8::Just(true);
+    }
+
     api::NativeImage* native_image;
     if (gin::ConvertFromV8(isolate, object, &native_image)) {
       // Serialize the NativeImage
@@ -102,18 +225,88 @@ class V8Serializer : public v8::ValueSerializer::Delegate {
     serializer_.WriteUint32(blink_version);
   }
 
+  // Copy |size| bytes at |data| into a new out-of-band buffer and return its
+  // index, or -1 if the message already has |kMaxOutOfBandBuffers| of them or
+  // no shared memory could be allocated for it.
+  //
+  // Only the read-only region is sent, and the writable mapping is dropped
+  // before that, so the receiver can trust the contents not to change.
+  int AddOutOfBandBuffer(const void* data, size_t size) {
+    if (buffers_->size() >= kMaxOutOfBandBuffers)
+      return -1;
+    base::MappedReadOnlyRegion shared =
+        base::ReadOnlySharedMemoryRegion::Create(size);
+    if (!shared.IsValid())
+      return -1;
+    memcpy(shared.mapping.memory(), data, size);
+    buffers_->push_back(std::move(shared.region));
+    return buffers_->size() - 1;
+  }
+
+  // IPC arguments are always an array, so large ArrayBuffers passed as
+  // arguments are found there, and marked as transferred to have the
+  // serializer refer to them by index instead of copying their contents.
+  void TransferArrayBuffers(v8::Local<v8::Array> args) {
+    v8::Local<v8::Context> context = isolate_->GetCurrentContext();
+    for (uint32_t i = 0; i < args->Length(); ++i) {
+      v8::Local<v8::Value> arg;
+      if (!args->Get(context, i).ToLocal(&arg) || !arg->IsArrayBuffer())
+        continue;
+      v8::Local<v8::ArrayBuffer> buffer = arg.As<v8::ArrayBuffer>();
+      if (buffer->ByteLength() < kMinOutOfBandBufferSize)
+        continue;
+      const int index = AddOutOfBandBuffer(buffer->GetBackingStore()->Data(),
+                                           buffer->ByteLength());
+      if (index >= 0)
+        serializer_.TransferArrayBuffer(index, buffer);
+    }
+  }
+
+  void WriteArrayBufferView(v8::Local<v8::ArrayBufferView> view) {
+    WriteTag(kArrayBufferViewTag);
+    serializer_.WriteUint32(
+        static_cast<uint32_t>(GetArrayBufferViewType(view)));
+
+    const size_t size = view->ByteLength();
+    const uint8_t* data = nullptr;
+    std::shared_ptr<v8::BackingStore> backing_store;
+    if (size) {
+      backing_store = view->Buffer()->GetBackingStore();
+      data = static_cast<const uint8_t*>(backing_store->Data()) +
+             view->ByteOffset();
+    }
+
+    if (size >= kMinOutOfBandBufferSize) {
+      const int index = AddOutOfBandBuffer(data, size);
+      if (index >= 0) {
+        serializer_.WriteUint32(1);
+        serializer_.WriteUint32(index);
+        return;
+      }
+    }
+    serializer_.WriteUint32(0);
+    serializer_.WriteUint32(size);
+    serializer_.WriteRawBytes(data, size);
+  }
+
   v8::Isolate* isolate_;
+  OutOfBandBuffers* buffers_;
   std::vector<uint8_t> data_;
   v8::ValueSerializer serializer_;
 };
 
 class V8Deserializer : public v8::ValueDeserializer::Delegate {
  public:
-  V8Deserializer(v8::Isolate* isolate, base::span<const uint8_t> data)
+  V8Deserializer(v8::Isolate* isolate,
+                 base::span<const uint8_t> data,
+                 const OutOfBandBuffers* buffers = nullptr)
       : isolate_(isolate),
+        buffers_(buffers),
         deserializer_(isolate, data.data(), data.size(), this) {}
-  V8Deserializer(v8::Isolate* isolate, const blink::CloneableMessage& message)
-      : V8Deserializer(isolate, message.encoded_message) {}
+  V8Deserializer(v8::Isolate* isolate,
+                 const blink::CloneableMessage& message,
+                 const OutOfBandBuffers* buffers = nullptr)
+      : V8Deserializer(isolate, message.encoded_message, buffers) {}
 
   v8::Local<v8::Value> Deserialize() {
     v8::EscapableHandleScope scope(isolate_);
@@ -123,6 +316,9 @@ class V8Deserializer : public v8::ValueDeserializer::Delegate {
     if (!ReadBlinkEnvelope(&blink_version))
       return v8::Null(isolate_);
 
+    if (buffers_ && !MapOutOfBandBuffers())
+      return v8::Null(isolate_);
+
     bool read_header;
     if (!deserializer_.ReadHeader(context).To(&read_header))
       return v8::Null(isolate_);
@@ -142,6 +338,12 @@ class V8Deserializer : public v8::ValueDeserializer::Delegate {
         if (api::NativeImage* native_image = ReadNativeImage(isolate))
           return native_image->GetWrapper(isolate);
         break;
+      case kArrayBufferViewTag: {
+        v8::Local<v8::Object> view;
+        if (ReadArrayBufferView().ToLocal(&view))
+          return view;
+        break;
+      }
     }
     // Throws an exception.
     return v8::ValueDeserializer::Delegate::ReadHostObject(isolate);
@@ -167,6 +369,54 @@ class V8Deserializer : public v8::ValueDeserializer::Delegate {
     return true;
   }
 
+  // Copy every out-of-band buffer into an ArrayBuffer, and make them available
+  // to the deserializer as transferred buffers. The mappings are read-only, so
+  // they can't back ArrayBuffers that script is free to write to.
+  bool MapOutOfBandBuffers() {
+    if (buffers_->size() > kMaxOutOfBandBuffers)
+      return false;
+    for (size_t i = 0; i < buffers_->size(); ++i) {
+      base::ReadOnlySharedMemoryMapping mapping = (*buffers_)[i].Map();
+      if (!mapping.IsValid())
+        return false;
+      const size_t size = mapping.size();
+      v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate_, size);
+      if (size)
+        memcpy(buffer->GetBackingStore()->Data(), mapping.memory(), size);
+      deserializer_.TransferArrayBuffer(i, buffer);
+      array_buffers_.push_back(buffer);
+    }
+    return true;
+  }
+
+  v8::MaybeLocal<v8::Object> ReadArrayBufferView() {
+    uint32_t type = 0;
+    uint32_t out_of_band = 0;
+    if (!deserializer_.ReadUint32(&type) ||
+        type > static_cast<uint32_t>(ArrayBufferViewType::kMaxValue) ||
+        !deserializer_.ReadUint32(&out_of_band))
+      return v8::MaybeLocal<v8::Object>();
+
+    v8::Local<v8::ArrayBuffer> buffer;
+    if (out_of_band) {
+      uint32_t index = 0;
+      if (!deserializer_.ReadUint32(&index) || index >= array_buffers_.size())
+        return v8::MaybeLocal<v8::Object>();
+      buffer = array_buffers_[index];
+    } else {
+      uint32_t size = 0;
+      const void* data = nullptr;
+      if (!deserializer_.ReadUint32(&size) ||
+          !deserializer_.ReadRawBytes(size, &data))
+        return v8::MaybeLocal<v8::Object>();
+      buffer = v8::ArrayBuffer::New(isolate_, size);
+      if (size)
+        memcpy(buffer->GetBackingStore()->Data(), data, size);
+    }
+    return NewArrayBufferView(static_cast<ArrayBufferViewType>(type), buffer, 0,
+                              buffer->ByteLength());
+  }
+
   api::NativeImage* ReadNativeImage(v8::Isolate* isolate) {
     gfx::ImageSkia image_skia;
     uint32_t num_reps = 0;
@@ -193,9 +443,21 @@ class V8Deserializer : public v8::ValueDeserializer::Delegate {
   }
 
   v8::Isolate* isolate_;
+  const OutOfBandBuffers* buffers_;
+  std::vector<v8::Local<v8::ArrayBuffer>> array_buffers_;
   v8::ValueDeserializer deserializer_;
 };
 
+v8::Local<v8::Object> NewArrayBufferViewLike(
+    v8::Local<v8::ArrayBufferView> view,
+    v8::Local<v8::ArrayBuffer> buffer,
+    size_t byte_offset,
+    size_t byte_length) {
+  return NewArrayBufferView(GetArrayBufferViewType(view), buffer, byte_offset,
+                            byte_length)
+      .ToLocalChecked();
+}
+
 bool SerializeV8Value(v8::Isolate* isolate,
                       v8::Local<v8::Value> value,
                       blink::CloneableMessage* out) {
@@ -212,4 +474,17 @@ v8::Local<v8::Value> DeserializeV8Value(v8::Isolate* isolate,
   return V8Deserializer(isolate, data).Deserialize();
 }
 
+bool SerializeV8Value(v8::Isolate* isolate,
+                      v8::Local<v8::Value> value,
+                      blink::CloneableMessage* out,
+                      OutOfBandBuffers* buffers) {
+  return V8Serializer(isolate, buffers).Serialize(value, out);
+}
+
+v8::Local<v8::Value> DeserializeV8Value(v8::Isolate* isolate,
+                                        const blink::CloneableMessage& in,
+                                        const OutOfBandBuffers& buffers) {
+  return V8Deserializer(isolate, in, &buffers).Deserialize();
+}
+
 }  // namespace electron
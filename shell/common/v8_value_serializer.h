@@ -5,12 +5,18 @@
 #ifndef ELECTRON_SHELL_COMMON_V8_VALUE_SERIALIZER_H_
 #define ELECTRON_SHELL_COMMON_V8_VALUE_SERIALIZER_H_
 
+#include <vector>
+
 #include "base/containers/span.h"
+#include "base/memory/read_only_shared_memory_region.h"
 
 namespace v8 {
+class ArrayBuffer;
+class ArrayBufferView;
 class Isolate;
 template <class T>
 class Local;
+class Object;
 class Value;
 }  // namespace v8
 
@@ -20,6 +26,17 @@ struct CloneableMessage;
 
 namespace electron {
 
+// The contents of large array buffers, kept out of a serialized message so
+// that they are not copied again by every hop of the IPC. The regions are
+// read-only, so the sender can't change them after they are received.
+using OutOfBandBuffers = std::vector<base::ReadOnlySharedMemoryRegion>;
+
+// ArrayBuffers and ArrayBuffer views at least this large are sent out of band.
+constexpr size_t kMinOutOfBandBufferSize = 64 * 1024;
+// Every out-of-band buffer is a shared memory region, and a handle to pass
+// along with the message. Large buffers beyond this many are sent inline.
+constexpr size_t kMaxOutOfBandBuffers = 16;
+
 bool SerializeV8Value(v8::Isolate* isolate,
                       v8::Local<v8::Value> value,
                       blink::CloneableMessage* out);
@@ -28,6 +45,28 @@ v8::Local<v8::Value> DeserializeV8Value(v8::Isolate* isolate,
 v8::Local<v8::Value> DeserializeV8Value(v8::Isolate* isolate,
                                         base::span<const uint8_t> data);
 
+// Like the above, but the contents of large array buffers are copied into
+// shared memory regions appended to |buffers| instead of into |out|. The
+// ArrayBuffers created when deserializing hold their own copy of that memory.
+//
+// Only IPC messages use this format; messages posted to a MessagePort are
+// read by Blink and must be serialized without |buffers|.
+bool SerializeV8Value(v8::Isolate* isolate,
+                      v8::Local<v8::Value> value,
+                      blink::CloneableMessage* out,
+                      OutOfBandBuffers* buffers);
+v8::Local<v8::Value> DeserializeV8Value(v8::Isolate* isolate,
+                                        const blink::CloneableMessage& in,
+                                        const OutOfBandBuffers& buffers);
+
+// Creates a view of the same type as |view| over |byte_length| bytes of
+// |buffer| starting at |byte_offset|.
+v8::Local<v8::Object> NewArrayBufferViewLike(
+    v8::Local<v8::ArrayBufferView> view,
+    v8::Local<v8::ArrayBuffer> buffer,
+    size_t byte_offset,
+    size_t byte_length);
+
 }  // namespace electron
 
 #endif  // ELECTRON_SHELL_COMMON_V8_VALUE_SERIALIZER_H_
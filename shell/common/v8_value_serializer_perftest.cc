@@ -0,0 +1,107 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/v8_value_serializer.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "gin/test/v8_test.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/blink/public/common/messaging/cloneable_message.h"
+#include "v8/include/v8.h"
+
+namespace electron {
+
+namespace {
+
+struct Payload {
+  const char* name;
+  size_t size;
+  int iterations;
+};
+
+constexpr Payload kPayloads[] = {
+    {"1KB", 1024, 10000},
+    {"1MB", 1024 * 1024, 100},
+    {"64MB", 64 * 1024 * 1024, 4},
+};
+
+class V8ValueSerializerPerfTest : public gin::V8Test {
+ protected:
+  // The arguments of an IPC message carrying a single Uint8Array.
+  v8::Local<v8::Value> CreateArguments(size_t size) {
+    v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate(), size);
+    memset(buffer->GetBackingStore()->Data(), 'x', size);
+    v8::Local<v8::Value> view = v8::Uint8Array::New(buffer, 0, size);
+    return v8::Array::New(isolate(), &view, 1);
+  }
+
+  // Serialize the arguments into the message body, then copy the body as
+  // sending it over a message pipe would.
+  v8::Local<v8::Value> SendInline(v8::Local<v8::Value> arguments) {
+    blink::CloneableMessage message;
+    EXPECT_TRUE(SerializeV8Value(isolate(), arguments, &message));
+    std::vector<uint8_t> received(message.encoded_message.begin(),
+                                  message.encoded_message.end());
+    return DeserializeV8Value(isolate(), received);
+  }
+
+  // Only the message body is copied; the buffers are shared memory handles.
+  v8::Local<v8::Value> SendOutOfBand(v8::Local<v8::Value> arguments) {
+    blink::CloneableMessage message;
+    OutOfBandBuffers buffers;
+    EXPECT_TRUE(SerializeV8Value(isolate(), arguments, &message, &buffers));
+    blink::CloneableMessage received;
+    received.owned_encoded_message.assign(message.encoded_message.begin(),
+                                          message.encoded_message.end());
+    received.encoded_message = received.owned_encoded_message;
+    return DeserializeV8Value(isolate(), received, buffers);
+  }
+
+  v8::Isolate* isolate() { return instance_->isolate(); }
+
+  template <typename Send>
+  void RunPayloads(const std::string& story, Send send) {
+    v8::HandleScope handle_scope(isolate());
+    v8::Context::Scope context_scope(context_.Get(isolate()));
+
+    perf_test::PerfResultReporter reporter("V8ValueSerializer", story);
+    reporter.RegisterImportantMetric("_throughput", "MB/s");
+    reporter.RegisterImportantMetric("_time_per_message", "us");
+    for (const Payload& payload : kPayloads) {
+      v8::Local<v8::Value> arguments = CreateArguments(payload.size);
+      base::ElapsedTimer timer;
+      for (int i = 0; i < payload.iterations; ++i) {
+        v8::HandleScope iteration_scope(isolate());
+        v8::Local<v8::Value> result = (this->*send)(arguments);
+        ASSERT_TRUE(result->IsArray());
+      }
+      const base::TimeDelta elapsed = timer.Elapsed();
+      const double megabytes =
+          static_cast<double>(payload.size) * payload.iterations / (1 << 20);
+      reporter.AddResult(base::StringPrintf("_throughput_%s", payload.name),
+                         megabytes / elapsed.InSecondsF());
+      reporter.AddResult(
+          base::StringPrintf("_time_per_message_%s", payload.name),
+          elapsed.InMicrosecondsF() / payload.iterations);
+    }
+  }
+};
+
+}  // namespace
+
+TEST_F(V8ValueSerializerPerfTest, Inline) {
+  RunPayloads("inline", &V8ValueSerializerPerfTest::SendInline);
+}
+
+TEST_F(V8ValueSerializerPerfTest, OutOfBand) {
+  RunPayloads("out_of_band", &V8ValueSerializerPerfTest::SendOutOfBand);
+}
+
+}  // namespace electron
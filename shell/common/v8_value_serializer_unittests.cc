@@ -0,0 +1,91 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/v8_value_serializer.h"
+
+#include <cstring>
+#include <vector>
+
+#include "gin/test/v8_test.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/blink/public/common/messaging/cloneable_message.h"
+#include "v8/include/v8.h"
+
+namespace electron {
+
+namespace {
+
+class V8ValueSerializerTest : public gin::V8Test {
+ protected:
+  // The arguments of an IPC message carrying |count| Uint8Arrays of |size|
+  // bytes each.
+  v8::Local<v8::Value> CreateArguments(size_t size, size_t count = 1) {
+    std::vector<v8::Local<v8::Value>> views;
+    for (size_t i = 0; i < count; ++i) {
+      v8::Local<v8::ArrayBuffer> buffer =
+          v8::ArrayBuffer::New(isolate(), size);
+      memset(buffer->GetBackingStore()->Data(), 'x', size);
+      views.push_back(v8::Uint8Array::New(buffer, 0, size));
+    }
+    return v8::Array::New(isolate(), views.data(), views.size());
+  }
+
+  // Checks that |result| holds |count| Uint8Arrays of |size| bytes of 'x'.
+  void ExpectArguments(v8::Local<v8::Value> result,
+                       size_t size,
+                       size_t count = 1) {
+    v8::Local<v8::Context> context = context_.Get(isolate());
+    ASSERT_TRUE(result->IsArray());
+    ASSERT_EQ(count, result.As<v8::Array>()->Length());
+    for (size_t i = 0; i < count; ++i) {
+      v8::Local<v8::Value> view =
+          result.As<v8::Array>()->Get(context, i).ToLocalChecked();
+      ASSERT_TRUE(view->IsUint8Array());
+      ASSERT_EQ(size, view.As<v8::Uint8Array>()->ByteLength());
+      EXPECT_EQ('x', static_cast<const char*>(view.As<v8::Uint8Array>()
+                                                  ->Buffer()
+                                                  ->GetBackingStore()
+                                                  ->Data())[size - 1]);
+    }
+  }
+
+  v8::Isolate* isolate() { return instance_->isolate(); }
+};
+
+}  // namespace
+
+TEST_F(V8ValueSerializerTest, RoundTripsOutOfBand) {
+  v8::HandleScope handle_scope(isolate());
+  v8::Context::Scope context_scope(context_.Get(isolate()));
+
+  for (const size_t size : {size_t{16}, kMinOutOfBandBufferSize}) {
+    v8::Local<v8::Value> arguments = CreateArguments(size);
+    blink::CloneableMessage message;
+    OutOfBandBuffers buffers;
+    ASSERT_TRUE(SerializeV8Value(isolate(), arguments, &message, &buffers));
+    EXPECT_EQ(size >= kMinOutOfBandBufferSize ? 1u : 0u, buffers.size());
+    EXPECT_LT(message.encoded_message.size(), size_t{16} + 64);
+
+    ExpectArguments(DeserializeV8Value(isolate(), message, buffers), size);
+  }
+}
+
+TEST_F(V8ValueSerializerTest, SendsBuffersBeyondLimitInline) {
+  v8::HandleScope handle_scope(isolate());
+  v8::Context::Scope context_scope(context_.Get(isolate()));
+
+  const size_t count = kMaxOutOfBandBuffers + 2;
+  v8::Local<v8::Value> arguments =
+      CreateArguments(kMinOutOfBandBufferSize, count);
+  blink::CloneableMessage message;
+  OutOfBandBuffers buffers;
+  ASSERT_TRUE(SerializeV8Value(isolate(), arguments, &message, &buffers));
+  EXPECT_EQ(kMaxOutOfBandBuffers, buffers.size());
+  EXPECT_GT(message.encoded_message.size(), 2 * kMinOutOfBandBufferSize);
+
+  ExpectArguments(DeserializeV8Value(isolate(), message, buffers),
+                  kMinOutOfBandBufferSize, count);
+}
+
+}  // namespace electron
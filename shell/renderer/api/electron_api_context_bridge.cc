@@ -4,6 +4,7 @@
 
 #include "shell/renderer/api/electron_api_context_bridge.h"
 
+#include <cstring>
 #include <memory>
 #include <set>
 #include <string>
@@ -23,6 +24,7 @@
 #include "shell/common/gin_helper/dictionary.h"
 #include "shell/common/gin_helper/promise.h"
 #include "shell/common/node_includes.h"
+#include "shell/common/v8_value_serializer.h"
 #include "shell/common/world_ids.h"
 #include "third_party/blink/public/web/web_blob.h"
 #include "third_party/blink/public/web/web_element.h"
@@ -46,6 +48,7 @@ const char kProxyFunctionPrivateKey[] = "electron_contextBridge_proxy_fn";
 const char kSupportsDynamicPropertiesPrivateKey[] =
     "electron_contextBridge_supportsDynamicProperties";
 const char kOriginalFunctionPrivateKey[] = "electron_contextBridge_original_fn";
+const char kTransferPrivateKey[] = "electron_contextBridge_transfer";
 
 }  // namespace context_bridge
 
@@ -131,6 +134,154 @@ v8::MaybeLocal<v8::Value> GetPrivate(v8::Local<v8::Context> context,
                           gin::StringToV8(context->GetIsolate(), key)));
 }
 
+// Both worlds share one isolate, so an ArrayBuffer can be passed by copying
+// its contents once, or by moving its backing store if it was marked with
+// contextBridge.markForTransfer() and can be detached.
+v8::Local<v8::ArrayBuffer> PassArrayBufferToOtherContext(
+    v8::Local<v8::Context> source_context,
+    v8::Local<v8::Context> destination_context,
+    v8::Local<v8::ArrayBuffer> buffer) {
+  v8::Isolate* isolate = destination_context->GetIsolate();
+  std::shared_ptr<v8::BackingStore> backing_store = buffer->GetBackingStore();
+
+  v8::Local<v8::Value> transfer;
+  if (GetPrivate(source_context, buffer, context_bridge::kTransferPrivateKey)
+          .ToLocal(&transfer) &&
+      transfer->IsTrue() && buffer->IsDetachable()) {
+    buffer->Detach();
+    v8::Context::Scope destination_context_scope(destination_context);
+    return v8::ArrayBuffer::New(isolate, std::move(backing_store));
+  }
+
+  v8::Context::Scope destination_context_scope(destination_context);
+  const size_t size = buffer->ByteLength();
+  v8::Local<v8::ArrayBuffer> copy = v8::ArrayBuffer::New(isolate, size);
+  if (size)
+    memcpy(copy->GetBackingStore()->Data(), backing_store->Data(), size);
+  return copy;
+}
+
+// Copies plain arrays and objects, and the primitives and dates in them, into
+// the destination context in one pass. This skips the per-value type checks,
+// context switches and object cache lookups of PassValueToOtherContext, which
+// dominate the cost of passing large JSON-like results over the bridge.
+//
+// Whether a value is copied here is decided from the value itself, before any
+// of its properties is read. Other values nested in it, like functions and
+// promises, are handed to PassValueToOtherContext, so every property is read
+// exactly once and an exception thrown by a getter propagates as it is.
+//
+// Arrays and objects are added to the object cache before their contents are
+// copied, so shared references and cycles keep their identity, also with the
+// values PassValueToOtherContext passes.
+class DataOnlyCloner {
+ public:
+  DataOnlyCloner(v8::Local<v8::Context> source_context,
+                 v8::Local<v8::Context> destination_context,
+                 context_bridge::ObjectCache* object_cache,
+                 BridgeErrorTarget error_target)
+      : source_context_(source_context),
+        destination_context_(destination_context),
+        object_cache_(object_cache),
+        error_target_(error_target) {}
+
+  // Returns an empty handle with a pending exception if |value| could not be
+  // passed.
+  v8::MaybeLocal<v8::Value> Clone(v8::Local<v8::Value> value,
+                                  int recursion_depth) {
+    v8::Context::Scope destination_context_scope(destination_context_);
+    return CloneValue(value, recursion_depth);
+  }
+
+  static bool CanClone(v8::Local<v8::Value> value) {
+    return IsPlainArray(value) ||
+           (IsPlainObject(value) && !value->IsFunction() &&
+            value.As<v8::Object>()->InternalFieldCount() == 0);
+  }
+
+ private:
+  v8::MaybeLocal<v8::Value> CloneValue(v8::Local<v8::Value> value,
+                                       int recursion_depth) {
+    if (value->IsString() || value->IsNumber() || value->IsNullOrUndefined() ||
+        value->IsBoolean() || value->IsSymbol() || value->IsBigInt()) {
+      return value;
+    }
+
+    // PassValueToOtherContext throws once the recursion is too deep.
+    if (recursion_depth < kMaxRecursion) {
+      if (value->IsDate()) {
+        return v8::Date::New(destination_context_,
+                             value.As<v8::Date>()->ValueOf());
+      }
+      if (CanClone(value)) {
+        v8::Local<v8::Value> cached_value;
+        if (object_cache_->GetCachedProxiedObject(value).ToLocal(
+                &cached_value))
+          return cached_value;
+        if (value->IsArray())
+          return CloneArray(value.As<v8::Array>(), recursion_depth);
+        return CloneObject(value.As<v8::Object>(), recursion_depth);
+      }
+    }
+
+    return PassValueToOtherContext(source_context_, destination_context_,
+                                   value, object_cache_, false,
+                                   recursion_depth, error_target_);
+  }
+
+  v8::MaybeLocal<v8::Value> CloneArray(v8::Local<v8::Array> arr,
+                                       int recursion_depth) {
+    const uint32_t length = arr->Length();
+    v8::Local<v8::Array> cloned_arr =
+        v8::Array::New(destination_context_->GetIsolate(), length);
+    object_cache_->CacheProxiedObject(arr, cloned_arr);
+    for (uint32_t i = 0; i < length; i++) {
+      v8::Local<v8::Value> element;
+      v8::Local<v8::Value> cloned_element;
+      if (!arr->Get(source_context_, i).ToLocal(&element) ||
+          !CloneValue(element, recursion_depth + 1).ToLocal(&cloned_element) ||
+          !IsTrue(cloned_arr->CreateDataProperty(destination_context_, i,
+                                                 cloned_element)))
+        return v8::MaybeLocal<v8::Value>();
+    }
+    return cloned_arr;
+  }
+
+  v8::MaybeLocal<v8::Value> CloneObject(v8::Local<v8::Object> object,
+                                        int recursion_depth) {
+    v8::Local<v8::Array> keys;
+    if (!object
+             ->GetOwnPropertyNames(
+                 source_context_,
+                 static_cast<v8::PropertyFilter>(v8::ONLY_ENUMERABLE),
+                 v8::KeyConversionMode::kConvertToString)
+             .ToLocal(&keys))
+      return v8::MaybeLocal<v8::Value>();
+    v8::Local<v8::Object> cloned_object =
+        v8::Object::New(destination_context_->GetIsolate());
+    object_cache_->CacheProxiedObject(object, cloned_object);
+    const uint32_t length = keys->Length();
+    for (uint32_t i = 0; i < length; i++) {
+      v8::Local<v8::Value> key;
+      v8::Local<v8::Value> property;
+      v8::Local<v8::Value> cloned_property;
+      if (!keys->Get(source_context_, i).ToLocal(&key) ||
+          !object->Get(source_context_, key).ToLocal(&property) ||
+          !CloneValue(property, recursion_depth + 1)
+               .ToLocal(&cloned_property) ||
+          !IsTrue(cloned_object->CreateDataProperty(
+              destination_context_, key.As<v8::Name>(), cloned_property)))
+        return v8::MaybeLocal<v8::Value>();
+    }
+    return cloned_object;
+  }
+
+  v8::Local<v8::Context> source_context_;
+  v8::Local<v8::Context> destination_context_;
+  context_bridge::ObjectCache* object_cache_;
+  BridgeErrorTarget error_target_;
+};
+
 }  // namespace
 
 v8::MaybeLocal<v8::Value> PassValueToOtherContext(
@@ -170,6 +321,15 @@ v8::MaybeLocal<v8::Value> PassValueToOtherContext(
     return cached_value;
   }
 
+  // Data-only arrays and objects are cloned in bulk. With dynamic properties
+  // every property has to be inspected for accessors, so only the generic
+  // path below applies.
+  if (!support_dynamic_properties && DataOnlyCloner::CanClone(value)) {
+    return DataOnlyCloner(source_context, destination_context, object_cache,
+                          error_target)
+        .Clone(value, recursion_depth);
+  }
+
   // Proxy functions and monitor the lifetime in the new context to release
   // the global handle at the right time.
   if (value->IsFunction()) {
@@ -365,6 +525,38 @@ v8::MaybeLocal<v8::Value> PassValueToOtherContext(
     return v8::MaybeLocal<v8::Value>(passed_value.ToLocalChecked());
   }
 
+  // ArrayBuffers and their views are copied or transferred directly instead of
+  // being serialized, which would copy their contents twice.
+  if (value->IsArrayBuffer()) {
+    v8::Local<v8::Value> passed_buffer = PassArrayBufferToOtherContext(
+        source_context, destination_context, value.As<v8::ArrayBuffer>());
+    object_cache->CacheProxiedObject(value, passed_buffer);
+    return v8::MaybeLocal<v8::Value>(passed_buffer);
+  }
+
+  if (value->IsArrayBufferView() &&
+      !value.As<v8::ArrayBufferView>()->Buffer()->IsSharedArrayBuffer()) {
+    auto view = value.As<v8::ArrayBufferView>();
+    // Read the bounds of the view first, transferring its buffer detaches it.
+    const size_t byte_offset = view->ByteOffset();
+    const size_t byte_length = view->ByteLength();
+    // Views of the same buffer keep sharing it through the object cache.
+    v8::Local<v8::Value> passed_buffer;
+    if (!PassValueToOtherContext(source_context, destination_context,
+                                 view->Buffer(), object_cache,
+                                 support_dynamic_properties,
+                                 recursion_depth + 1, error_target)
+             .ToLocal(&passed_buffer))
+      return v8::MaybeLocal<v8::Value>();
+
+    v8::Context::Scope destination_context_scope(destination_context);
+    v8::Local<v8::Value> passed_view =
+        NewArrayBufferViewLike(view, passed_buffer.As<v8::ArrayBuffer>(),
+                               byte_offset, byte_length);
+    object_cache->CacheProxiedObject(value, passed_view);
+    return v8::MaybeLocal<v8::Value>(passed_view);
+  }
+
   // Serializable objects
   blink::CloneableMessage ret;
   {
@@ -695,6 +887,37 @@ bool OverrideGlobalPropertyFromIsolatedWorld(
   }
 }
 
+void MarkArrayBufferForTransfer(v8::Local<v8::Context> context,
+                                v8::Local<v8::ArrayBuffer> buffer) {
+  SetPrivate(context, buffer, context_bridge::kTransferPrivateKey,
+             v8::True(context->GetIsolate()));
+}
+
+void MarkForTransfer(v8::Isolate* isolate,
+                     v8::Local<v8::Value> value,
+                     gin_helper::Arguments* args) {
+  v8::Local<v8::ArrayBuffer> buffer;
+  if (value->IsArrayBuffer()) {
+    buffer = value.As<v8::ArrayBuffer>();
+  } else if (value->IsArrayBufferView()) {
+    auto view = value.As<v8::ArrayBufferView>();
+    buffer = view->Buffer();
+    // Transferring detaches the whole buffer, which would also take the
+    // memory of any other view over it, like the other Node Buffers that
+    // share a pool with this one.
+    if (view->ByteOffset() != 0 ||
+        view->ByteLength() != buffer->ByteLength()) {
+      args->ThrowError(
+          "Only views covering their whole ArrayBuffer can be transferred");
+      return;
+    }
+  } else {
+    args->ThrowError("Expected an ArrayBuffer or an ArrayBuffer view");
+    return;
+  }
+  MarkArrayBufferForTransfer(isolate->GetCurrentContext(), buffer);
+}
+
 bool IsCalledFromMainWorld(v8::Isolate* isolate) {
   auto* render_frame = GetRenderFrame(isolate->GetCurrentContext()->Global());
   CHECK(render_frame);
@@ -717,6 +940,7 @@ void Initialize(v8::Local<v8::Object> exports,
   v8::Isolate* isolate = context->GetIsolate();
   gin_helper::Dictionary dict(isolate, exports);
   dict.SetMethod("exposeAPIInMainWorld", &electron::api::ExposeAPIInMainWorld);
+  dict.SetMethod("markForTransfer", &electron::api::MarkForTransfer);
   dict.SetMethod("_overrideGlobalValueFromIsolatedWorld",
                  &electron::api::OverrideGlobalValueFromIsolatedWorld);
   dict.SetMethod("_overrideGlobalPropertyFromIsolatedWorld",
@@ -51,6 +51,11 @@ v8::MaybeLocal<v8::Object> CreateProxyForAPI(
     bool support_dynamic_properties,
     int recursion_depth);
 
+// Marks |buffer| to be moved instead of copied the next time it is passed to
+// another context, see contextBridge.markForTransfer().
+void MarkArrayBufferForTransfer(v8::Local<v8::Context> context,
+                                v8::Local<v8::ArrayBuffer> buffer);
+
 }  // namespace api
 
 }  // namespace electron
@@ -0,0 +1,116 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/renderer/api/electron_api_context_bridge.h"
+
+#include <cstring>
+#include <string>
+
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "gin/test/v8_test.h"
+#include "shell/renderer/api/context_bridge/object_cache.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "v8/include/v8.h"
+
+namespace electron {
+
+namespace api {
+
+namespace {
+
+struct Payload {
+  const char* name;
+  size_t size;
+  int iterations;
+};
+
+constexpr Payload kPayloads[] = {
+    {"1KB", 1024, 1000},
+    {"1MB", 1024 * 1024, 256},
+    {"64MB", 64 * 1024 * 1024, 4},
+};
+
+// Passes typed arrays from the context of the test to a second context in the
+// same isolate, the way the context bridge passes them between the isolated
+// world and the main world.
+class ContextBridgePerfTest : public gin::V8Test {
+ protected:
+  void SetUp() override {
+    gin::V8Test::SetUp();
+    v8::HandleScope handle_scope(isolate());
+    destination_context_.Reset(isolate(), v8::Context::New(isolate()));
+  }
+
+  void TearDown() override {
+    destination_context_.Reset();
+    gin::V8Test::TearDown();
+  }
+
+  v8::Isolate* isolate() { return instance_->isolate(); }
+
+  void RunPayloads(const std::string& story, bool transfer) {
+    v8::HandleScope handle_scope(isolate());
+    v8::Local<v8::Context> source_context = context_.Get(isolate());
+    v8::Local<v8::Context> destination_context =
+        destination_context_.Get(isolate());
+    v8::Context::Scope context_scope(source_context);
+
+    perf_test::PerfResultReporter reporter("ContextBridge", story);
+    reporter.RegisterImportantMetric("_throughput", "MB/s");
+    reporter.RegisterImportantMetric("_time_per_crossing", "us");
+    for (const Payload& payload : kPayloads) {
+      base::TimeDelta elapsed;
+      for (int i = 0; i < payload.iterations; ++i) {
+        v8::HandleScope iteration_scope(isolate());
+        // Only the crossing is timed, not filling the buffer.
+        v8::Local<v8::ArrayBuffer> buffer =
+            v8::ArrayBuffer::New(isolate(), payload.size);
+        memset(buffer->GetBackingStore()->Data(), 'x', payload.size);
+        v8::Local<v8::Value> view =
+            v8::Uint8Array::New(buffer, 0, payload.size);
+        if (transfer)
+          MarkArrayBufferForTransfer(source_context, buffer);
+
+        context_bridge::ObjectCache object_cache;
+        base::ElapsedTimer timer;
+        v8::Local<v8::Value> result;
+        ASSERT_TRUE(PassValueToOtherContext(source_context,
+                                            destination_context, view,
+                                            &object_cache, false, 0)
+                        .ToLocal(&result));
+        elapsed += timer.Elapsed();
+        ASSERT_TRUE(result->IsUint8Array());
+        ASSERT_EQ(payload.size, result.As<v8::Uint8Array>()->ByteLength());
+        ASSERT_EQ(transfer ? 0u : payload.size, buffer->ByteLength());
+      }
+      const double megabytes =
+          static_cast<double>(payload.size) * payload.iterations / (1 << 20);
+      reporter.AddResult(base::StringPrintf("_throughput_%s", payload.name),
+                         megabytes / elapsed.InSecondsF());
+      reporter.AddResult(
+          base::StringPrintf("_time_per_crossing_%s", payload.name),
+          elapsed.InMicrosecondsF() / payload.iterations);
+    }
+  }
+
+ private:
+  v8::Global<v8::Context> destination_context_;
+};
+
+}  // namespace
+
+TEST_F(ContextBridgePerfTest, Copy) {
+  RunPayloads("copy", false);
+}
+
+TEST_F(ContextBridgePerfTest, Transfer) {
+  RunPayloads("transfer", true);
+}
+
+}  // namespace api
+
+}  // namespace electron
@@ -97,10 +97,12 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
       return;
     }
     blink::CloneableMessage message;
-    if (!electron::SerializeV8Value(isolate, arguments, &message)) {
+    electron::OutOfBandBuffers buffers;
+    if (!electron::SerializeV8Value(isolate, arguments, &message, &buffers)) {
       return;
     }
-    electron_browser_remote_->Message(internal, channel, std::move(message));
+    electron_browser_remote_->Message(internal, channel, std::move(message),
+                                      std::move(buffers));
   }
 
   v8::Local<v8::Promise> Invoke(v8::Isolate* isolate,
@@ -113,14 +115,15 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
       return v8::Local<v8::Promise>();
     }
     blink::CloneableMessage message;
-    if (!electron::SerializeV8Value(isolate, arguments, &message)) {
+    electron::OutOfBandBuffers buffers;
+    if (!electron::SerializeV8Value(isolate, arguments, &message, &buffers)) {
       return v8::Local<v8::Promise>();
     }
     gin_helper::Promise<blink::CloneableMessage> p(isolate);
     auto handle = p.GetHandle();
 
     electron_browser_remote_->Invoke(
-        internal, channel, std::move(message),
+        internal, channel, std::move(message), std::move(buffers),
         base::BindOnce(
             [](gin_helper::Promise<blink::CloneableMessage> p,
                blink::CloneableMessage result) { p.Resolve(result); },
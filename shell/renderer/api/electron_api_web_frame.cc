@@ -33,6 +33,7 @@
 #include "shell/renderer/api/context_bridge/object_cache.h"
 #include "shell/renderer/api/electron_api_context_bridge.h"
 #include "shell/renderer/api/electron_api_spell_check_client.h"
+#include "shell/renderer/electron_zoom_agent.h"
 #include "shell/renderer/renderer_client_base.h"
 #include "third_party/blink/public/common/browser_interface_broker_proxy.h"
 #include "third_party/blink/public/common/page/page_zoom.h"
@@ -453,6 +454,9 @@ class WebFrameRenderer : public gin::Wrappable<WebFrameRenderer>,
     if (!MaybeGetRenderFrame(isolate, "setZoomLevel", &render_frame))
       return;
 
+    if (auto* zoom_agent = ZoomAgent::Get(render_frame))
+      zoom_agent->set_zoom_level(level);
+
     mojo::Remote<mojom::ElectronBrowser> browser_remote;
     render_frame->GetBrowserInterfaceBroker()->GetInterface(
         browser_remote.BindNewPipeAndPassReceiver());
@@ -465,6 +469,13 @@ class WebFrameRenderer : public gin::Wrappable<WebFrameRenderer>,
     if (!MaybeGetRenderFrame(isolate, "getZoomLevel", &render_frame))
       return result;
 
+    // The browser keeps the zoom level of every frame up to date, only ask it
+    // for the level when it has not been sent yet.
+    if (auto* zoom_agent = ZoomAgent::Get(render_frame)) {
+      if (absl::optional<double> zoom_level = zoom_agent->zoom_level())
+        return *zoom_level;
+    }
+
     mojo::Remote<mojom::ElectronBrowser> browser_remote;
     render_frame->GetBrowserInterfaceBroker()->GetInterface(
         browser_remote.BindNewPipeAndPassReceiver());
@@ -10,6 +10,7 @@
 
 #include "base/environment.h"
 #include "base/ignore_result.h"
+#include "base/memory/shared_memory_mapping.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/trace_event/trace_event.h"
 #include "gin/data_object_builder.h"
@@ -173,6 +174,31 @@ void ElectronApiServiceImpl::Message(bool internal,
   EmitIPCEvent(context, internal, channel, {}, args, sender_id);
 }
 
+void ElectronApiServiceImpl::SharedMessage(
+    bool internal,
+    const std::string& channel,
+    base::ReadOnlySharedMemoryRegion arguments,
+    int32_t sender_id) {
+  blink::WebLocalFrame* frame = render_frame()->GetWebFrame();
+  if (!frame)
+    return;
+
+  base::ReadOnlySharedMemoryMapping mapping = arguments.Map();
+  if (!mapping.IsValid())
+    return;
+
+  v8::Isolate* isolate = blink::MainThreadIsolate();
+  v8::HandleScope handle_scope(isolate);
+
+  v8::Local<v8::Context> context = renderer_client_->GetContext(frame, isolate);
+  v8::Context::Scope context_scope(context);
+
+  v8::Local<v8::Value> args =
+      DeserializeV8Value(isolate, mapping.GetMemoryAsSpan<uint8_t>());
+
+  EmitIPCEvent(context, internal, channel, {}, args, sender_id);
+}
+
 void ElectronApiServiceImpl::ReceivePostMessage(
     const std::string& channel,
     blink::TransferableMessage message) {
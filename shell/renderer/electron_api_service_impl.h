@@ -7,6 +7,7 @@
 
 #include <string>
 
+#include "base/memory/read_only_shared_memory_region.h"
 #include "base/memory/weak_ptr.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_frame_observer.h"
@@ -36,6 +37,10 @@ class ElectronApiServiceImpl : public mojom::ElectronRenderer,
                const std::string& channel,
                blink::CloneableMessage arguments,
                int32_t sender_id) override;
+  void SharedMessage(bool internal,
+                     const std::string& channel,
+                     base::ReadOnlySharedMemoryRegion arguments,
+                     int32_t sender_id) override;
   void ReceivePostMessage(const std::string& channel,
                           blink::TransferableMessage message) override;
   void TakeHeapSnapshot(mojo::ScopedHandle file,
@@ -0,0 +1,95 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/renderer/electron_code_cache_agent.h"
+
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/no_destructor.h"
+#include "content/public/renderer/render_frame.h"
+#include "mojo/public/cpp/base/big_buffer.h"
+#include "shell/common/js2c_code_cache.h"
+#include "third_party/blink/public/common/associated_interfaces/associated_interface_provider.h"
+
+namespace electron {
+
+namespace {
+
+// The bundles whose code cache came from the browser or was sent to it.
+// Only used on the main thread.
+std::set<std::string>& GetSharedBundles() {
+  static base::NoDestructor<std::set<std::string>> shared_bundles;
+  return *shared_bundles;
+}
+
+// Node's builtin loader does not copy the caches it is handed, they are kept
+// mapped for the life of the process.
+std::vector<base::ReadOnlySharedMemoryMapping>& GetCodeCacheMappings() {
+  static base::NoDestructor<std::vector<base::ReadOnlySharedMemoryMapping>>
+      mappings;
+  return *mappings;
+}
+
+}  // namespace
+
+CodeCacheAgent::CodeCacheAgent(content::RenderFrame* frame,
+                               blink::AssociatedInterfaceRegistry* registry)
+    : content::RenderFrameObserver(frame),
+      content::RenderFrameObserverTracker<CodeCacheAgent>(frame) {
+  registry->AddInterface(base::BindRepeating(&CodeCacheAgent::BindReceiver,
+                                             base::Unretained(this)));
+}
+
+CodeCacheAgent::~CodeCacheAgent() = default;
+
+void CodeCacheAgent::BindReceiver(
+    mojo::PendingAssociatedReceiver<mojom::ElectronCodeCacheAgent> receiver) {
+  receiver_.reset();
+  receiver_.Bind(std::move(receiver));
+}
+
+void CodeCacheAgent::SendCodeCaches() {
+  for (const Js2cBundle& bundle : kJs2cBundles) {
+    if (bundle.code_cache != Js2cCodeCacheSource::kRenderer ||
+        GetSharedBundles().count(bundle.id))
+      continue;
+    // The loader only holds a cache for the bundle once it compiled it.
+    absl::optional<std::vector<uint8_t>> data = GetJs2cCodeCache(bundle.id);
+    if (!data)
+      continue;
+    if (!electron_browser_remote_) {
+      render_frame()->GetRemoteAssociatedInterfaces()->GetInterface(
+          &electron_browser_remote_);
+    }
+    electron_browser_remote_->SetJs2cCodeCache(bundle.id,
+                                               mojo_base::BigBuffer(*data));
+    GetSharedBundles().insert(bundle.id);
+  }
+}
+
+void CodeCacheAgent::OnDestruct() {
+  delete this;
+}
+
+void CodeCacheAgent::SetJs2cCodeCaches(
+    base::flat_map<std::string, base::ReadOnlySharedMemoryRegion> caches) {
+  for (auto& cache : caches) {
+    if (GetSharedBundles().count(cache.first))
+      continue;
+    base::ReadOnlySharedMemoryMapping mapping = cache.second.Map();
+    if (!mapping.IsValid())
+      continue;
+    // Ignored when this process compiled the bundle already.
+    if (!AddRendererJs2cCodeCache(cache.first,
+                                  mapping.GetMemoryAsSpan<uint8_t>()))
+      continue;
+    GetCodeCacheMappings().push_back(std::move(mapping));
+    GetSharedBundles().insert(cache.first);
+  }
+}
+
+}  // namespace electron
@@ -0,0 +1,62 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ELECTRON_SHELL_RENDERER_ELECTRON_CODE_CACHE_AGENT_H_
+#define ELECTRON_SHELL_RENDERER_ELECTRON_CODE_CACHE_AGENT_H_
+
+#include <string>
+
+#include "base/containers/flat_map.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "content/public/renderer/render_frame_observer.h"
+#include "content/public/renderer/render_frame_observer_tracker.h"
+#include "mojo/public/cpp/bindings/associated_receiver.h"
+#include "mojo/public/cpp/bindings/associated_remote.h"
+#include "mojo/public/cpp/bindings/pending_associated_receiver.h"
+#include "shell/common/api/api.mojom.h"
+#include "third_party/blink/public/common/associated_interfaces/associated_interface_registry.h"
+
+namespace electron {
+
+// Shares the code caches of the js2c bundles between the renderers of a site.
+// The caches the browser sends are handed to Node's builtin loader before the
+// navigation commits, and the caches this process created for the bundles it
+// compiled without one are sent back to the browser.
+class CodeCacheAgent
+    : public content::RenderFrameObserver,
+      public content::RenderFrameObserverTracker<CodeCacheAgent>,
+      public mojom::ElectronCodeCacheAgent {
+ public:
+  CodeCacheAgent(content::RenderFrame* frame,
+                 blink::AssociatedInterfaceRegistry* registry);
+  ~CodeCacheAgent() override;
+
+  // disable copy
+  CodeCacheAgent(const CodeCacheAgent&) = delete;
+  CodeCacheAgent& operator=(const CodeCacheAgent&) = delete;
+
+  void BindReceiver(
+      mojo::PendingAssociatedReceiver<mojom::ElectronCodeCacheAgent> receiver);
+
+  // Sends the code caches of the bundles this process compiled without a
+  // cache from the browser, once per bundle. Called when a document starts,
+  // after its bundles ran; worker_init goes along with a later document.
+  void SendCodeCaches();
+
+  // content::RenderFrameObserver:
+  void OnDestruct() override;
+
+  // mojom::ElectronCodeCacheAgent:
+  void SetJs2cCodeCaches(
+      base::flat_map<std::string, base::ReadOnlySharedMemoryRegion> caches)
+      override;
+
+ private:
+  mojo::AssociatedReceiver<mojom::ElectronCodeCacheAgent> receiver_{this};
+  mojo::AssociatedRemote<mojom::ElectronBrowser> electron_browser_remote_;
+};
+
+}  // namespace electron
+
+#endif  // ELECTRON_SHELL_RENDERER_ELECTRON_CODE_CACHE_AGENT_H_
@@ -0,0 +1,122 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/renderer/electron_preload_agent.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "content/public/renderer/render_frame.h"
+#include "mojo/public/cpp/base/big_buffer.h"
+#include "shell/common/gin_converters/file_path_converter.h"
+#include "shell/common/gin_converters/value_converter.h"
+#include "shell/common/gin_helper/dictionary.h"
+#include "third_party/blink/public/common/associated_interfaces/associated_interface_provider.h"
+
+namespace electron {
+
+namespace {
+
+v8::Local<v8::Value> ReadSource(
+    v8::Isolate* isolate,
+    const base::ReadOnlySharedMemoryRegion& region) {
+  base::ReadOnlySharedMemoryMapping mapping = region.Map();
+  v8::Local<v8::String> source;
+  if (!mapping.IsValid() ||
+      !v8::String::NewFromUtf8(isolate,
+                               static_cast<const char*>(mapping.memory()),
+                               v8::NewStringType::kNormal, mapping.size())
+           .ToLocal(&source))
+    return v8::Null(isolate);
+  return source;
+}
+
+}  // namespace
+
+PreloadAgent::PreloadAgent(content::RenderFrame* frame,
+                           blink::AssociatedInterfaceRegistry* registry)
+    : content::RenderFrameObserver(frame),
+      content::RenderFrameObserverTracker<PreloadAgent>(frame) {
+  registry->AddInterface(
+      base::BindRepeating(&PreloadAgent::BindReceiver, base::Unretained(this)));
+}
+
+PreloadAgent::~PreloadAgent() = default;
+
+void PreloadAgent::BindReceiver(
+    mojo::PendingAssociatedReceiver<mojom::ElectronPreloadAgent> receiver) {
+  receiver_.reset();
+  receiver_.Bind(std::move(receiver));
+}
+
+v8::Local<v8::Value> PreloadAgent::TakePreloadInfo(v8::Isolate* isolate) {
+  if (!has_preload_info_)
+    return v8::Local<v8::Value>();
+  has_preload_info_ = false;
+
+  std::vector<v8::Local<v8::Value>> preload_scripts;
+  for (const mojom::PreloadScriptPtr& script : scripts_) {
+    gin_helper::Dictionary preload_script =
+        gin::Dictionary::CreateEmpty(isolate);
+    preload_script.Set("preloadPath", script->path);
+    if (script->source)
+      preload_script.Set("preloadSrc", ReadSource(isolate, *script->source));
+    else
+      preload_script.Set("preloadSrc", v8::Null(isolate));
+    if (!script->error.empty()) {
+      preload_script.Set(
+          "preloadError",
+          v8::Exception::Error(gin::StringToV8(isolate, script->error)));
+    } else {
+      preload_script.Set("preloadError", v8::Null(isolate));
+    }
+    preload_scripts.push_back(preload_script.GetHandle());
+  }
+  scripts_.clear();
+
+  gin_helper::Dictionary info = gin::Dictionary::CreateEmpty(isolate);
+  info.Set("preloadScripts", preload_scripts);
+  info.Set("process", process_);
+  process_ = base::Value();
+  return info.GetHandle();
+}
+
+base::ReadOnlySharedMemoryMapping PreloadAgent::TakeCodeCache(
+    const base::FilePath& path) {
+  auto it = code_caches_.find(path);
+  if (it == code_caches_.end())
+    return base::ReadOnlySharedMemoryMapping();
+  base::ReadOnlySharedMemoryMapping mapping = it->second.Map();
+  code_caches_.erase(it);
+  return mapping;
+}
+
+void PreloadAgent::SendCodeCache(const base::FilePath& path,
+                                 base::span<const uint8_t> data) {
+  if (!electron_browser_remote_) {
+    render_frame()->GetRemoteAssociatedInterfaces()->GetInterface(
+        &electron_browser_remote_);
+  }
+  electron_browser_remote_->SetPreloadCodeCache(path,
+                                                mojo_base::BigBuffer(data));
+}
+
+void PreloadAgent::OnDestruct() {
+  delete this;
+}
+
+void PreloadAgent::SetPreloadScripts(
+    std::vector<mojom::PreloadScriptPtr> scripts,
+    base::Value process) {
+  code_caches_.clear();
+  for (const mojom::PreloadScriptPtr& script : scripts) {
+    if (script->code_cache)
+      code_caches_[script->path] = std::move(*script->code_cache);
+  }
+  scripts_ = std::move(scripts);
+  process_ = std::move(process);
+  has_preload_info_ = true;
+}
+
+}  // namespace electron
@@ -0,0 +1,76 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ELECTRON_SHELL_RENDERER_ELECTRON_PRELOAD_AGENT_H_
+#define ELECTRON_SHELL_RENDERER_ELECTRON_PRELOAD_AGENT_H_
+
+#include <map>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/values.h"
+#include "content/public/renderer/render_frame_observer.h"
+#include "content/public/renderer/render_frame_observer_tracker.h"
+#include "mojo/public/cpp/bindings/associated_receiver.h"
+#include "mojo/public/cpp/bindings/associated_remote.h"
+#include "mojo/public/cpp/bindings/pending_associated_receiver.h"
+#include "shell/common/api/api.mojom.h"
+#include "third_party/blink/public/common/associated_interfaces/associated_interface_registry.h"
+#include "v8/include/v8.h"
+
+namespace electron {
+
+// Holds the preload scripts the browser sent for the next document of a
+// sandboxed frame, which the sandboxed preload bundle then runs without
+// asking the browser for them.
+class PreloadAgent : public content::RenderFrameObserver,
+                     public content::RenderFrameObserverTracker<PreloadAgent>,
+                     public mojom::ElectronPreloadAgent {
+ public:
+  PreloadAgent(content::RenderFrame* frame,
+               blink::AssociatedInterfaceRegistry* registry);
+  ~PreloadAgent() override;
+
+  // disable copy
+  PreloadAgent(const PreloadAgent&) = delete;
+  PreloadAgent& operator=(const PreloadAgent&) = delete;
+
+  void BindReceiver(
+      mojo::PendingAssociatedReceiver<mojom::ElectronPreloadAgent> receiver);
+
+  // Returns the preload scripts and the process properties the browser sent,
+  // in the shape lib/sandboxed_renderer/init.ts expects them, and forgets
+  // them. Returns an empty handle when nothing was sent since the last call.
+  v8::Local<v8::Value> TakePreloadInfo(v8::Isolate* isolate);
+
+  // Returns the code cache of the preload script at |path| and forgets it.
+  base::ReadOnlySharedMemoryMapping TakeCodeCache(const base::FilePath& path);
+
+  // Shares the code cache created for the preload script at |path| with the
+  // other renderers of the site.
+  void SendCodeCache(const base::FilePath& path,
+                     base::span<const uint8_t> data);
+
+  // content::RenderFrameObserver:
+  void OnDestruct() override;
+
+  // mojom::ElectronPreloadAgent:
+  void SetPreloadScripts(std::vector<mojom::PreloadScriptPtr> scripts,
+                         base::Value process) override;
+
+ private:
+  std::vector<mojom::PreloadScriptPtr> scripts_;
+  base::Value process_;
+  bool has_preload_info_ = false;
+
+  std::map<base::FilePath, base::ReadOnlySharedMemoryRegion> code_caches_;
+
+  mojo::AssociatedReceiver<mojom::ElectronPreloadAgent> receiver_{this};
+  mojo::AssociatedRemote<mojom::ElectronBrowser> electron_browser_remote_;
+};
+
+}  // namespace electron
+
+#endif  // ELECTRON_SHELL_RENDERER_ELECTRON_PRELOAD_AGENT_H_
@@ -4,12 +4,15 @@
 
 #include "shell/renderer/electron_sandboxed_renderer_client.h"
 
+#include <memory>
 #include <vector>
 
 #include "base/base_paths.h"
 #include "base/command_line.h"
+#include "base/containers/span.h"
 #include "base/files/file_path.h"
 #include "base/ignore_result.h"
+#include "base/memory/read_only_shared_memory_region.h"
 #include "base/path_service.h"
 #include "base/process/process_handle.h"
 #include "base/process/process_metrics.h"
@@ -17,12 +20,14 @@
 #include "electron/buildflags/buildflags.h"
 #include "shell/common/api/electron_bindings.h"
 #include "shell/common/application_info.h"
+#include "shell/common/gin_converters/file_path_converter.h"
 #include "shell/common/gin_helper/dictionary.h"
 #include "shell/common/gin_helper/microtasks_scope.h"
 #include "shell/common/node_bindings.h"
 #include "shell/common/node_includes.h"
 #include "shell/common/node_util.h"
 #include "shell/common/options_switches.h"
+#include "shell/renderer/electron_preload_agent.h"
 #include "shell/renderer/electron_render_frame_observer.h"
 #include "third_party/blink/public/common/web_preferences/web_preferences.h"
 #include "third_party/blink/public/web/blink.h"
@@ -31,6 +36,8 @@
 
 namespace electron {
 
+content::RenderFrame* GetRenderFrame(v8::Local<v8::Object> value);
+
 namespace {
 
 const char kLifecycleKey[] = "lifecycle";
@@ -90,12 +97,44 @@ v8::Local<v8::Value> GetBinding(v8::Isolate* isolate,
 }
 
 v8::Local<v8::Value> CreatePreloadScript(v8::Isolate* isolate,
-                                         v8::Local<v8::String> source) {
+                                         v8::Local<v8::String> source,
+                                         const base::FilePath& path) {
   auto context = isolate->GetCurrentContext();
-  auto maybe_script = v8::Script::Compile(context, source);
+  content::RenderFrame* render_frame = GetRenderFrame(context->Global());
+  PreloadAgent* preload_agent =
+      render_frame ? PreloadAgent::Get(render_frame) : nullptr;
+
+  // The mapping has to outlive the compilation, V8 does not copy the cache.
+  base::ReadOnlySharedMemoryMapping code_cache;
+  if (preload_agent)
+    code_cache = preload_agent->TakeCodeCache(path);
+  v8::ScriptCompiler::CachedData* cached_data = nullptr;
+  if (code_cache.IsValid()) {
+    cached_data = new v8::ScriptCompiler::CachedData(
+        static_cast<const uint8_t*>(code_cache.memory()),
+        static_cast<int>(code_cache.size()));
+  }
+  v8::ScriptCompiler::Source script_source(source, cached_data);
+  auto maybe_script = v8::ScriptCompiler::Compile(
+      context, &script_source,
+      cached_data ? v8::ScriptCompiler::kConsumeCodeCache
+                  : v8::ScriptCompiler::kNoCompileOptions);
   v8::Local<v8::Script> script;
   if (!maybe_script.ToLocal(&script))
     return v8::Local<v8::Value>();
+
+  // The wrapper function is parenthesized, so V8 compiles it eagerly and the
+  // cache holds the bytecode of the whole preload script.
+  if (preload_agent && (!cached_data || cached_data->rejected)) {
+    std::unique_ptr<v8::ScriptCompiler::CachedData> new_cache(
+        v8::ScriptCompiler::CreateCodeCache(script->GetUnboundScript()));
+    if (new_cache) {
+      preload_agent->SendCodeCache(
+          path, base::make_span(new_cache->data,
+                                static_cast<size_t>(new_cache->length)));
+    }
+  }
+
   return script->Run(context).ToLocalChecked();
 }
 
@@ -146,6 +185,12 @@ void ElectronSandboxedRendererClient::InitializeBindings(
   b.SetMethod("get", GetBinding);
   b.SetMethod("createPreloadScript", CreatePreloadScript);
 
+  if (auto* preload_agent = PreloadAgent::Get(render_frame)) {
+    v8::Local<v8::Value> preload_info = preload_agent->TakePreloadInfo(isolate);
+    if (!preload_info.IsEmpty())
+      b.Set("preloadInfo", preload_info);
+  }
+
   gin_helper::Dictionary process = gin::Dictionary::CreateEmpty(isolate);
   b.Set("process", process);
 
@@ -162,6 +207,8 @@ void ElectronSandboxedRendererClient::InitializeBindings(
 void ElectronSandboxedRendererClient::RenderFrameCreated(
     content::RenderFrame* render_frame) {
   new ElectronRenderFrameObserver(render_frame, this);
+  new PreloadAgent(render_frame,
+                   render_frame->GetAssociatedInterfaceRegistry());
   RendererClientBase::RenderFrameCreated(render_frame);
 }
 
@@ -228,14 +275,11 @@ void ElectronSandboxedRendererClient::DidCreateScriptContext(
   auto binding = v8::Object::New(isolate);
   InitializeBindings(binding, context, render_frame);
 
-  std::vector<v8::Local<v8::String>> sandbox_preload_bundle_params = {
-      node::FIXED_ONE_BYTE_STRING(isolate, "binding")};
-
   std::vector<v8::Local<v8::Value>> sandbox_preload_bundle_args = {binding};
 
-  util::CompileAndCall(
-      isolate->GetCurrentContext(), "electron/js2c/sandbox_bundle",
-      &sandbox_preload_bundle_params, &sandbox_preload_bundle_args, nullptr);
+  util::CompileAndCall(isolate->GetCurrentContext(),
+                       "electron/js2c/sandbox_bundle",
+                       &sandbox_preload_bundle_args, nullptr);
 
   v8::HandleScope handle_scope(isolate);
   v8::Context::Scope context_scope(context);
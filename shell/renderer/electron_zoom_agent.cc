@@ -0,0 +1,37 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/renderer/electron_zoom_agent.h"
+
+#include <utility>
+
+#include "base/bind.h"
+
+namespace electron {
+
+ZoomAgent::ZoomAgent(content::RenderFrame* frame,
+                     blink::AssociatedInterfaceRegistry* registry)
+    : content::RenderFrameObserver(frame),
+      content::RenderFrameObserverTracker<ZoomAgent>(frame) {
+  registry->AddInterface(
+      base::BindRepeating(&ZoomAgent::BindReceiver, base::Unretained(this)));
+}
+
+ZoomAgent::~ZoomAgent() = default;
+
+void ZoomAgent::BindReceiver(
+    mojo::PendingAssociatedReceiver<mojom::ElectronZoomAgent> receiver) {
+  receiver_.reset();
+  receiver_.Bind(std::move(receiver));
+}
+
+void ZoomAgent::OnDestruct() {
+  delete this;
+}
+
+void ZoomAgent::UpdateZoomLevel(double zoom_level) {
+  zoom_level_ = zoom_level;
+}
+
+}  // namespace electron
@@ -0,0 +1,56 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ELECTRON_SHELL_RENDERER_ELECTRON_ZOOM_AGENT_H_
+#define ELECTRON_SHELL_RENDERER_ELECTRON_ZOOM_AGENT_H_
+
+#include "content/public/renderer/render_frame_observer.h"
+#include "content/public/renderer/render_frame_observer_tracker.h"
+#include "mojo/public/cpp/bindings/associated_receiver.h"
+#include "mojo/public/cpp/bindings/pending_associated_receiver.h"
+#include "shell/common/api/api.mojom.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+#include "third_party/blink/public/common/associated_interfaces/associated_interface_registry.h"
+
+namespace electron {
+
+// Holds the zoom level of the page as last sent by the browser, which
+// webFrame.getZoomLevel() returns without asking the browser for it.
+class ZoomAgent : public content::RenderFrameObserver,
+                  public content::RenderFrameObserverTracker<ZoomAgent>,
+                  public mojom::ElectronZoomAgent {
+ public:
+  ZoomAgent(content::RenderFrame* frame,
+            blink::AssociatedInterfaceRegistry* registry);
+  ~ZoomAgent() override;
+
+  // disable copy
+  ZoomAgent(const ZoomAgent&) = delete;
+  ZoomAgent& operator=(const ZoomAgent&) = delete;
+
+  void BindReceiver(
+      mojo::PendingAssociatedReceiver<mojom::ElectronZoomAgent> receiver);
+
+  // Empty until the browser has sent the zoom level of the page.
+  absl::optional<double> zoom_level() const { return zoom_level_; }
+
+  // Called when the renderer changes the zoom level itself, so that reading
+  // it back does not return the old level until the browser confirms it.
+  void set_zoom_level(double level) { zoom_level_ = level; }
+
+  // content::RenderFrameObserver:
+  void OnDestruct() override;
+
+  // mojom::ElectronZoomAgent:
+  void UpdateZoomLevel(double zoom_level) override;
+
+ private:
+  absl::optional<double> zoom_level_;
+
+  mojo::AssociatedReceiver<mojom::ElectronZoomAgent> receiver_{this};
+};
+
+}  // namespace electron
+
+#endif  // ELECTRON_SHELL_RENDERER_ELECTRON_ZOOM_AGENT_H_
@@ -35,6 +35,8 @@
 #include "shell/renderer/content_settings_observer.h"
 #include "shell/renderer/electron_api_service_impl.h"
 #include "shell/renderer/electron_autofill_agent.h"
+#include "shell/renderer/electron_code_cache_agent.h"
+#include "shell/renderer/electron_zoom_agent.h"
 #include "third_party/blink/public/common/associated_interfaces/associated_interface_registry.h"
 #include "third_party/blink/public/common/web_preferences/web_preferences.h"
 #include "third_party/blink/public/platform/media/multi_buffer_data_source.h"
@@ -262,6 +264,9 @@ void RendererClientBase::RenderFrameCreated(
   new PepperHelper(render_frame);
 #endif
   new ContentSettingsObserver(render_frame);
+  new ZoomAgent(render_frame, render_frame->GetAssociatedInterfaceRegistry());
+  new CodeCacheAgent(render_frame,
+                     render_frame->GetAssociatedInterfaceRegistry());
 #if BUILDFLAG(ENABLE_PRINTING)
   new printing::PrintRenderFrameHelper(
       render_frame,
@@ -390,6 +395,9 @@ RendererClientBase::CreatePrescientNetworking(
 
 void RendererClientBase::RunScriptsAtDocumentStart(
     content::RenderFrame* render_frame) {
+  // The bundles of the document ran by now.
+  if (auto* code_cache_agent = CodeCacheAgent::Get(render_frame))
+    code_cache_agent->SendCodeCaches();
 #if BUILDFLAG(ENABLE_ELECTRON_EXTENSIONS)
   extensions_renderer_client_.get()->RunScriptsAtDocumentStart(render_frame);
 #endif
@@ -538,14 +546,11 @@ void RendererClientBase::SetupMainWorldOverrides(
     }
   }
 
-  std::vector<v8::Local<v8::String>> isolated_bundle_params = {
-      node::FIXED_ONE_BYTE_STRING(isolate, "isolatedApi")};
-
   std::vector<v8::Local<v8::Value>> isolated_bundle_args = {
       isolated_api.GetHandle()};
 
   util::CompileAndCall(context, "electron/js2c/isolated_bundle",
-                       &isolated_bundle_params, &isolated_bundle_args, nullptr);
+                       &isolated_bundle_args, nullptr);
 }
 
 // static
@@ -0,0 +1,163 @@
+// Copyright (c) 2022 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+// Compiles the js2c bundles like the runtime does and writes their V8 code
+// caches into a source file that is linked into electron_lib.
+//
+// Usage: electron_js2c_code_cache_generator <output.cc>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/feature_list.h"
+#include "base/files/file_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "gin/public/isolate_holder.h"
+#include "shell/common/js2c_code_cache.h"
+#include "shell/common/node_includes.h"
+#include "v8/include/v8.h"
+
+namespace {
+
+constexpr char kHeader[] =
+    "// Generated by shell/tools/js2c_code_cache_generator.cc, do not edit.\n"
+    "\n"
+    "#include \"shell/common/js2c_code_cache.h\"\n"
+    "\n"
+    "namespace electron {\n"
+    "\n"
+    "namespace {\n"
+    "\n";
+
+bool GenerateCodeCaches(v8::Isolate* isolate, std::string* out) {
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Context> context = v8::Context::New(isolate);
+  v8::Context::Scope context_scope(context);
+
+  std::string entries;
+  size_t index = 0;
+  for (const electron::Js2cBundle& bundle : electron::kJs2cBundles) {
+    if (bundle.code_cache != electron::Js2cCodeCacheSource::kBuild)
+      continue;
+
+    std::vector<v8::Local<v8::String>> parameters;
+    for (const char* name : bundle.parameters) {
+      parameters.push_back(
+          v8::String::NewFromUtf8(isolate, name,
+                                  v8::NewStringType::kInternalized)
+              .ToLocalChecked());
+    }
+
+    v8::TryCatch try_catch(isolate);
+    v8::Local<v8::Function> fn;
+    if (!node::native_module::NativeModuleEnv::LookupAndCompile(
+             context, bundle.id, &parameters, nullptr)
+             .ToLocal(&fn)) {
+      fprintf(stderr, "Failed to compile %s\n", bundle.id);
+      return false;
+    }
+
+    std::unique_ptr<v8::ScriptCompiler::CachedData> cache(
+        v8::ScriptCompiler::CreateCodeCacheForFunction(fn));
+    if (!cache) {
+      fprintf(stderr, "Failed to create the code cache of %s\n", bundle.id);
+      return false;
+    }
+
+    base::StringAppendF(out, "const uint8_t kCodeCache%zu[] = {", index);
+    for (int i = 0; i < cache->length; ++i) {
+      if (i % 16 == 0)
+        out->append("\n   ");
+      out->append(" ");
+      out->append(base::NumberToString(cache->data[i]));
+      out->append(",");
+    }
+    out->append("\n};\n\n");
+    base::StringAppendF(&entries, "    {\"%s\", kCodeCache%zu, %d},\n",
+                        bundle.id, index, cache->length);
+    ++index;
+  }
+
+  out->append("const Js2cCodeCache kCodeCaches[] = {\n");
+  out->append(entries);
+  out->append(
+      "};\n"
+      "\n"
+      "}  // namespace\n"
+      "\n"
+      "base::span<const Js2cCodeCache> GetJs2cCodeCaches() {\n"
+      "  return kCodeCaches;\n"
+      "}\n"
+      "\n"
+      "}  // namespace electron\n");
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc != 2) {
+    fprintf(stderr, "Usage: %s <output.cc>\n", argv[0]);
+    return 1;
+  }
+
+  // Parse the same node options as NodeBindings::Initialize so that the
+  // flags of the browser process match the ones the caches are created with.
+  std::vector<std::string> node_argv = {"electron"};
+  std::vector<std::string> exec_argv;
+  std::vector<std::string> errors;
+  if (node::InitializeNodeWithArgs(&node_argv, &exec_argv, &errors) != 0) {
+    for (const std::string& error : errors)
+      fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+
+  v8::V8::InitializeICUDefaultLocation(argv[0]);
+  v8::V8::InitializeExternalStartupData(argv[0]);
+  std::unique_ptr<node::MultiIsolatePlatform> platform =
+      node::MultiIsolatePlatform::Create(1);
+  v8::V8::InitializePlatform(platform.get());
+
+  // Initialize V8 through gin like JavascriptEnvironment::Initialize does,
+  // which sets the flags of the browser process from the default state of
+  // the features. V8 rejects a cache created with any other flags.
+  base::FeatureList::InitializeInstance(std::string(), std::string());
+  std::unique_ptr<v8::ArrayBuffer::Allocator> allocator(
+      v8::ArrayBuffer::Allocator::NewDefaultAllocator());
+  gin::IsolateHolder::Initialize(gin::IsolateHolder::kNonStrictMode,
+                                 allocator.get(),
+                                 nullptr /* external_reference_table */,
+                                 std::string() /* js_command_line_flags */,
+                                 false /* create_v8_platform */);
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = allocator.get();
+  v8::Isolate* isolate = v8::Isolate::Allocate();
+  platform->RegisterIsolate(isolate, uv_default_loop());
+  v8::Isolate::Initialize(isolate, create_params);
+
+  std::string out = kHeader;
+  bool succeeded;
+  {
+    v8::Isolate::Scope isolate_scope(isolate);
+    succeeded = GenerateCodeCaches(isolate, &out);
+  }
+
+  platform->UnregisterIsolate(isolate);
+  isolate->Dispose();
+  v8::V8::Dispose();
+  v8::V8::ShutdownPlatform();
+
+  if (!succeeded)
+    return 1;
+
+  if (!base::WriteFile(base::FilePath::FromUTF8Unsafe(argv[1]), out)) {
+    fprintf(stderr, "Failed to write %s\n", argv[1]);
+    return 1;
+  }
+  return 0;
+}
@@ -1394,6 +1394,25 @@ describe('app module', () => {
     });
   });
 
+  describe('warmModuleCodeCache() API', () => {
+    it('compiles modules from files and asar archives', async () => {
+      await app.warmModuleCodeCache([
+        path.join(fixturesPath, 'module', 'noop.js'),
+        path.join(fixturesPath, 'test.asar', 'a.asar', 'file1')
+      ]);
+    });
+
+    it('rejects when a module cannot be found', async () => {
+      await expect(app.warmModuleCodeCache([path.join(fixturesPath, 'module', 'does-not-exist.js')])).to.eventually.be.rejected;
+    });
+  });
+
+  describe('pruneModuleCodeCache() API', () => {
+    it('resolves once the cache is written', async () => {
+      await app.pruneModuleCodeCache();
+    });
+  });
+
   describe('getGPUFeatureStatus() API', () => {
     it('returns the graphic features statuses', () => {
       const features = app.getGPUFeatureStatus();
@@ -1823,6 +1842,92 @@ describe('app module', () => {
   });
 });
 
+describe('startup snapshot', () => {
+  const snapshotPath = path.join(fixturesPath, 'api', 'startup-snapshot');
+  const blobPath = path.join(app.getPath('temp'), `electron-app-snapshot-${process.pid}.bin`);
+
+  const runElectron = async (args: string[]) => {
+    const appProcess = cp.spawn(process.execPath, args);
+    let output = '';
+    appProcess.stdout.on('data', data => { output += data; });
+    appProcess.stderr.on('data', data => { output += data; });
+    const [code] = await emittedOnce(appProcess, 'exit');
+    return { code, output };
+  };
+
+  afterEach(() => {
+    fs.rmSync(blobPath, { force: true });
+  });
+
+  it('starts the main process from the snapshot an entry script built', async () => {
+    const build = await runElectron(['--build-snapshot', path.join(snapshotPath, 'entry.js'), `--snapshot-blob=${blobPath}`]);
+    expect(build.code).to.equal(0, build.output);
+    expect(fs.existsSync(blobPath)).to.be.true();
+
+    const { code, output } = await runElectron([snapshotPath, `--snapshot-blob=${blobPath}`]);
+    expect(code).to.equal(0, output);
+    expect(JSON.parse(output.trim().split('\n').pop()!)).to.deep.equal({
+      primes: [2, 3, 5, 7, 11, 13],
+      greeting: 'Hello, snapshot'
+    });
+  });
+
+  it('starts without a snapshot when there is none', async () => {
+    const { code, output } = await runElectron([snapshotPath, `--snapshot-blob=${blobPath}`]);
+    expect(code).to.equal(0, output);
+    expect(JSON.parse(output.trim().split('\n').pop()!)).to.deep.equal({
+      primes: null,
+      greeting: null
+    });
+  });
+
+  it('ignores a snapshot built by another version of Electron', async () => {
+    const build = await runElectron(['--build-snapshot', path.join(snapshotPath, 'entry.js'), `--snapshot-blob=${blobPath}`]);
+    expect(build.code).to.equal(0, build.output);
+
+    // The Electron version follows the 4-byte Pickle header, the format
+    // version and the length of the string.
+    const blob = fs.readFileSync(blobPath);
+    const version = process.versions.electron;
+    expect(blob.toString('latin1', 12, 12 + version.length)).to.equal(version);
+    blob[12] = blob[12] === 0x30 ? 0x31 : 0x30;
+    fs.writeFileSync(blobPath, blob);
+
+    const { code, output } = await runElectron([snapshotPath, `--snapshot-blob=${blobPath}`]);
+    expect(code).to.equal(0, output);
+    expect(output).to.include('Ignoring the startup snapshot');
+    expect(JSON.parse(output.trim().split('\n').pop()!)).to.deep.equal({
+      primes: null,
+      greeting: null
+    });
+  });
+
+  it('ignores a corrupt snapshot', async () => {
+    const build = await runElectron(['--build-snapshot', path.join(snapshotPath, 'entry.js'), `--snapshot-blob=${blobPath}`]);
+    expect(build.code).to.equal(0, build.output);
+
+    // The middle of the file is part of the V8 blob.
+    const blob = fs.readFileSync(blobPath);
+    blob[Math.floor(blob.length / 2)] ^= 0xff;
+    fs.writeFileSync(blobPath, blob);
+
+    const { code, output } = await runElectron([snapshotPath, `--snapshot-blob=${blobPath}`]);
+    expect(code).to.equal(0, output);
+    expect(output).to.include('Ignoring the startup snapshot');
+    expect(JSON.parse(output.trim().split('\n').pop()!)).to.deep.equal({
+      primes: null,
+      greeting: null
+    });
+  });
+
+  it('fails when the entry script throws', async () => {
+    const { code, output } = await runElectron(['--build-snapshot', path.join(snapshotPath, 'throws.js'), `--snapshot-blob=${blobPath}`]);
+    expect(code).to.equal(1);
+    expect(output).to.include('snapshot entry failed');
+    expect(fs.existsSync(blobPath)).to.be.false();
+  });
+});
+
 describe('default behavior', () => {
   describe('application menu', () => {
     it('creates the default menu if the app does not set it', async () => {
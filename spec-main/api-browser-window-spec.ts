@@ -2387,6 +2387,58 @@ describe('BrowserWindow module', () => {
         expect(test).to.equal('preload');
       });
 
+      it('runs the same preload script in many windows', async () => {
+        const windows = Array.from({ length: 4 }, () => new BrowserWindow({
+          show: false,
+          webPreferences: {
+            sandbox: true,
+            preload,
+            contextIsolation: false
+          }
+        }));
+        const answers = emittedNTimes(ipcMain, 'answer', windows.length * 2);
+        for (const w of windows) {
+          w.loadFile(path.join(fixtures, 'api', 'preload.html'));
+        }
+        // The second navigation of every window gets the cached script.
+        await emittedNTimes(ipcMain, 'answer', windows.length);
+        for (const w of windows) {
+          w.webContents.reload();
+        }
+        for (const [, test] of await answers) {
+          expect(test).to.equal('preload');
+        }
+      });
+
+      it('picks up changes to the preload script', async () => {
+        const tmpDir = await fs.promises.mkdtemp(path.join(os.tmpdir(), 'electron-preload-'));
+        defer(() => fs.promises.rm(tmpDir, { recursive: true, force: true }));
+        const changingPreload = path.join(tmpDir, 'preload.js');
+        const writePreload = (value: string) => fs.promises.writeFile(changingPreload,
+          `require('electron').ipcRenderer.send('preload-value', '${value}')`);
+        await writePreload('before');
+        const w = new BrowserWindow({
+          show: false,
+          webPreferences: {
+            sandbox: true,
+            preload: changingPreload
+          }
+        });
+        w.loadURL('about:blank');
+        const [, before] = await emittedOnce(ipcMain, 'preload-value');
+        expect(before).to.equal('before');
+
+        await writePreload('after');
+        // The cache notices the change asynchronously.
+        let value = before;
+        while (value !== 'after') {
+          const changed = emittedOnce(ipcMain, 'preload-value');
+          w.webContents.reload();
+          [, value] = await changed;
+          await delay(50);
+        }
+      });
+
       it('exposes "loaded" event to preload script', async () => {
         const w = new BrowserWindow({
           show: false,
@@ -3413,6 +3465,30 @@ describe('BrowserWindow module', () => {
     });
   });
 
+  describe('beginEncodedFrameSubscription method', () => {
+    afterEach(closeAllWindows);
+
+    it('delivers encoded vp8 frames starting with a key frame', async () => {
+      const w = new BrowserWindow({ show: false });
+      await w.loadFile(path.join(fixtures, 'api', 'frame-subscriber.html'));
+      const chunk = await new Promise<any>((resolve) => {
+        w.webContents.beginEncodedFrameSubscription({ codec: 'vp8' }, resolve);
+      });
+      w.webContents.endFrameSubscription();
+      expect(chunk.data).to.be.an.instanceOf(Buffer);
+      expect(chunk.data.length).to.be.greaterThan(0);
+      expect(chunk.keyFrame).to.be.true('keyFrame');
+      expect(chunk.timestamp).to.be.a('number');
+    });
+
+    it('throws for unknown codecs', () => {
+      const w = new BrowserWindow({ show: false });
+      expect(() => {
+        w.webContents.beginEncodedFrameSubscription({ codec: 'gif' as any }, () => {});
+      }).to.throw(/'codec' must be one of/);
+    });
+  });
+
   describe('savePage method', () => {
     const savePageDir = path.join(fixtures, 'save_page');
     const savePageHtmlPath = path.join(savePageDir, 'save_page.html');
@@ -4776,6 +4852,68 @@ describe('BrowserWindow module', () => {
       });
     });
 
+    describe('paint mode APIs', () => {
+      it('defaults to the image mode', () => {
+        expect(w.webContents.getPaintMode()).to.equal('image');
+      });
+
+      it('emits only the changed pixels in the damage mode', async () => {
+        w.webContents.setPaintMode('damage');
+        expect(w.webContents.getPaintMode()).to.equal('damage');
+        const paint = emittedOnce(w.webContents, 'paint-damage');
+        w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'));
+        const [, dirtyRect, buffer, size] = await paint;
+        expect(buffer).to.be.an.instanceOf(Buffer);
+        expect(buffer.length).to.equal(dirtyRect.width * dirtyRect.height * 4);
+        expect(dirtyRect.x + dirtyRect.width).to.be.at.most(size.width);
+        expect(dirtyRect.y + dirtyRect.height).to.be.at.most(size.height);
+      });
+
+      it('rejects unknown modes', () => {
+        expect(() => w.webContents.setPaintMode('video' as any)).to.throw();
+      });
+    });
+
+    describe('frame credit APIs', () => {
+      it('holds frames until they are acknowledged', async () => {
+        w.webContents.setFrameCredits(1);
+        expect(w.webContents.getFrameCredits()).to.equal(1);
+        w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'));
+        await emittedOnce(w.webContents, 'paint');
+        w.webContents.invalidate();
+        w.webContents.invalidate();
+        expect(w.webContents.getFrameStats().framesInFlight).to.equal(1);
+
+        const paint = emittedOnce(w.webContents, 'paint');
+        w.webContents.acknowledgeFrame();
+        await paint;
+        const stats = w.webContents.getFrameStats();
+        expect(stats.deliveredFrames).to.be.at.least(2);
+        expect(stats.capturedFrames).to.equal(stats.deliveredFrames + stats.droppedFrames);
+        expect(stats.averageLatency).to.be.at.least(0);
+      });
+
+      it('does not capture frames while no credits are left', async () => {
+        w.webContents.setFrameCredits(1);
+        // The page keeps changing, so frames would be captured continuously.
+        w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'));
+        await emittedOnce(w.webContents, 'paint');
+        // Let frames that were captured before the credit was used arrive.
+        await delay(100);
+        const before = w.webContents.getFrameStats();
+        w.webContents.invalidate();
+        await delay(500);
+        const after = w.webContents.getFrameStats();
+        expect(after.capturedFrames).to.equal(before.capturedFrames);
+        expect(after.deliveredFrames).to.equal(before.deliveredFrames);
+
+        const paint = emittedOnce(w.webContents, 'paint');
+        w.webContents.acknowledgeFrame();
+        await paint;
+        expect(w.webContents.getFrameStats().deliveredFrames).to.equal(before.deliveredFrames + 1);
+      });
+    });
+
     describe('frameRate APIs', () => {
       it('has default frame rate (function)', async () => {
         w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'));
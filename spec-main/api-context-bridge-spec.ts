@@ -517,6 +517,157 @@ describe('contextBridge', () => {
         expect(result).equal(true);
       });
 
+      it('should copy array buffers and views without sharing memory', async () => {
+        await makeBindingWindow(() => {
+          const buffer = new ArrayBuffer(16);
+          new Uint8Array(buffer).set([1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16]);
+          const example = {
+            buffer,
+            bytes: new Uint8Array(buffer, 4, 8),
+            words: new Uint32Array(buffer, 8, 2),
+            view: new DataView(buffer, 2, 4),
+            mutate: () => { new Uint8Array(buffer)[0] = 100; }
+          };
+          contextBridge.exposeInMainWorld('example', example);
+        });
+        const result = await callWithBindings((root: any) => {
+          const { buffer, bytes, words, view } = root.example;
+          root.example.mutate();
+          return [
+            Object.getPrototypeOf(buffer) === ArrayBuffer.prototype,
+            Object.getPrototypeOf(words) === Uint32Array.prototype,
+            Object.getPrototypeOf(view) === DataView.prototype,
+            [...bytes], bytes.byteOffset, words.length, view.getUint8(0),
+            bytes.buffer === buffer && words.buffer === buffer,
+            new Uint8Array(buffer)[0]
+          ];
+        });
+        expect(result).to.deep.equal([true, true, true, [5, 6, 7, 8, 9, 10, 11, 12], 4, 2, 3, true, 1]);
+      });
+
+      it('should move array buffers marked for transfer', async () => {
+        await makeBindingWindow(() => {
+          let bytes: Uint8Array;
+          contextBridge.exposeInMainWorld('example', {
+            get: () => {
+              bytes = new Uint8Array(1024 * 1024).fill(7);
+              return contextBridge.markForTransfer(bytes);
+            },
+            sourceLength: () => bytes.byteLength,
+            markInvalid: () => {
+              try {
+                contextBridge.markForTransfer({} as any);
+              } catch {
+                return true;
+              }
+              return false;
+            },
+            markPartial: () => {
+              // Like a Node Buffer allocated from the shared pool.
+              const pool = new ArrayBuffer(64);
+              const partial = new Uint8Array(pool, 8, 16);
+              try {
+                contextBridge.markForTransfer(partial);
+              } catch {
+                return pool.byteLength;
+              }
+              return -1;
+            }
+          });
+        });
+        const result = await callWithBindings((root: any) => {
+          const bytes = root.example.get();
+          return [bytes.byteLength, bytes[1000], root.example.sourceLength(), root.example.markInvalid(), root.example.markPartial()];
+        });
+        expect(result).to.deep.equal([1024 * 1024, 7, 0, true, 64]);
+      });
+
+      it('should clone large data-only results', async () => {
+        await makeBindingWindow(() => {
+          contextBridge.exposeInMainWorld('example', {
+            query: () => Array.from({ length: 10000 }, (_, i) => ({
+              id: i,
+              name: `row ${i}`,
+              created: new Date(i),
+              tags: ['a', 'b'],
+              nested: { ok: i % 2 === 0, missing: null }
+            }))
+          });
+        });
+        const result = await callWithBindings((root: any) => {
+          const rows = root.example.query();
+          const last = rows[rows.length - 1];
+          return [
+            rows.length,
+            Array.isArray(rows) && Object.getPrototypeOf(last) === Object.prototype,
+            last.name, last.created instanceof Date && last.created.getTime(),
+            Array.isArray(last.tags), last.nested
+          ];
+        });
+        expect(result).to.deep.equal([10000, true, 'row 9999', 9999, true, { ok: false, missing: null }]);
+      });
+
+      it('should keep shared and cyclic references in data-only results', async () => {
+        await makeBindingWindow(() => {
+          const shared = { value: 1 };
+          const cyclic: any = { shared, list: [shared, shared] };
+          cyclic.self = cyclic;
+          contextBridge.exposeInMainWorld('example', { get: () => cyclic });
+        });
+        const result = await callWithBindings((root: any) => {
+          const value = root.example.get();
+          return [value.self === value, value.shared === value.list[0], value.list[0] === value.list[1]];
+        });
+        expect(result).to.deep.equal([true, true, true]);
+      });
+
+      it('should read getters of data-only results once and rethrow their errors', async () => {
+        await makeBindingWindow(() => {
+          let reads = 0;
+          contextBridge.exposeInMainWorld('example', {
+            get: () => ({
+              list: [1, { get counted () { reads++; return reads; } }],
+              fn: () => 1
+            }),
+            reads: () => reads,
+            getThrowing: () => ({
+              a: { get boom () { throw new Error('getter failed'); } },
+              fn: () => 1
+            })
+          });
+        });
+        const result = await callWithBindings((root: any) => {
+          const value = root.example.get();
+          let error;
+          try {
+            root.example.getThrowing();
+          } catch (err) {
+            error = (err as Error).message;
+          }
+          return [value.list[1].counted, root.example.reads(), typeof value.fn, error];
+        });
+        expect(result).to.deep.equal([1, 1, 'function', 'getter failed']);
+      });
+
+      it('should keep shared references between data and non-data values', async () => {
+        await makeBindingWindow(() => {
+          const shared = { value: 1 };
+          contextBridge.exposeInMainWorld('example', {
+            get: () => ({ fn: () => 1, a: { x: shared }, b: shared, list: [shared, { y: shared }] }),
+            getReversed: () => ({ b: shared, a: { x: shared, fn: () => 1 } })
+          });
+        });
+        const result = await callWithBindings((root: any) => {
+          const value = root.example.get();
+          const reversed = root.example.getReversed();
+          return [
+            value.a.x === value.b, value.list[0] === value.b, value.list[1].y === value.b,
+            typeof value.fn, reversed.a.x === reversed.b, typeof reversed.a.fn
+          ];
+        });
+        expect(result).to.deep.equal([true, true, true, 'function', true, 'function']);
+      });
+
       it('should proxy regexps', async () => {
         await makeBindingWindow(() => {
           contextBridge.exposeInMainWorld('example', /a/g);
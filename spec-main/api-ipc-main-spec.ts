@@ -48,6 +48,77 @@ describe('ipc main module', () => {
     });
   });
 
+  describe('ipcMain.setChannelMode', () => {
+    afterEach(() => {
+      ipcMain.setChannelMode('burst', 'default');
+      ipcMain.removeAllListeners('burst');
+    });
+
+    async function sendBurst () {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+      await w.loadURL('about:blank');
+      w.webContents.executeJavaScript(`{
+        const { ipcRenderer } = require('electron')
+        for (let i = 1; i <= 100; i++) ipcRenderer.send('burst', i, 'x')
+      }`);
+      return w;
+    }
+
+    // Keeps the main process busy, so that the messages sent in the meantime
+    // are received together.
+    function block (ms: number) {
+      const end = Date.now() + ms;
+      while (Date.now() < end);
+    }
+
+    it('emits the messages received together as one array in batch mode', async () => {
+      ipcMain.setChannelMode('burst', 'batch');
+      const received: number[] = [];
+      const batchSizes: number[] = [];
+      const done = new Promise<void>(resolve => {
+        ipcMain.on('burst', (event, messages) => {
+          expect(event.senderFrame).to.be.an('object');
+          expect(messages).to.be.an('array');
+          batchSizes.push(messages.length);
+          for (const [i, x] of messages) {
+            expect(x).to.equal('x');
+            received.push(i);
+          }
+          if (received.length === 100) resolve();
+          else if (batchSizes.length === 1) block(500);
+        });
+      });
+      await sendBurst();
+      await done;
+      expect(received).to.deep.equal(Array.from({ length: 100 }, (_, i) => i + 1));
+      expect(batchSizes.length).to.be.below(100);
+      expect(Math.max(...batchSizes)).to.be.above(1);
+    });
+
+    it('emits only the last of the messages received together in latest mode', async () => {
+      ipcMain.setChannelMode('burst', 'latest');
+      const received: number[] = [];
+      const done = new Promise<void>(resolve => {
+        ipcMain.on('burst', (event, i, x) => {
+          expect(x).to.equal('x');
+          received.push(i);
+          if (i === 100) resolve();
+          else if (received.length === 1) block(500);
+        });
+      });
+      await sendBurst();
+      await done;
+      expect(received).to.deep.equal([...received].sort((a, b) => a - b));
+      // The values received together with a later one were dropped.
+      expect(received.length).to.be.below(100);
+      expect(received[received.length - 1]).to.equal(100);
+    });
+
+    it('throws for an unknown mode', () => {
+      expect(() => ipcMain.setChannelMode('burst', 'bogus' as any)).to.throw(/Invalid channel mode/);
+    });
+  });
+
   describe('ipcMain.on', () => {
     it('is not used for internals', async () => {
       const appPath = path.join(fixtures, 'api', 'ipc-main-listeners');
@@ -52,6 +52,29 @@ describe('ipcRenderer module', () => {
       expect(Buffer.from(data).equals(received)).to.be.true();
     });
 
+    it('can send large binary payloads', async () => {
+      w.webContents.executeJavaScript(`{
+        const { ipcRenderer } = require('electron')
+        const bytes = new Uint8Array(4 * 1024 * 1024)
+        for (let i = 0; i < bytes.length; i++) bytes[i] = i % 251
+        const floats = new Float64Array(16 * 1024).fill(0.5)
+        ipcRenderer.send('message', bytes, bytes.buffer.slice(0, 128 * 1024), floats, { nested: Buffer.alloc(64 * 1024, 1) })
+      }`);
+      const [, bytes, buffer, floats, { nested }] = await emittedOnce(ipcMain, 'message');
+      expect(bytes).to.be.an.instanceOf(Uint8Array);
+      expect(bytes.length).to.equal(4 * 1024 * 1024);
+      expect(bytes[1000]).to.equal(1000 % 251);
+      expect(bytes[bytes.length - 1]).to.equal((bytes.length - 1) % 251);
+      expect(buffer).to.be.an.instanceOf(ArrayBuffer);
+      expect(buffer.byteLength).to.equal(128 * 1024);
+      expect(new Uint8Array(buffer)[300]).to.equal(300 % 251);
+      expect(floats).to.be.an.instanceOf(Float64Array);
+      expect(floats.length).to.equal(16 * 1024);
+      expect(floats[100]).to.equal(0.5);
+      expect(nested.length).to.equal(64 * 1024);
+      expect(nested.every((b: number) => b === 1)).to.be.true();
+    });
+
     it('throws when sending objects with DOM class prototypes', async () => {
       await expect(w.webContents.executeJavaScript(`{
         const { ipcRenderer } = require('electron')
@@ -55,6 +55,19 @@ describe('ipc module', () => {
       await done;
     });
 
+    it('receives large binary arguments', async () => {
+      ipcMain.handleOnce('test', (e: IpcMainInvokeEvent, bytes: Uint8Array) => {
+        expect(bytes).to.be.an.instanceOf(Uint8Array);
+        return bytes.reduce((sum, b) => sum + b, 0);
+      });
+      const done = new Promise<void>(resolve => ipcMain.once('result', (e, arg) => {
+        expect(arg).to.deep.equal({ result: 1024 * 1024 });
+        resolve();
+      }));
+      await w.webContents.executeJavaScript(`(${rendererInvoke})(new Uint8Array(1024 * 1024).fill(1))`);
+      await done;
+    });
+
     it('receives an error from a synchronous handler', async () => {
       ipcMain.handleOnce('test', () => {
         throw new Error('some error');
@@ -208,6 +208,88 @@ describe('protocol module', () => {
       registerBufferProtocol(protocolName, (request, callback) => callback(text as any));
       await expect(ajax(protocolName + '://fake-host')).to.be.eventually.rejected();
     });
+
+    it('sends a slice of the Buffer for Range requests', async () => {
+      registerBufferProtocol(protocolName, (request, callback) => callback(buffer));
+      const r = await ajax(protocolName + '://fake-host', { headers: { Range: 'bytes=6-10' } });
+      expect(r.status).to.equal(206);
+      expect(r.data).to.equal(text.slice(6, 11));
+      expect(r.headers).to.have.property('content-range', `bytes 6-10/${buffer.length}`);
+    });
+
+    it('fails for unsatisfiable Range requests', async () => {
+      registerBufferProtocol(protocolName, (request, callback) => callback(buffer));
+      await expect(ajax(protocolName + '://fake-host', { headers: { Range: `bytes=${buffer.length}-` } })).to.be.eventually.rejected();
+    });
+  });
+
+  describe('protocol.registerStaticProtocol', () => {
+    const normalPath = path.join(fixturesPath, 'pages', 'a.html');
+    const normalContent = fs.readFileSync(normalPath);
+    const asarContent = fs.readFileSync(path.join(fixturesPath, 'test.asar', 'a.asar', 'file1'));
+
+    it('sends responses from the table', async () => {
+      protocol.registerStaticProtocol(protocolName, {
+        responses: { '/a': { data: text, headers: { 'x-great-header': 'yes' } } }
+      });
+      const r = await ajax(protocolName + ':/a');
+      expect(r.data).to.equal(text);
+      expect(r.headers).to.have.property('x-great-header', 'yes');
+    });
+
+    it('sends files from the directory', async () => {
+      protocol.registerStaticProtocol(protocolName, { directory: fixturesPath, headers: { 'x-static': '1' } });
+      const r = await ajax(protocolName + ':/pages/a.html');
+      expect(r.data).to.equal(String(normalContent));
+      expect(r.headers).to.have.property('x-static', '1');
+      const r2 = await ajax(protocolName + ':/pages/a.html');
+      expect(r2.data).to.equal(String(normalContent));
+    });
+
+    it('sends files from an asar archive', async () => {
+      protocol.registerStaticProtocol(protocolName, { directory: path.join(fixturesPath, 'test.asar', 'a.asar') });
+      const r = await ajax(protocolName + ':/file1');
+      expect(r.data).to.equal(String(asarContent));
+    });
+
+    it('does not send files outside of the directory', async () => {
+      protocol.registerStaticProtocol(protocolName, { directory: path.join(fixturesPath, 'pages') });
+      await expect(ajax(protocolName + ':/%2e%2e/test.asar/a.asar/file1')).to.be.eventually.rejected();
+    });
+
+    it('calls the handler for misses only', async () => {
+      const requests: string[] = [];
+      protocol.registerStaticProtocol(protocolName, { responses: { '/a': { data: text } } }, (request, callback) => {
+        requests.push(request.url);
+        callback(Buffer.from('dynamic'));
+      });
+      expect((await ajax(protocolName + ':/a')).data).to.equal(text);
+      expect((await ajax(protocolName + ':/b')).data).to.equal('dynamic');
+      expect(requests).to.deep.equal([protocolName + ':/b']);
+    });
+
+    it('fails misses without a handler', async () => {
+      protocol.registerStaticProtocol(protocolName, { responses: { '/a': { data: text } } });
+      await expect(ajax(protocolName + ':/b')).to.be.eventually.rejected();
+    });
+
+    it('throws for header values that are not strings', () => {
+      expect(() => {
+        protocol.registerStaticProtocol(protocolName, { directory: fixturesPath, headers: { 'x-static': 1 as any } });
+      }).to.throw(TypeError);
+      expect(() => {
+        protocol.registerStaticProtocol(protocolName, { responses: { '/a': { data: text, headers: { 'x-a': [1] as any } } } });
+      }).to.throw(TypeError);
+    });
+
+    it('throws for an invalid cacheSize', () => {
+      expect(() => {
+        protocol.registerStaticProtocol(protocolName, { directory: fixturesPath, cacheSize: -1 });
+      }).to.throw(TypeError);
+      expect(() => {
+        protocol.registerStaticProtocol(protocolName, { directory: fixturesPath, cacheSize: 'big' as any });
+      }).to.throw(TypeError);
+    });
   });
 
   describe('protocol.registerFileProtocol', () => {
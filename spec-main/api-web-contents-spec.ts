@@ -1186,6 +1186,20 @@ describe('webContents module', () => {
       expect(zoomLevel1).to.not.equal(zoomLevel2);
     });
 
+    it('is reflected by webFrame without a round trip to the browser', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+      await w.loadURL('about:blank');
+      w.webContents.setZoomLevel(1.5);
+      expect(await w.webContents.executeJavaScript('require(\'electron\').webFrame.getZoomLevel()')).to.equal(1.5);
+      w.webContents.setZoomFactor(0.5);
+      expect(await w.webContents.executeJavaScript('require(\'electron\').webFrame.getZoomFactor()')).to.be.closeTo(0.5, 0.001);
+      expect(await w.webContents.executeJavaScript(`{
+        const { webFrame } = require('electron')
+        webFrame.setZoomLevel(-1)
+        webFrame.getZoomLevel()
+      }`)).to.equal(-1);
+    });
+
     describe('with unique domains', () => {
       let server: http.Server;
       let serverUrl: string;
@@ -1224,6 +1238,23 @@ describe('webContents module', () => {
         zoomLevel = w.webContents.zoomLevel;
         expect(zoomLevel).to.equal(0);
       });
+
+      it('updates the zoom level webFrame caches when navigating between hosts', async () => {
+        const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false, partition: 'zoom-level-per-host' } });
+        const getZoomLevel = () => w.webContents.executeJavaScript('require(\'electron\').webFrame.getZoomLevel()');
+        await w.loadURL(serverUrl);
+        w.webContents.zoomLevel = 1;
+        expect(await getZoomLevel()).to.equal(1);
+        await w.loadURL(crossSiteUrl);
+        w.webContents.zoomLevel = 2;
+        expect(await getZoomLevel()).to.equal(2);
+        // Each page reads the level of its host from the value the browser
+        // sent with the navigation, not the one of the previous page.
+        await w.loadURL(serverUrl);
+        expect(await getZoomLevel()).to.equal(1);
+        await w.loadURL(crossSiteUrl);
+        expect(await getZoomLevel()).to.equal(2);
+      });
     });
   });
 
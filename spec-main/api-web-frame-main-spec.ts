@@ -194,6 +194,90 @@ describe('webFrameMain module', () => {
     });
   });
 
+  describe('webFrameMain.broadcast', () => {
+    const createWindows = async (count: number) => {
+      const windows: BrowserWindow[] = [];
+      for (let i = 0; i < count; i++) {
+        const w = new BrowserWindow({
+          show: false,
+          webPreferences: { nodeIntegration: true, contextIsolation: false }
+        });
+        await w.loadURL('about:blank');
+        windows.push(w);
+      }
+      return windows;
+    };
+
+    const receive = (w: BrowserWindow) => w.webContents.executeJavaScript(`new Promise(resolve => {
+      require('electron').ipcRenderer.once('broadcast', (event, ...args) => resolve(args));
+    })`);
+
+    it('sends small payloads to every frame', async () => {
+      const windows = await createWindows(3);
+      const received = Promise.all(windows.map(receive));
+      webFrameMain.broadcast(windows.map(w => w.webContents.mainFrame), 'broadcast', 'hello', { a: 1 });
+      for (const args of await received) {
+        expect(args).to.deep.equal(['hello', { a: 1 }]);
+      }
+    });
+
+    it('sends large payloads to every frame', async () => {
+      const windows = await createWindows(3);
+      const payload = 'x'.repeat(1024 * 1024);
+      const received = Promise.all(windows.map(receive));
+      webFrameMain.broadcast(windows.map(w => w.webContents.mainFrame), 'broadcast', payload);
+      for (const args of await received) {
+        expect(args).to.deep.equal([payload]);
+      }
+    });
+
+    it('can target the frames of a session', async () => {
+      const windows = await createWindows(2);
+      const received = Promise.all(windows.map(receive));
+      webFrameMain.broadcast(windows[0].webContents.session, 'broadcast', 42);
+      for (const args of await received) {
+        expect(args).to.deep.equal([42]);
+      }
+    });
+
+    it('throws when the arguments can not be serialized', async () => {
+      const windows = await createWindows(1);
+      expect(() => {
+        webFrameMain.broadcast([windows[0].webContents.mainFrame], 'broadcast', () => {});
+      }).to.throw(/Failed to serialize arguments/);
+    });
+  });
+
+  describe('webFrameMain.connect', () => {
+    it('connects two frames with a message port', async () => {
+      const windows = await Promise.all([0, 1].map(async () => {
+        const w = new BrowserWindow({
+          show: false,
+          webPreferences: { nodeIntegration: true, contextIsolation: false }
+        });
+        await w.loadURL('about:blank');
+        return w;
+      }));
+      const received = windows.map((w, i) => w.webContents.executeJavaScript(`new Promise(resolve => {
+        require('electron').ipcRenderer.once('peer', (event) => {
+          const [port] = event.ports;
+          port.onmessage = ({ data }) => resolve(data);
+          port.postMessage('from ${i}');
+        });
+      })`));
+      const [frame1, frame2] = windows.map(w => w.webContents.mainFrame);
+      expect(webFrameMain.connect(frame1, frame2, 'peer')).to.be.true();
+      expect(await Promise.all(received)).to.deep.equal(['from 1', 'from 0']);
+    });
+
+    it('does not connect a frame to itself', async () => {
+      const w = new BrowserWindow({ show: false });
+      await w.loadURL('about:blank');
+      const frame = w.webContents.mainFrame;
+      expect(webFrameMain.connect(frame, frame, 'peer')).to.be.false();
+    });
+  });
+
   describe('RenderFrame lifespan', () => {
     let w: BrowserWindow;
 
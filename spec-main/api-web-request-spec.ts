@@ -61,6 +61,105 @@ describe('webRequest module', () => {
     return contents.executeJavaScript(`ajax("${url}", ${JSON.stringify(options)})`);
   }
 
+  describe('webRequest.setRules', () => {
+    afterEach(() => {
+      ses.webRequest.setRules(null);
+      ses.webRequest.onBeforeRequest(null);
+    });
+
+    it('can block requests', async () => {
+      ses.webRequest.setRules([{ urls: [defaultURL + 'blocked/*'], action: 'block' }]);
+      const { data } = await ajax(`${defaultURL}allowed`);
+      expect(data).to.equal('/allowed');
+      await expect(ajax(`${defaultURL}blocked/test`)).to.eventually.be.rejected();
+    });
+
+    it('can filter by resource type', async () => {
+      ses.webRequest.setRules([{ resourceTypes: ['image'], action: 'block' }]);
+      const { data } = await ajax(defaultURL);
+      expect(data).to.equal('/');
+    });
+
+    it('can filter by initiator', async () => {
+      ses.webRequest.setRules([{ initiators: ['https://example.com/*'], action: 'block' }]);
+      const { data } = await ajax(defaultURL);
+      expect(data).to.equal('/');
+    });
+
+    it('can redirect requests', async () => {
+      ses.webRequest.setRules([{
+        urls: [defaultURL + 'old'],
+        action: 'redirect',
+        redirectURL: defaultURL + 'new'
+      }]);
+      const { data } = await ajax(`${defaultURL}old`);
+      expect(data).to.equal('/new');
+    });
+
+    it('can modify request and response headers', async () => {
+      ses.webRequest.setRules([{
+        action: 'modifyHeaders',
+        setRequestHeaders: { Accept: '*/*;test/header' },
+        setResponseHeaders: { Custom: 'Changed' }
+      }]);
+      const { data, headers } = await ajax(defaultURL);
+      expect(data).to.equal('/header/received');
+      expect(headers).to.have.property('custom', 'Changed');
+    });
+
+    it('fails requests that rules redirect in a cycle', async () => {
+      ses.webRequest.setRules([
+        { urls: [defaultURL + 'a'], action: 'redirect', redirectURL: defaultURL + 'b' },
+        { urls: [defaultURL + 'b'], action: 'redirect', redirectURL: defaultURL + 'a' }
+      ]);
+      await expect(ajax(`${defaultURL}a`)).to.eventually.be.rejected();
+    });
+
+    it('applies header rules over the changes of listeners', async () => {
+      ses.webRequest.setRules([{
+        action: 'modifyHeaders',
+        setResponseHeaders: { Custom: 'Rule' }
+      }]);
+      ses.webRequest.onHeadersReceived((details, callback) => {
+        expect(details.responseHeaders!.Custom).to.deep.equal(['Rule']);
+        const responseHeaders = details.responseHeaders!;
+        responseHeaders.Custom = ['Listener'];
+        responseHeaders['X-Listener'] = ['yes'];
+        callback({ responseHeaders });
+      });
+      try {
+        const { headers } = await ajax(defaultURL);
+        expect(headers).to.have.property('custom', 'Rule');
+        expect(headers).to.have.property('x-listener', 'yes');
+      } finally {
+        ses.webRequest.onHeadersReceived(null);
+      }
+    });
+
+    it('does not call listeners for blocked requests', async () => {
+      let called = false;
+      ses.webRequest.setRules([{ action: 'block' }]);
+      ses.webRequest.onBeforeRequest((details, callback) => {
+        called = true;
+        callback({});
+      });
+      await expect(ajax(defaultURL)).to.eventually.be.rejected();
+      expect(called).to.be.false();
+    });
+
+    it('throws on invalid rules', () => {
+      expect(() => {
+        ses.webRequest.setRules([{ action: 'unknown' } as any]);
+      }).to.throw(/action/);
+      expect(() => {
+        ses.webRequest.setRules([{ urls: ['bad'], action: 'block' }]);
+      }).to.throw(/Invalid url pattern/);
+      expect(() => {
+        ses.webRequest.setRules([{ action: 'redirect' }]);
+      }).to.throw(/redirectURL/);
+    });
+  });
+
   describe('webRequest.onBeforeRequest', () => {
     afterEach(() => {
       ses.webRequest.onBeforeRequest(null);
@@ -313,6 +412,18 @@ describe('webRequest module', () => {
       expect(data).to.equal('/');
     });
 
+    it('can read details properties after the listener returns', async () => {
+      let details: Electron.OnHeadersReceivedListenerDetails | undefined;
+      ses.webRequest.onHeadersReceived((d, callback) => {
+        details = d;
+        callback({});
+      });
+      await ajax(defaultURL);
+      expect(details!.responseHeaders!.Custom).to.deep.equal(['Header']);
+      expect(details!.referrer).to.be.a('string');
+      expect(Object.keys(details!)).to.include('responseHeaders');
+    });
+
     it('can change the response header', async () => {
       ses.webRequest.onHeadersReceived((details, callback) => {
         const responseHeaders = details.responseHeaders!;
@@ -4,8 +4,8 @@ import * as fs from 'fs';
 import * as path from 'path';
 import * as util from 'util';
 import { emittedOnce } from './events-helpers';
-import { ifdescribe, ifit } from './spec-helpers';
-import { webContents, WebContents } from 'electron/main';
+import { ifdescribe, ifit, startRemoteControlApp } from './spec-helpers';
+import { BrowserWindow, webContents, WebContents } from 'electron/main';
 
 const features = process._linkedBinding('electron_common_features');
 const mainFixturesPath = path.resolve(__dirname, 'fixtures');
@@ -194,6 +194,35 @@ describe('node feature', () => {
     });
   });
 
+  describe('js2c code cache', () => {
+    it('is accepted when compiling the browser bundles', async () => {
+      // The spec runner itself sets --js-flags, which changes the V8 flag
+      // hash, so check a fresh app.
+      const { remotely } = await startRemoteControlApp();
+      const usage = await remotely(() => {
+        return (process as any)._linkedBinding('electron_common_v8_util').getCodeCacheUsageForTesting();
+      });
+      if (!usage.hasJs2cCodeCache) return;
+      expect(usage.compiledWithCache).to.include('electron/js2c/browser_init');
+      expect(usage.compiledWithoutCache).to.not.include('electron/js2c/browser_init');
+    });
+
+    it('is shared between the renderers of a site', async () => {
+      const getUsage = async () => {
+        const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+        await w.loadFile(path.join(mainFixturesPath, 'blank.html'));
+        const usage = await w.webContents.executeJavaScript('process._linkedBinding(\'electron_common_v8_util\').getCodeCacheUsageForTesting()');
+        w.destroy();
+        return usage;
+      };
+      // The first renderer compiles the bundle from source and hands the
+      // cache it created to the browser.
+      await getUsage();
+      const usage = await getUsage();
+      expect(usage.compiledWithCache).to.include('electron/js2c/renderer_init');
+    });
+  });
+
   describe('process.stdout', () => {
     it('is a real Node stream', () => {
       expect((process.stdout as any)._type).to.not.be.undefined();
@@ -1453,6 +1453,53 @@ describe('asar package', function () {
       });
     });
 
+    describe('internalModuleStat', function () {
+      const { internalModuleStat, internalModuleReadJSON } = process.binding('fs');
+      const asar = process._linkedBinding('electron_common_asar');
+      const { probeModulePath } = asar;
+      let probeCount;
+
+      beforeEach(function () {
+        probeCount = 0;
+        asar.probeModulePath = function (...args) {
+          probeCount++;
+          return probeModulePath.apply(this, args);
+        };
+      });
+
+      afterEach(function () {
+        asar.probeModulePath = probeModulePath;
+      });
+
+      it('resolves a path and its extensions in one probe', function () {
+        const file = path.join(asarDir, 'a.asar', 'ping');
+        expect(internalModuleStat(file)).to.be.below(0);
+        expect(internalModuleStat(file + '.js')).to.equal(0);
+        expect(internalModuleStat(path.join(asarDir, 'a.asar', 'dir1'))).to.equal(1);
+        expect(probeCount).to.equal(2);
+      });
+
+      it('hands the package.json of a directory to internalModuleReadJSON', function () {
+        const dir = path.join(fixtures, 'api', 'electron-main-module', 'app.asar', 'node_modules', 'some-module');
+        expect(internalModuleStat(dir)).to.equal(1);
+        const [s, c] = internalModuleReadJSON(path.join(dir, 'package.json'));
+        expect(JSON.parse(s)).to.be.an('object');
+        expect(c).to.be.true();
+        expect(probeCount).to.equal(1);
+      });
+
+      it('probes again after the current tick', async function () {
+        const file = path.join(asarDir, 'a.asar', 'file1');
+        expect(internalModuleStat(file)).to.equal(0);
+        expect(internalModuleStat(file)).to.equal(0);
+        expect(probeCount).to.equal(1);
+
+        await new Promise(resolve => setImmediate(resolve));
+        expect(internalModuleStat(file)).to.equal(0);
+        expect(probeCount).to.equal(2);
+      });
+    });
+
     describe('util.promisify', function () {
       it('can promisify all fs functions', function () {
         const originalFs = require('original-fs');
@@ -0,0 +1,6 @@
+globalThis.snapshotState = {
+  primes: [2, 3, 5, 7, 11, 13],
+  greet (name) {
+    return `Hello, ${name}`;
+  }
+};
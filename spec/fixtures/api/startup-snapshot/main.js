@@ -0,0 +1,8 @@
+const { app } = require('electron');
+
+const state = globalThis.snapshotState;
+console.log(JSON.stringify({
+  primes: state ? state.primes : null,
+  greeting: state ? state.greet('snapshot') : null
+}));
+app.exit(0);
@@ -0,0 +1 @@
+throw new Error('snapshot entry failed');
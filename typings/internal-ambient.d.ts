@@ -1,6 +1,6 @@
 /* eslint-disable no-var */
 declare var internalBinding: any;
-declare var binding: { get: (name: string) => any; process: NodeJS.Process; createPreloadScript: (src: string) => Function };
+declare var binding: { get: (name: string) => any; process: NodeJS.Process; createPreloadScript: (src: string, preloadPath: string) => Function; preloadInfo?: any };
 
 declare var isolatedApi: {
   guestViewInternal: any;
@@ -46,6 +46,11 @@ declare namespace NodeJS {
     requestGarbageCollectionForTesting(): void;
     runUntilIdle(): void;
     triggerFatalErrorForTesting(): void;
+    getCodeCacheUsageForTesting(): {
+      hasJs2cCodeCache: boolean;
+      compiledWithCache?: string[];
+      compiledWithoutCache?: string[];
+    };
   }
 
   interface EnvironmentBinding {
@@ -92,6 +97,7 @@ declare namespace NodeJS {
       filePath: string;
     };
     initAsarSupport(require: NodeJS.Require): void;
+    probeModulePath(path: string, extensions: string[], results: Int32Array, readPackageJSON: boolean): string | undefined;
   }
 
   interface PowerMonitorBinding extends Electron.PowerMonitor {
@@ -227,8 +233,18 @@ declare namespace NodeJS {
       createURLLoader(options: CreateURLLoaderOptions): URLLoader;
     };
     _linkedBinding(name: 'electron_browser_power_monitor'): PowerMonitorBinding;
+    _linkedBinding(name: 'electron_browser_module_code_cache'): {
+      isEnabled(): boolean;
+      get(filename: string, content: string): Buffer | undefined;
+      compiled(filename: string, content: string, fn: Function): void;
+      flush(): Promise<void>;
+      prune(): Promise<void>;
+    };
     _linkedBinding(name: 'electron_browser_power_save_blocker'): { powerSaveBlocker: Electron.PowerSaveBlocker };
     _linkedBinding(name: 'electron_browser_safe_storage'): { safeStorage: Electron.SafeStorage };
+    _linkedBinding(name: 'electron_browser_startup_snapshot'): {
+      build(source: string, filename: string): string;
+    };
     _linkedBinding(name: 'electron_browser_session'): typeof Electron.Session;
     _linkedBinding(name: 'electron_browser_system_preferences'): { systemPreferences: Electron.SystemPreferences };
     _linkedBinding(name: 'electron_browser_tray'): { Tray: Electron.Tray };
@@ -238,6 +254,8 @@ declare namespace NodeJS {
     _linkedBinding(name: 'electron_browser_web_frame_main'): {
       WebFrameMain: typeof Electron.WebFrameMain;
       fromId(processId: number, routingId: number): Electron.WebFrameMain;
+      _broadcast(frames: Electron.WebFrameMain[], internal: boolean, channel: string, args: any[]): void;
+      connect(frame1: Electron.WebFrameMain, frame2: Electron.WebFrameMain, channel: string): boolean;
     }
     _linkedBinding(name: 'electron_renderer_crash_reporter'): Electron.CrashReporter;
     _linkedBinding(name: 'electron_renderer_ipc'): { ipc: IpcRendererBinding };